@@ -0,0 +1,241 @@
+#pragma once
+
+#include <climits>
+#include <cstddef>
+#include <cstring>
+#include <string_view>
+
+// Chat line parsing for the hooks. Names are views into the line, and the
+// matchers walk the line in place, so parsing never touches the heap; copy
+// a name to keep it past the line.
+
+// What one chat line reports (GameChat::addMessage, ChatParser)
+struct ChatLineEvents {
+  bool loot{false}; // "You receive: [Item]" or "You receive: [Item] xN"
+  std::string_view lootName;
+  int lootAmount{1};
+  bool exp{false}; // "You gained X experience", "+X XP"
+  int expAmount{0};
+  bool kill{false}; // "You killed [Mob]", "[Mob] has been defeated"
+  std::string_view killName;
+  bool gold{false}; // "You received X Gold" (not the [Gold] loot form)
+  int goldAmount{0};
+};
+
+// What the addLine hook reads from one line (ParseChatLine in the DLL)
+struct AddLineEvents {
+  int expAmount{0}; // "You gained X experience", 0 if none
+  bool loot{false}; // "You receive: [Item]", optionally " xN" after it
+  std::string_view lootName; // At most ADDLINE_NAME_MAX chars
+  int lootAmount{1};
+  bool lootIsGold{false}; // The item's name contains "Gold" or "gold"
+  int goldSpent{0};       // "You spent X Gold", 0 if none
+};
+
+constexpr size_t ADDLINE_NAME_MAX = 63;
+
+namespace ChatMatch {
+
+inline bool isSpace(char c) {
+  return c == ' ' || (c >= '\t' && c <= '\r');
+}
+inline bool isDigit(char c) { return c >= '0' && c <= '9'; }
+inline bool isWord(char c) {
+  return isDigit(c) || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+         c == '_';
+}
+inline char lower(char c) { return c >= 'A' && c <= 'Z' ? c + 32 : c; }
+
+// Whether text starts with prefix (given in lower case), ignoring case
+inline bool startsWith(std::string_view text, std::string_view prefix) {
+  if (text.size() < prefix.size())
+    return false;
+  for (size_t i = 0; i < prefix.size(); i++)
+    if (lower(text[i]) != prefix[i])
+      return false;
+  return true;
+}
+
+inline std::string_view skipSpace(std::string_view s) {
+  size_t i = 0;
+  while (i < s.size() && isSpace(s[i]))
+    i++;
+  return s.substr(i);
+}
+
+// The digits s starts with ("" if none); s moves past them
+inline std::string_view takeDigits(std::string_view &s) {
+  size_t i = 0;
+  while (i < s.size() && isDigit(s[i]))
+    i++;
+  std::string_view digits = s.substr(0, i);
+  s.remove_prefix(i);
+  return digits;
+}
+
+// An absurd amount clamps rather than overflowing inside the hook
+inline int toInt(std::string_view digits) {
+  long long value = 0;
+  for (char c : digits) {
+    value = value * 10 + (c - '0');
+    if (value > INT_MAX)
+      return INT_MAX;
+  }
+  return (int)value;
+}
+
+// Like std::regex_search over "(?:p0|p1|...)rest": at each position from
+// the left, each prefix in order, the first whose rest() matches wins.
+// rest gets the text after the prefix and writes its captures only when it
+// matches.
+template <size_t N, typename Rest>
+bool search(std::string_view line, const std::string_view (&prefixes)[N],
+            Rest rest) {
+  for (size_t pos = 0; pos < line.size(); pos++) {
+    std::string_view at = line.substr(pos);
+    for (std::string_view prefix : prefixes)
+      if (startsWith(at, prefix) && rest(at.substr(prefix.size())))
+        return true;
+  }
+  return false;
+}
+
+} // namespace ChatMatch
+
+// Parses one chat line. Matches what these case-insensitive patterns
+// matched with std::regex_search, without its search state on the heap:
+//   loot  You receive:\s*\[([^\]]+)\](?:\s*x(\d+))?
+//   exp   (?:You (?:gained?|received?)|got|\+)\s*(\d+)\s*(?:experience|exp|xp)
+//   kill  (?:You (?:killed?|slain|defeated)|has been defeated)
+//         \s*(?:\[([^\]]+)\]|(\w+))
+//   gold  (?:You (?:received?|got|looted))\s*(\d+)\s*(?:Gold|gold|coins?)
+// An optional letter is tried with it first, as the regex's greedy "?" did.
+inline ChatLineEvents ParseChatEvents(const char *line) {
+  using namespace ChatMatch;
+  std::string_view text(line);
+  ChatLineEvents events;
+
+  // "[name]" at the start of s: the name, or "" if s doesn't start with one
+  auto bracketed = [](std::string_view s) {
+    if (s.empty() || s[0] != '[')
+      return std::string_view();
+    size_t close = s.find(']', 1);
+    return close == std::string_view::npos ? std::string_view()
+                                           : s.substr(1, close - 1);
+  };
+
+  // Also matches "You receive: [Gold] x5"
+  static const std::string_view LOOT[] = {"you receive:"};
+  search(text, LOOT, [&](std::string_view s) {
+    s = skipSpace(s);
+    std::string_view name = bracketed(s);
+    if (name.empty())
+      return false;
+    events.loot = true;
+    events.lootName = name;
+    s = skipSpace(s.substr(name.size() + 2));
+    if (!s.empty() && lower(s[0]) == 'x') {
+      s.remove_prefix(1);
+      std::string_view digits = takeDigits(s);
+      if (!digits.empty())
+        events.lootAmount = toInt(digits);
+    }
+    return true;
+  });
+
+  static const std::string_view EXP[] = {
+      "you gained", "you gaine", "you received", "you receive", "got", "+"};
+  search(text, EXP, [&](std::string_view s) {
+    s = skipSpace(s);
+    std::string_view digits = takeDigits(s);
+    s = skipSpace(s);
+    if (digits.empty() || !(startsWith(s, "exp") || startsWith(s, "xp")))
+      return false;
+    events.exp = true;
+    events.expAmount = toInt(digits);
+    return true;
+  });
+
+  static const std::string_view KILL[] = {"you killed", "you kille",
+                                          "you slain", "you defeated",
+                                          "has been defeated"};
+  search(text, KILL, [&](std::string_view s) {
+    s = skipSpace(s);
+    std::string_view name = bracketed(s);
+    if (name.empty()) {
+      size_t length = 0;
+      while (length < s.size() && isWord(s[length]))
+        length++;
+      name = s.substr(0, length);
+    }
+    if (name.empty())
+      return false;
+    events.kill = true;
+    events.killName = name;
+    return true;
+  });
+
+  static const std::string_view GOLD[] = {"you received", "you receive",
+                                          "you got", "you looted"};
+  search(text, GOLD, [&](std::string_view s) {
+    s = skipSpace(s);
+    std::string_view digits = takeDigits(s);
+    s = skipSpace(s);
+    if (digits.empty() || !(startsWith(s, "gold") || startsWith(s, "coin")))
+      return false;
+    events.gold = true;
+    events.goldAmount = toInt(digits);
+    return true;
+  });
+  return events;
+}
+
+// Parses one line for the addLine hook: exp, loot (gold or an item) and
+// gold spent, each found with a plain substring search
+inline AddLineEvents ParseAddLine(const char *line) {
+  using namespace ChatMatch;
+  AddLineEvents events;
+
+  // "You gained %d experience": the first number after "You gained"
+  const char *gained = strstr(line, "You gained");
+  if (gained && strstr(line, "experience")) {
+    std::string_view rest(gained + 10);
+    while (!rest.empty() && !isDigit(rest[0]))
+      rest.remove_prefix(1);
+    events.expAmount = toInt(takeDigits(rest));
+  }
+
+  // "You receive: [ItemName]", with " xN" anywhere after the name
+  const char *receive = strstr(line, "receive: [");
+  if (receive) {
+    const char *nameStart = receive + 9; // The '['
+    const char *nameEnd = strchr(nameStart + 1, ']');
+    if (nameEnd) {
+      size_t length = (size_t)(nameEnd - nameStart - 1);
+      events.loot = true;
+      events.lootName = std::string_view(
+          nameStart + 1, length < ADDLINE_NAME_MAX ? length : ADDLINE_NAME_MAX);
+      if (const char *times = strstr(nameEnd, " x")) {
+        std::string_view rest = skipSpace(times + 2);
+        bool negative = !rest.empty() && rest[0] == '-';
+        if (!rest.empty() && (rest[0] == '-' || rest[0] == '+'))
+          rest.remove_prefix(1);
+        int amount = toInt(takeDigits(rest));
+        events.lootAmount = negative || amount < 1 ? 1 : amount;
+      }
+      events.lootIsGold =
+          events.lootName.find("Gold") != std::string_view::npos ||
+          events.lootName.find("gold") != std::string_view::npos;
+    }
+  }
+
+  // "You spent X Gold"
+  const char *spent = strstr(line, "You spent ");
+  if (spent && strstr(spent, " Gold")) {
+    std::string_view rest = skipSpace(spent + 10);
+    if (!rest.empty() && rest[0] == '+')
+      rest.remove_prefix(1);
+    events.goldSpent = toInt(takeDigits(rest));
+  }
+  return events;
+}
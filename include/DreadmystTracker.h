@@ -1,82 +1,28 @@
 #pragma once
 
 #include <Windows.h>
+#include <array>
+#include <atomic>
 #include <cstdint>
 #include <functional>
 #include <map>
 #include <memory>
+#include <memory_resource>
+#include <mutex>
 #include <string>
+#include <string_view>
 #include <thread>
 #include <vector>
 
-// Shared memory name for IPC between DLL and GUI
-#define TRACKER_SHARED_MEMORY_NAME "DreadmystTrackerSharedMemory"
-#define TRACKER_MUTEX_NAME "DreadmystTrackerMutex"
-
-// Structure shared between DLL and external GUI
-struct SharedTrackerData {
-  // Magic number to verify valid data (0 until DLL initializes it)
-  uint32_t magic{0};
-
-  // Player stats
-  int totalKills{0};
-  int totalLootItems{0};
-  int64_t totalGold{0};
-  int totalExp{0};
-  int64_t goldSpent{0};   // Repair costs, purchases, etc.
-  int64_t totalDamage{0}; // Total damage dealt (for DPS)
-
-  // Party stats
-  int partyKills{0};
-  int partyLootItems{0};
-  int64_t partyGold{0};
-  int partyExp{0};
-
-  // Loot by quality (indices 0-5 for QualityLv0-QualityLv5)
-  int lootByQuality[6]{0, 0, 0, 0, 0, 0};
-
-  // Last 10 loot entries (circular buffer)
-  struct RecentLoot {
-    char itemName[64]{};
-    uint8_t quality{0};
-    int amount{0};
-    int64_t timestamp{0};
-  } recentLoot[10]{};
-  int recentLootIndex{0};
-
-  // Last 10 kill entries (circular buffer)
-  struct RecentKill {
-    char mobName[64]{};
-    int expGained{0};
-    int64_t timestamp{0};
-  } recentKills[10]{};
-  int recentKillIndex{0};
-
-  // Overlay visible flag (can be toggled from GUI)
-  bool overlayVisible{false};
-
-  // Session start time
-  int64_t sessionStartTime{0};
-
-  // Combat DPS tracking
-  int64_t combatStartTime{0}; // When current combat started (ms since epoch)
-  int64_t combatDamage{0};    // Damage dealt in current combat
-  int64_t lastDamageTime{0};  // When last damage was dealt (for timeout)
-  double lastCombatDPS{0.0};  // DPS from last completed combat
-  bool inCombat{false};       // Currently in combat
-
-  // Debug text for displaying probed buffer values
-  char debugText[512]{};
-
-  // Chat filter settings (set by GUI, read by DLL)
-  bool chatFilterEnabled{false};
-  char chatFilterTerms[512]{};  // Comma-separated filter terms
-  bool blockLinkedItems{false}; // Block messages containing item links
-  bool useRegexFilter{false}; // Use regex matching instead of simple substring
-
-  // Anti-AFK settings
-  bool antiAfkEnabled{false}; // Periodically send input to prevent AFK kick
-};
+#include "HookArena.h"
+#include "HookRegistry.h"
+#include "ItemDatabase.h"
+#include "LevelProjection.h"
+#include "NameCache.h"
+#include "SharedTrackerData.h"
+#include "ShardedCounters.h"
+#include "StartupPoll.h"
+#include "UpdateNotifier.h"
 
 namespace DreadmystTracker {
 
@@ -123,7 +69,12 @@ struct CombatStats {
   int totalExp{0};
   int64_t goldSpent{0};   // Repair costs, purchases
   int64_t totalDamage{0}; // Total damage dealt
-  std::map<ItemQuality, int> lootByQuality;
+  std::array<int, 6> lootByQuality{}; // Indexed by ItemQuality
+  int64_t itemValue{0}; // Vendor value of looted items
+  std::array<int64_t, 6> valueByQuality{};
+
+  // Everything earned, less what repairs and purchases cost
+  int64_t netGold() const { return totalGold + itemValue - goldSpent; }
 
   void reset() {
     totalKills = 0;
@@ -132,26 +83,70 @@ struct CombatStats {
     totalExp = 0;
     goldSpent = 0;
     totalDamage = 0;
-    lootByQuality.clear();
+    lootByQuality.fill(0);
+    itemValue = 0;
+    valueByQuality.fill(0);
   }
 };
 
+// Immutable copy of the stats, rebuilt at most once per publish interval and
+// shared by the overlay and the shared-memory publisher. Readers take a
+// reference with one atomic load and never see a half-updated copy.
+struct StatsSnapshot {
+  CombatStats player;
+  CombatStats party;
+  uint64_t version{0};   // Increments with every rebuild
+  uint64_t builtTick{0}; // GetTickCount64 when built
+};
+
+// Hooks build these with HookArena::resource() so their strings cost no
+// heap allocation; copies kept past the event use the default resource.
 struct LootEntry {
+  LootEntry() = default;
+  explicit LootEntry(std::pmr::memory_resource *mr)
+      : itemName(mr), looterName(mr) {}
+
   ItemDefinition item;
-  std::string itemName;
-  ItemQuality quality;
+  std::pmr::string itemName;
+  ItemQuality quality{ItemQuality::QualityLv0};
   int amount{1};
-  std::string looterName;
+  std::pmr::string looterName;
   int64_t timestamp{0};
 };
 
 struct KillEntry {
-  std::string mobName;
+  KillEntry() = default;
+  explicit KillEntry(std::pmr::memory_resource *mr) : mobName(mr) {}
+
+  std::pmr::string mobName;
   int64_t timestamp{0};
   int expGained{0};
   bool isPartyKill{false};
 };
 
+// The last N entries in fixed slots. A push overwrites the oldest slot in
+// place, so string members reuse their capacity instead of reallocating.
+template <typename Entry, size_t N> class RecentHistory {
+public:
+  void push(const Entry &entry) {
+    m_slots[m_total % N] = entry;
+    m_total++;
+  }
+  void clear() { m_total = 0; }
+
+  size_t size() const { return m_total < N ? (size_t)m_total : N; }
+  uint64_t total() const { return m_total; } // Pushed since the last clear
+
+  // i = 0 is the oldest entry still held
+  const Entry &operator[](size_t i) const {
+    return m_slots[(m_total - size() + i) % N];
+  }
+
+private:
+  std::array<Entry, N> m_slots{};
+  uint64_t m_total{0};
+};
+
 //=============================================================================
 // GameBridge - Direct access to game objects
 // Since we're injected, we can just call game functions directly!
@@ -160,8 +155,15 @@ class GameBridge {
 public:
   static GameBridge &getInstance();
 
-  // Find game objects (called once after injection)
-  bool initialize();
+  // Startup readiness checks, polled until they pass
+  bool isModuleMapped();
+  bool resolveSignatures(); // Scans for whichever patterns haven't matched
+  bool singletonsReady();   // sApplication and sContentMgr constructed
+
+  // Drops the cached names and reloads the exp table if the game rebuilt
+  // ContentMgr. Called once per tick, so only the tick thread reads the
+  // pointer or invalidates.
+  void checkContentReload();
 
   // Direct access to game state
   World *getWorld();
@@ -183,17 +185,37 @@ public:
   int getPlayerExp();
   int getPlayerGold();
 
+  // Total exp to reach each level, from ContentMgr's exp_table
+  const LevelExpTable &levelTable() const { return m_levelTable; }
+
   // Get target info from World::selectedUnit
   std::string getTargetName();
   int getTargetHealth();
   int getTargetMaxHealth();
   bool isTargetHostile();
 
-  // Access game's item database directly via ContentMgr
-  std::string getItemName(uint16_t itemId);
+  // Map the offline item table (ItemDbBuilder) that sits next to the DLL.
+  // Without it the item queries below fall back to placeholders.
+  bool loadItemDatabase();
+  void unloadItemDatabase();
+  uint32_t itemDatabaseCount() const { return m_itemDb.count(); }
+
+  // Access game's item database directly via ContentMgr. Names are interned
+  // and stay valid while the DLL is loaded, except past the intern table's
+  // 65535 names (see NameCache::get); copy a name to keep it.
+  // Both return `fallback` when neither the item table nor ContentMgr has a
+  // name.
+  const char *getItemName(uint16_t itemId,
+                          const char *fallback = "Unknown Item");
   std::string getItemIcon(uint16_t itemId);
   ItemQuality getItemQuality(uint16_t itemId);
-  std::string getNpcName(int entry);
+  uint32_t getItemValue(uint16_t itemId); // Vendor price, 0 if unknown
+  const ItemDbRecord *findItemByName(const char *name, size_t length) const;
+  const char *getNpcName(int entry, const char *fallback = "Unknown");
+
+  // Name cache hit/miss totals (NameCacheId) for the Debug tab
+  int64_t nameCacheHits(NameCacheId cache) const;
+  int64_t nameCacheMisses(NameCacheId cache) const;
 
   // Access the tooltip system - we can reuse the game's tooltip rendering!
   void showGameTooltip(const ItemDefinition &item, int x, int y);
@@ -202,12 +224,33 @@ public:
   ItemDefinition *getHoveredItem();
 
 private:
-  GameBridge() = default;
+  GameBridge();
+
+  // The instructions that load sApplication and sContentMgr, each scanned
+  // for only until it first matches
+  GlobalSignature m_applicationSig;
+  GlobalSignature m_contentMgrSig;
 
   // Cached pointers to game singletons
   void *m_application{nullptr}; // sApplication
   void *m_contentMgr{nullptr};  // sContentMgr
   void *m_connector{nullptr};   // sConnector
+
+  // The string-keyed ContentMgr lookup the name caches sit in front of
+  std::string queryContentName(const char *table, int key);
+  uint32_t queryLevelExp(int level); // exp_table's exp column, 0 if unknown
+  LevelExpTable m_levelTable;
+
+  // Cached names, invalidated whenever the game's ContentMgr changes
+  NameCache<10> m_npcNames;
+  NameCache<10> m_itemNames;
+  void *m_cachedContentMgr{nullptr}; // Tick thread only
+
+  // Mapped DreadmystItems.bin
+  ItemDatabase m_itemDb;
+  HANDLE m_itemDbFile{INVALID_HANDLE_VALUE};
+  HANDLE m_itemDbMapping{nullptr};
+  const void *m_itemDbView{nullptr};
 };
 
 //=============================================================================
@@ -220,14 +263,20 @@ public:
   bool install();
   void uninstall();
 
+  // Runtime switch for one installed hook, applied as a queued batch
+  bool setHookEnabled(HookId hook, bool enabled);
+  bool isHookInstalled(HookId hook) const { return m_hooks.installed(hook); }
+  bool isHookEnabled(HookId hook) const { return m_hooks.enabled(hook); }
+  int64_t installMicros() const { return m_installUs; }
+
   // Callbacks
-  std::function<void(const std::string &mobName, int exp)> onMobKilled;
+  std::function<void(std::string_view mobName, int exp)> onMobKilled;
   std::function<void(const LootEntry &)> onLootReceived;
   std::function<void(int amount)> onExpGained;
   std::function<void(int amount)> onGoldChanged;
 
 private:
-  EventHooks() = default;
+  EventHooks();
 
   // We hook these game functions:
   // - Game::processPacket_Server_ExpNotify - exp gains
@@ -252,7 +301,8 @@ private:
   static void __fastcall HookNotifyItemAdd(void *game, void *edx, void *data);
   static void __fastcall HookUnitDied(void *unit, void *edx);
 
-  bool m_installed{false};
+  HookRegistry<HOOK_COUNT> m_hooks; // Indexed by HookId
+  int64_t m_installUs{0};
 };
 
 //=============================================================================
@@ -276,8 +326,7 @@ public:
   void setPosition(int x, int y);
   void setOpacity(float opacity);
 
-  // Update data to display
-  void updateStats(const CombatStats &player, const CombatStats &party);
+  // Update data to display (stats come from Tracker::getStatsSnapshot)
   void addLootEntry(const LootEntry &entry);
   void addKillEntry(const KillEntry &entry);
 
@@ -302,10 +351,8 @@ private:
   int m_posY{10};
   float m_opacity{0.85f};
 
-  CombatStats m_playerStats;
-  CombatStats m_partyStats;
-  std::vector<LootEntry> m_lootHistory;
-  std::vector<KillEntry> m_killHistory;
+  RecentHistory<LootEntry, 50> m_lootHistory;
+  RecentHistory<KillEntry, 50> m_killHistory;
 
   // Hook into World::render or Game::render
   static void *s_origWorldRender;
@@ -322,9 +369,14 @@ public:
   bool initialize();
   void shutdown();
 
-  // Stats access
-  const CombatStats &getPlayerStats() const { return m_playerStats; }
-  const CombatStats &getPartyStats() const { return m_partyStats; }
+  // Stats access (merged from the counter shards)
+  CombatStats getPlayerStats() const;
+  CombatStats getPartyStats() const;
+
+  // Latest published copy of the stats (null before the first publish)
+  std::shared_ptr<const StatsSnapshot> getStatsSnapshot() const {
+    return std::atomic_load(&m_statsSnapshot);
+  }
 
   // Reset
   void resetStats();
@@ -333,27 +385,51 @@ public:
   void toggleOverlay();
   bool isOverlayVisible() const { return m_overlayVisible; }
 
+  // Queue a parameterless command for the next tick (false if not running)
+  bool queueCommand(uint32_t type);
+
   // Hook callbacks
   void notifyExpGained(int amount);
-  void notifyMobKilled(const std::string &name, int exp);
+  void notifyMobKilled(std::string_view name, int exp);
   void notifyLootReceived(const LootEntry &loot);
   void notifyGoldChanged(int amount);
   void notifyGoldSpent(int amount);
-  void notifyDamageDealt(int amount);
+  void notifyDamageDealt(int amount, int targetGuid = 0, int spellId = 0);
+  void notifyHealingDone(int amount, int spellId = 0);
 
 private:
   Tracker() = default;
 
   // Event handlers (called by hooks)
-  void onMobKilled(const std::string &name, int exp);
+  void onMobKilled(std::string_view name, int exp);
   void onLootReceived(const LootEntry &loot);
   void onExpGained(int amount);
 
-  CombatStats m_playerStats;
-  CombatStats m_partyStats;
-
-  std::vector<LootEntry> m_lootHistory;
-  std::vector<KillEntry> m_killHistory;
+  // Hooks on the game's network and main threads (and the init thread) all
+  // count events; each thread adds to its own shard
+  enum StatCounter {
+    STAT_KILLS,
+    STAT_LOOT_ITEMS,
+    STAT_GOLD,
+    STAT_EXP,
+    STAT_GOLD_SPENT,
+    STAT_DAMAGE,
+    STAT_LOOT_QUALITY, // One per ItemQuality
+    STAT_ITEM_VALUE = STAT_LOOT_QUALITY + 6,
+    STAT_VALUE_QUALITY, // One per ItemQuality
+    STAT_PARTY_KILLS = STAT_VALUE_QUALITY + 6,
+    STAT_COUNT
+  };
+  ShardedCounters<STAT_COUNT> m_counters;
+
+  // Merged counters; m_statsDirty marks changes since the last snapshot
+  std::shared_ptr<const StatsSnapshot> m_statsSnapshot;
+  std::atomic<bool> m_statsDirty{true};
+
+  // Only the entries shared memory shows are kept
+  std::mutex m_historyLock; // Also orders the overlay's copies
+  RecentHistory<LootEntry, 10> m_lootHistory;
+  RecentHistory<KillEntry, 10> m_killHistory;
 
   bool m_initialized{false};
   bool m_overlayVisible{true};
@@ -361,11 +437,47 @@ private:
   // Shared memory for external GUI
   HANDLE m_sharedMemHandle{nullptr};
   HANDLE m_mutexHandle{nullptr};
+  UpdateNotifier m_updateNotifier; // Signaled when a publish changed the data
   SharedTrackerData *m_sharedData{nullptr};
-
-  // Test data thread (for GUI verification)
-  std::thread m_testThread;
-
+  uint64_t m_publishedHash{0}; // PublishedContentHash at the last bump
+
+  // Periodic tick (combat timeout, DPS window decay, publishing)
+  static constexpr DWORD TICK_INTERVAL_MS = 250;
+  static constexpr DWORD MIN_TICK_INTERVAL_MS = 50;
+  static constexpr DWORD MAX_TICK_INTERVAL_MS = 1000;
+  DWORD m_tickIntervalMs{TICK_INTERVAL_MS}; // Changed by CMD_SET_REFRESH_RATE
+  HANDLE m_tickTimer{nullptr};
+  std::atomic_flag m_ticking = ATOMIC_FLAG_INIT;
+
+  // Monotonic session clock, restarted by resetStats
+  uint64_t m_sessionStartTick{0};
+
+  // Finished sessions are archived here, next to the DLL; the running one is
+  // checkpointed there from the tick this often
+  static constexpr const char *SESSION_ARCHIVE_DIR = "Sessions";
+  static constexpr uint64_t SESSION_CHECKPOINT_MS = 5 * 60 * 1000;
+  uint64_t m_lastCheckpointTick{0};
+
+  // Startup timeline, ms since initialize() began (see InitStage)
+  static constexpr uint64_t READY_TIMEOUT_MS = 10000;
+  uint64_t m_attachTick{0};
+  int32_t m_initStageMs[INIT_STAGES]{};
+  std::atomic<bool> m_stopInit{false}; // Set by shutdown mid-startup
+
+  // Reference point for converting hook timings (TSC) to microseconds
+  int64_t m_tscCalibrationQpc{0};
+  uint64_t m_tscCalibrationTsc{0};
+
+  void installHooks();
+  void markInitStage(InitStage stage, bool reached = true);
+  void tick();
+  void processCommands();
+  void applyCommand(const TrackerCommand &cmd);
+  void startSessionClock();
+  void archiveSession();    // Write the session's event log to disk
+  void checkpointSession(); // Write it so far, without ending the session
+  void refreshStatsSnapshot(uint64_t nowTick, bool force);
+  void publishEvent(); // updateSharedMemory unless deferred to the tick
   void updateSharedMemory();
   bool initSharedMemory();
   void cleanupSharedMemory();
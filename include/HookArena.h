@@ -0,0 +1,74 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+// Upstream for arena events that outgrow their buffer; counts how often
+class HookArenaSpill : public std::pmr::memory_resource {
+public:
+  std::atomic<uint32_t> count{0};
+
+private:
+  void *do_allocate(size_t bytes, size_t align) override {
+    count.fetch_add(1, std::memory_order_relaxed);
+    return std::pmr::new_delete_resource()->allocate(bytes, align);
+  }
+  void do_deallocate(void *p, size_t bytes, size_t align) override {
+    std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+  }
+  bool do_is_equal(const memory_resource &other) const noexcept override {
+    return this == &other;
+  }
+};
+
+// Bump allocator for the short-lived strings built while one hook event is
+// handled. Each thread owns a fixed buffer; allocating just advances a
+// pointer, and the outermost HookArenaScope on the thread rewinds it when the
+// event is done, so a warm hook path never touches the heap. Anything that
+// outlives the event has to be copied into storage of its own.
+class HookArena {
+public:
+  // Allocator source for the current thread's event
+  static std::pmr::memory_resource *resource() { return &local().m_arena; }
+
+  // Allocations that overflowed a buffer and went to the heap, all threads
+  static uint32_t heapAllocations() {
+    return s_spill.count.load(std::memory_order_relaxed);
+  }
+
+private:
+  friend class HookArenaScope;
+
+  static constexpr size_t BUFFER_SIZE = 16 * 1024;
+
+  HookArena() : m_arena(m_buffer, sizeof(m_buffer), &s_spill) {}
+
+  static HookArena &local() {
+    thread_local HookArena arena;
+    return arena;
+  }
+
+  static inline HookArenaSpill s_spill;
+
+  alignas(std::max_align_t) unsigned char m_buffer[BUFFER_SIZE];
+  std::pmr::monotonic_buffer_resource m_arena;
+  int m_depth{0}; // Nested scopes (a hook can fire inside another)
+};
+
+// Marks one event batch on this thread: the arena is rewound when the
+// outermost scope ends. Arena memory used outside any scope is only
+// reclaimed at the end of the thread's next scope.
+class HookArenaScope {
+public:
+  HookArenaScope() { HookArena::local().m_depth++; }
+  ~HookArenaScope() {
+    HookArena &arena = HookArena::local();
+    if (--arena.m_depth == 0)
+      arena.m_arena.release();
+  }
+
+  HookArenaScope(const HookArenaScope &) = delete;
+  HookArenaScope &operator=(const HookArenaScope &) = delete;
+};
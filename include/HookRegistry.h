@@ -0,0 +1,218 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Byte patterns like "55 8B EC ?? 56": two hex digits per byte, ?? (or ?)
+// for a wildcard. Parsed on the fly, so a pattern is just its string.
+static constexpr int MAX_PATTERN_BYTES = 64;
+
+// Parsed pattern bytes; returns the count, 0 if malformed or too long
+inline int ParsePattern(const char *pattern,
+                        uint8_t (&bytes)[MAX_PATTERN_BYTES],
+                        bool (&wild)[MAX_PATTERN_BYTES]) {
+  auto nibble = [](char c) -> int {
+    if (c >= '0' && c <= '9')
+      return c - '0';
+    if (c >= 'a' && c <= 'f')
+      return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+      return c - 'A' + 10;
+    return -1;
+  };
+
+  int count = 0;
+  for (const char *p = pattern; *p;) {
+    if (*p == ' ') {
+      p++;
+      continue;
+    }
+    if (count == MAX_PATTERN_BYTES)
+      return 0;
+    if (*p == '?') {
+      wild[count] = true;
+      bytes[count++] = 0;
+      while (*p == '?')
+        p++;
+      continue;
+    }
+    int high = nibble(p[0]);
+    int low = high < 0 ? -1 : nibble(p[1]);
+    if (low < 0)
+      return 0;
+    wild[count] = false;
+    bytes[count++] = (uint8_t)(high << 4 | low);
+    p += 2;
+  }
+  return count;
+}
+
+// Whether `pattern` matches the bytes at `at`, which has `available` bytes
+inline bool MatchPattern(const uint8_t *at, size_t available,
+                         const char *pattern) {
+  uint8_t bytes[MAX_PATTERN_BYTES];
+  bool wild[MAX_PATTERN_BYTES];
+  int count = ParsePattern(pattern, bytes, wild);
+  if (count == 0 || (size_t)count > available)
+    return false;
+  for (int i = 0; i < count; i++)
+    if (!wild[i] && at[i] != bytes[i])
+      return false;
+  return true;
+}
+
+// First match of `pattern` in [base, base + size), or nullptr
+inline const uint8_t *FindPattern(const uint8_t *base, size_t size,
+                                  const char *pattern) {
+  uint8_t bytes[MAX_PATTERN_BYTES];
+  bool wild[MAX_PATTERN_BYTES];
+  int count = ParsePattern(pattern, bytes, wild);
+  if (count == 0 || (size_t)count > size)
+    return nullptr;
+  for (size_t i = 0; i + count <= size; i++) {
+    bool match = true;
+    for (int j = 0; j < count; j++) {
+      if (!wild[j] && base[i + j] != bytes[j]) {
+        match = false;
+        break;
+      }
+    }
+    if (match)
+      return base + i;
+  }
+  return nullptr;
+}
+
+// What actually patches code. The DLL's backend is MinHook; tests use a
+// fake that records calls. Enables and disables are queued and applied in
+// one batch, so the game's threads are suspended once rather than per hook.
+class HookBackend {
+public:
+  virtual ~HookBackend() = default;
+  virtual bool initialize() = 0;
+  virtual bool create(void *target, void *detour, void **original) = 0;
+  virtual bool queue(void *target, bool enable) = 0;
+  virtual bool applyQueued() = 0;
+  virtual void removeAll() = 0; // Disable and remove every hook, then close
+};
+
+// One detour. The VA is from the image as linked; the signature, when there
+// is one, has to match at the rebased VA, and is scanned for across the
+// image when it doesn't (a patched game moves functions around).
+struct HookSpec {
+  const char *name;
+  uint32_t va;           // At preferredBase below; 0 = scan only
+  const char *signature; // Check for the VA, fallback scan; may be null
+  void *detour;
+  void **trampoline; // Receives the original function
+  bool enabled;      // State after install
+};
+
+// The game image as mapped now
+struct HookImage {
+  const uint8_t *base;
+  size_t size;
+  uint32_t preferredBase; // The base the VAs assume, 0x00400000
+};
+
+// How a hook's target was found
+enum HookSource : uint8_t {
+  HOOK_SOURCE_NONE = 0, // Not found, or the backend refused it
+  HOOK_SOURCE_VA,
+  HOOK_SOURCE_SIGNATURE
+};
+
+// Every detour we install, indexed like the spec table, with its current
+// state. Not thread-safe: install, setEnabled and uninstall run on one
+// thread at a time (startup, then the tick, then shutdown).
+template <int COUNT> class HookRegistry {
+public:
+  explicit HookRegistry(HookBackend &backend) : m_backend(backend) {}
+
+  // Creates every hook that resolves, then queues the enabled ones and
+  // applies them as one batch. False only if the backend can't start.
+  bool install(const HookSpec (&specs)[COUNT], const HookImage &image) {
+    if (m_installed)
+      return true;
+    if (!m_backend.initialize())
+      return false;
+
+    for (int i = 0; i < COUNT; i++) {
+      const HookSpec &spec = specs[i];
+      HookSource source;
+      void *target = Resolve(spec, image, source);
+      if (!target || !m_backend.create(target, spec.detour, spec.trampoline))
+        continue;
+      m_targets[i] = target;
+      m_sources[i] = source;
+      if (spec.enabled && m_backend.queue(target, true))
+        m_enabled[i] = true;
+    }
+    if (!m_backend.applyQueued()) {
+      for (int i = 0; i < COUNT; i++)
+        m_enabled[i] = false;
+    }
+    m_installed = true;
+    return true;
+  }
+
+  // Runtime switch for one installed hook, applied as a queued batch
+  bool setEnabled(int hook, bool enabled) {
+    if (hook < 0 || hook >= COUNT || !m_targets[hook])
+      return false;
+    if (m_enabled[hook] == enabled)
+      return true;
+    if (!m_backend.queue(m_targets[hook], enabled) || !m_backend.applyQueued())
+      return false;
+    m_enabled[hook] = enabled;
+    return true;
+  }
+
+  void uninstall() {
+    if (!m_installed)
+      return;
+    m_backend.removeAll();
+    for (int i = 0; i < COUNT; i++) {
+      m_targets[i] = nullptr;
+      m_enabled[i] = false;
+      m_sources[i] = HOOK_SOURCE_NONE;
+    }
+    m_installed = false;
+  }
+
+  bool installed(int hook) const { return m_targets[hook] != nullptr; }
+  bool enabled(int hook) const { return m_enabled[hook]; }
+  HookSource source(int hook) const { return m_sources[hook]; }
+
+  // The VA rebased onto the image if it lies inside it and its signature
+  // (if any) matches there, else the signature's first match in the image
+  static void *Resolve(const HookSpec &spec, const HookImage &image,
+                       HookSource &source) {
+    source = HOOK_SOURCE_NONE;
+    if (spec.va >= image.preferredBase &&
+        spec.va - image.preferredBase < image.size) {
+      size_t offset = spec.va - image.preferredBase;
+      const uint8_t *at = image.base + offset;
+      if (!spec.signature ||
+          MatchPattern(at, image.size - offset, spec.signature)) {
+        source = HOOK_SOURCE_VA;
+        return (void *)at;
+      }
+    }
+    if (spec.signature) {
+      if (const uint8_t *found =
+              FindPattern(image.base, image.size, spec.signature)) {
+        source = HOOK_SOURCE_SIGNATURE;
+        return (void *)found;
+      }
+    }
+    return nullptr;
+  }
+
+private:
+  HookBackend &m_backend;
+  bool m_installed{false};
+  void *m_targets[COUNT]{}; // Resolved target, null if not hooked
+  bool m_enabled[COUNT]{};
+  HookSource m_sources[COUNT]{};
+};
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Compact item table built offline by ItemDbBuilder and memory-mapped by the
+// DLL. Lookups read straight out of the mapped file: nothing is parsed or
+// allocated at load, so attaching costs a handful of bounds checks.
+//
+// Layout (little-endian, every section 4-byte aligned):
+//   ItemDbHeader
+//   int32_t      displacement[count]  minimal perfect hash, see findById
+//   ItemDbRecord records[count]       in hash slot order
+//   ItemDbName   names[count]         sorted by (hash, slot)
+//   char         strings[stringsSize] NUL-terminated item names
+
+constexpr uint32_t ITEM_DB_MAGIC = 0x44494D44; // "DMID"
+constexpr uint32_t ITEM_DB_VERSION = 1;
+constexpr const char *ITEM_DB_FILE_NAME = "DreadmystItems.bin";
+
+struct ItemDbHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t count;    // Items; also the displacement and name index lengths
+  uint32_t hashSeed; // Seed of the first-level (bucket) hash
+  uint32_t displacementOffset;
+  uint32_t recordsOffset;
+  uint32_t namesOffset;
+  uint32_t stringsOffset;
+  uint32_t stringsSize;
+};
+
+struct ItemDbRecord {
+  uint16_t id;
+  uint8_t quality; // ItemQuality
+  uint8_t reserved;
+  uint32_t nameOffset; // Into strings
+  uint32_t vendorValue;
+  uint16_t iconId;
+  uint16_t nameLength;
+};
+
+struct ItemDbName {
+  uint32_t hash; // ItemDbNameHash of the name
+  uint32_t slot; // Index into records
+};
+
+static_assert(sizeof(ItemDbHeader) == 36, "item db header layout");
+static_assert(sizeof(ItemDbRecord) == 16, "item db record layout");
+static_assert(sizeof(ItemDbName) == 8, "item db name layout");
+
+// Hashes shared by the builder and the reader
+inline uint32_t ItemDbHash(uint32_t key, uint32_t seed) {
+  // murmur3 finalizer over the key offset by the seed
+  uint32_t h = key + seed * 0x9E3779B9u;
+  h ^= h >> 16;
+  h *= 0x85EBCA6Bu;
+  h ^= h >> 13;
+  h *= 0xC2B2AE35u;
+  h ^= h >> 16;
+  return h;
+}
+
+inline uint32_t ItemDbNameHash(const char *name, size_t length) {
+  uint32_t h = 2166136261u; // FNV-1a
+  for (size_t i = 0; i < length; i++) {
+    h ^= (uint8_t)name[i];
+    h *= 16777619u;
+  }
+  return h;
+}
+
+class ItemDatabase {
+public:
+  // Validate and attach to a mapped file. The bytes must outlive this object.
+  bool attach(const void *data, size_t size) {
+    detach();
+    if (!data || size < sizeof(ItemDbHeader))
+      return false;
+    const uint8_t *base = (const uint8_t *)data;
+    const ItemDbHeader *header = (const ItemDbHeader *)base;
+    if (header->magic != ITEM_DB_MAGIC || header->version != ITEM_DB_VERSION)
+      return false;
+
+    uint64_t count = header->count;
+    if (!inBounds(header->displacementOffset, count * sizeof(int32_t), size) ||
+        !inBounds(header->recordsOffset, count * sizeof(ItemDbRecord), size) ||
+        !inBounds(header->namesOffset, count * sizeof(ItemDbName), size) ||
+        !inBounds(header->stringsOffset, header->stringsSize, size))
+      return false;
+    // Names are read as C strings; the last one must end inside the table
+    if (header->stringsSize == 0 ||
+        base[header->stringsOffset + header->stringsSize - 1] != '\0')
+      return false;
+
+    m_count = header->count;
+    m_hashSeed = header->hashSeed;
+    m_displacement = (const int32_t *)(base + header->displacementOffset);
+    m_records = (const ItemDbRecord *)(base + header->recordsOffset);
+    m_names = (const ItemDbName *)(base + header->namesOffset);
+    m_strings = (const char *)(base + header->stringsOffset);
+    m_stringsSize = header->stringsSize;
+    return true;
+  }
+
+  void detach() { *this = ItemDatabase(); }
+
+  bool loaded() const { return m_records != nullptr; }
+  uint32_t count() const { return m_count; }
+
+  // O(1): the bucket's displacement either names the slot directly (< 0,
+  // stored as -slot - 1) or seeds the second hash that picks it. Ids not in
+  // the table land on some other item's slot, so the id is checked.
+  const ItemDbRecord *findById(uint16_t id) const {
+    if (m_count == 0)
+      return nullptr;
+    int32_t d = m_displacement[ItemDbHash(id, m_hashSeed) % m_count];
+    uint32_t slot =
+        d < 0 ? (uint32_t)(-(d + 1)) : ItemDbHash(id, (uint32_t)d) % m_count;
+    if (slot >= m_count || m_records[slot].id != id)
+      return nullptr;
+    return &m_records[slot];
+  }
+
+  // Binary search of the name index by hash, then an exact compare
+  const ItemDbRecord *findByName(const char *name, size_t length) const {
+    if (m_count == 0 || !name)
+      return nullptr;
+    uint32_t hash = ItemDbNameHash(name, length);
+    uint32_t lo = 0, hi = m_count;
+    while (lo < hi) {
+      uint32_t mid = lo + (hi - lo) / 2;
+      if (m_names[mid].hash < hash)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+    for (; lo < m_count && m_names[lo].hash == hash; lo++) {
+      if (m_names[lo].slot >= m_count)
+        continue;
+      const ItemDbRecord &record = m_records[m_names[lo].slot];
+      // A name running past the string table (a corrupt file) can't match
+      if (record.nameLength == length &&
+          (uint64_t)record.nameOffset + record.nameLength <= m_stringsSize &&
+          memcmp(m_strings + record.nameOffset, name, length) == 0)
+        return &record;
+    }
+    return nullptr;
+  }
+
+  const char *nameOf(const ItemDbRecord &record) const {
+    return record.nameOffset < m_stringsSize ? m_strings + record.nameOffset
+                                             : "";
+  }
+
+private:
+  static bool inBounds(uint64_t offset, uint64_t length, size_t size) {
+    return offset % 4 == 0 && offset <= size && length <= size - offset;
+  }
+
+  uint32_t m_count{0};
+  uint32_t m_hashSeed{0};
+  const int32_t *m_displacement{nullptr};
+  const ItemDbRecord *m_records{nullptr};
+  const ItemDbName *m_names{nullptr};
+  const char *m_strings{nullptr};
+  uint32_t m_stringsSize{0};
+};
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// Time-to-next-level projection from the player's level and exp, the game's
+// exp table and the recent XP rate. Portable, so the tests build it on Linux.
+
+constexpr int LEVEL_TABLE_SIZE = 128; // Levels 1..127
+
+// Total exp needed to reach each level, as the game's exp_table gives it.
+// Filled on the tick thread when ContentMgr loads and read by whichever
+// thread publishes, hence the relaxed atomics; 0 means the table doesn't
+// say.
+class LevelExpTable {
+public:
+  uint32_t expForLevel(int level) const {
+    if (level <= 0 || level >= LEVEL_TABLE_SIZE)
+      return 0;
+    return m_exp[level].load(std::memory_order_relaxed);
+  }
+
+  void set(int level, uint32_t exp) {
+    if (level > 0 && level < LEVEL_TABLE_SIZE)
+      m_exp[level].store(exp, std::memory_order_relaxed);
+  }
+
+  void clear() {
+    for (auto &exp : m_exp)
+      exp.store(0, std::memory_order_relaxed);
+  }
+
+private:
+  std::atomic<uint32_t> m_exp[LEVEL_TABLE_SIZE]{};
+};
+
+struct LevelProjection {
+  int level;              // Current level, 0 if unknown
+  int expToLevel;         // Exp still needed for level + 1, 0 if unknown
+  int64_t secondsToLevel; // -1 if it can't be estimated
+};
+
+// Project from xpPerHour (the tracker passes its 10 minute rate, steadier
+// than 1m and fresher than 1h). Unknown while the game reads give level or
+// exp 0, while the table has no entry for the next level or disagrees with
+// the player's exp, and while there's no XP pace to project from.
+inline LevelProjection ProjectLevel(int level, int exp,
+                                    const LevelExpTable &table,
+                                    double xpPerHour) {
+  LevelProjection projection = {0, 0, -1};
+  if (level <= 0 || exp <= 0)
+    return projection;
+  projection.level = level;
+  uint32_t needed = table.expForLevel(level + 1);
+  if (needed <= (uint32_t)exp)
+    return projection;
+  projection.expToLevel = (int)(needed - (uint32_t)exp);
+  if (xpPerHour > 1.0)
+    projection.secondsToLevel =
+        (int64_t)(projection.expToLevel / xpPerHour * 3600.0);
+  return projection;
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+
+#include "ShardedCounters.h"
+
+// Direct-mapped cache of id -> name in front of a slow lookup (the game's
+// string-keyed ContentMgr tables). Each slot is one 64-bit word holding the
+// key, the generation it was filled in and an index into a table of interned
+// names, so a hit is a single atomic load and compare with no lock. A newer
+// key simply overwrites the slot it maps to.
+//
+// Names are interned once and never freed, so the returned pointers stay
+// valid for the life of the cache. invalidate() bumps the generation, which
+// turns every filled slot into a miss without touching them. Once the intern
+// table is full, new names are still returned but not cached; see get().
+template <int BITS, uint32_t MAX_NAMES = 0xFFFF> class NameCache {
+public:
+  static constexpr uint32_t SLOTS = 1u << BITS;
+  static_assert(MAX_NAMES <= 0xFFFF, "index is 16 bits, 0 means empty");
+
+  // Cached name for `key`, or load(key) -> std::string on a miss. An empty
+  // load result is not cached (the game may not have the table yet) and
+  // returns nullptr. A name that no longer fits in the intern table is
+  // returned from a per-thread buffer, valid only until the next such name
+  // on the same thread; callers that keep names should copy them.
+  template <typename Load> const char *get(uint32_t key, Load &&load) {
+    uint32_t slot = (key * 0x9E3779B9u) >> (32 - BITS);
+    uint64_t word = m_slots[slot].load(std::memory_order_acquire);
+    uint32_t generation = m_generation.load(std::memory_order_relaxed);
+    if ((uint32_t)word == key && (uint16_t)(word >> 32) == generation &&
+        (word >> 48) != 0) {
+      m_stats.addApprox(STAT_HITS, 1);
+      return m_names[(word >> 48) - 1].load(std::memory_order_relaxed);
+    }
+
+    m_stats.add(STAT_MISSES, 1);
+    std::string name = load(key);
+    if (name.empty())
+      return nullptr;
+    uint32_t index = intern(name);
+    if (index == 0) {
+      m_stats.add(STAT_UNCACHED, 1);
+      thread_local std::string uncached;
+      uncached = std::move(name);
+      return uncached.c_str();
+    }
+    m_slots[slot].store((uint64_t)key | (uint64_t)generation << 32 |
+                            (uint64_t)index << 48,
+                        std::memory_order_release);
+    return m_names[index - 1].load(std::memory_order_relaxed);
+  }
+
+  // Drop every cached entry, e.g. when the game's content is reloaded
+  void invalidate() {
+    uint16_t next = (uint16_t)(m_generation.load() + 1);
+    m_generation.store(next ? next : 1); // 0 would match empty slots
+  }
+
+  // Hits are counted with addApprox to keep the hit path free of locked
+  // instructions, so they may undercount slightly under heavy threading
+  int64_t hits() const { return m_stats.read(STAT_HITS); }
+  int64_t misses() const { return m_stats.read(STAT_MISSES); }
+  int64_t uncached() const { return m_stats.read(STAT_UNCACHED); }
+
+private:
+  enum { STAT_HITS, STAT_MISSES, STAT_UNCACHED, STAT_COUNT };
+
+  // 1-based index of the interned copy of `name`, 0 once the table is full
+  uint32_t intern(const std::string &name) {
+    std::lock_guard<std::mutex> lock(m_internLock);
+    auto found = m_interned.find(Interned{name, 0});
+    if (found != m_interned.end())
+      return found->index;
+    if (m_nameCount == MAX_NAMES)
+      return 0;
+    auto added = m_interned.insert(Interned{name, ++m_nameCount}).first;
+    m_names[m_nameCount - 1].store(added->name.c_str(),
+                                   std::memory_order_relaxed);
+    return m_nameCount;
+  }
+
+  struct Interned {
+    std::string name;
+    uint32_t index;
+    bool operator==(const Interned &other) const { return name == other.name; }
+  };
+  struct InternedHash {
+    size_t operator()(const Interned &v) const {
+      return std::hash<std::string>()(v.name);
+    }
+  };
+
+  std::atomic<uint64_t> m_slots[SLOTS]{};
+  std::atomic<uint16_t> m_generation{1};
+  ShardedCounters<STAT_COUNT> m_stats;
+
+  std::mutex m_internLock;
+  std::unordered_set<Interned, InternedHash> m_interned; // Node-stable
+  uint32_t m_nameCount{0};
+  std::atomic<const char *> m_names[MAX_NAMES]{};
+};
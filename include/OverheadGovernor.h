@@ -0,0 +1,111 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "SharedTrackerData.h"
+
+// Sheds optional work when the hooks cost too much. The detours add their
+// cycles here; each tick turns the total into hook time per 60 Hz frame and
+// compares it with the budget. Going over steps one mode cheaper straight
+// away; stepping back needs the load to stay under half the budget for a
+// while, so the mode doesn't flap around the threshold.
+//
+// No Windows dependencies: the DLL uses the singleton, tests construct their
+// own and drive update() with a simulated clock.
+class OverheadGovernor {
+public:
+  static OverheadGovernor &getInstance() {
+    static OverheadGovernor instance;
+    return instance;
+  }
+
+  OverheadGovernor() = default;
+
+  static constexpr int DEFAULT_BUDGET_US = 250; // 1.5% of a 16.7 ms frame
+  static constexpr double FRAME_MS = 1000.0 / 60.0;
+  static constexpr uint64_t MAX_WINDOW_MS = 5000;
+  static constexpr double RELAX_FRACTION = 0.5;
+  static constexpr uint64_t RELAX_AFTER_MS = 2000;
+
+  void addCycles(uint64_t cycles) {
+    m_cycles.fetch_add(cycles, std::memory_order_relaxed);
+  }
+
+  OverheadMode mode() const {
+    return (OverheadMode)m_mode.load(std::memory_order_relaxed);
+  }
+
+  // Whether this damage event feeds the breakdown and hit sizes. weight is
+  // the sampling interval, so scaled breakdown totals stay unbiased.
+  bool sampleDamage(int &weight) {
+    switch (mode()) {
+    case OVERHEAD_REDUCED:
+      weight = 4;
+      break;
+    case OVERHEAD_MINIMAL:
+      weight = 16;
+      break;
+    default:
+      weight = 1;
+      return true;
+    }
+    return ++m_sampleCounter % weight == 0;
+  }
+
+  // Called from the tick
+  void update(uint64_t nowMs, double tscTicksPerUs, int budgetUs) {
+    uint64_t cycles = m_cycles.exchange(0, std::memory_order_relaxed);
+    uint64_t elapsedMs = nowMs - m_windowStartMs;
+    m_windowStartMs = nowMs;
+    // First tick, or a stall long enough that the average means nothing
+    if (tscTicksPerUs <= 0.0 || elapsedMs == 0 || elapsedMs > MAX_WINDOW_MS)
+      return;
+    if (budgetUs <= 0)
+      budgetUs = DEFAULT_BUDGET_US;
+
+    m_usPerFrame = cycles / tscTicksPerUs * FRAME_MS / elapsedMs;
+
+    int mode = m_mode.load(std::memory_order_relaxed);
+    if (m_usPerFrame > budgetUs) {
+      m_calmSinceMs = 0;
+      if (mode < OVERHEAD_MINIMAL)
+        setMode(mode + 1);
+    } else if (m_usPerFrame < budgetUs * RELAX_FRACTION &&
+               mode > OVERHEAD_FULL) {
+      if (m_calmSinceMs == 0) {
+        m_calmSinceMs = nowMs;
+      } else if (nowMs - m_calmSinceMs >= RELAX_AFTER_MS) {
+        m_calmSinceMs = 0;
+        setMode(mode - 1);
+      }
+    } else {
+      m_calmSinceMs = 0;
+    }
+  }
+
+  double usPerFrame() const { return m_usPerFrame; }
+  int switches() const { return m_switches; }
+
+  void publish(SharedTrackerData *shared) {
+    shared->overheadMode = m_mode.load(std::memory_order_relaxed);
+    shared->overheadModeSwitches = m_switches;
+    shared->overheadUsPerFrame = m_usPerFrame;
+  }
+
+private:
+  void setMode(int mode) {
+    m_mode.store(mode, std::memory_order_relaxed);
+    m_switches++;
+  }
+
+  std::atomic<uint64_t> m_cycles{0}; // Detours add, tick drains
+  std::atomic<int> m_mode{OVERHEAD_FULL};
+  uint32_t m_sampleCounter{0}; // Game thread only
+
+  // Tick side
+  uint64_t m_windowStartMs{0};
+  uint64_t m_calmSinceMs{0};
+  double m_usPerFrame{0.0};
+  int m_switches{0};
+};
@@ -0,0 +1,427 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Columnar file for one session, written by the DLL's tick when stats are
+// reset, by its periodic checkpoint, and on the Unloader's CMD_PREPARE_UNLOAD
+// (never from DllMain), and read back by the archive tools. Portable: no game
+// or tracker types, so the tools build on Linux as well as Windows.
+//
+// Events are stored in blocks of up to ARCHIVE_BLOCK_EVENTS, one run of
+// bytes per column per block, and each block records every column's min and
+// max. A query checks the stats to skip whole blocks, then decodes only the
+// columns it reads.
+//
+// Layout (little-endian):
+//   ArchiveHeader
+//   column data               per block, per column (see ArchiveEncoding)
+//   ArchiveBlockInfo blocks[blockCount]
+//   uint32_t nameOffsets[nameCount] into the name chars
+//   char     names[namesSize]      NUL-terminated mob names (ARCHIVE_KILL ids)
+
+constexpr uint32_t ARCHIVE_MAGIC = 0x41534D44; // "DMSA"
+constexpr uint32_t ARCHIVE_VERSION = 1;
+constexpr uint32_t ARCHIVE_BLOCK_EVENTS = 4096;
+constexpr const char *ARCHIVE_FILE_EXTENSION = ".dms";
+
+enum ArchiveColumn {
+  ARCHIVE_COL_TIME,    // Epoch ms
+  ARCHIVE_COL_TYPE,    // ArchiveEventType
+  ARCHIVE_COL_ID,      // Item id (loot) or names index (kill), else 0
+  ARCHIVE_COL_AMOUNT,  // Stack size, gold or exp
+  ARCHIVE_COL_VALUE,   // Vendor value of a loot stack
+  ARCHIVE_COL_QUALITY, // ItemQuality of loot, else 0
+  ARCHIVE_COLUMNS
+};
+
+enum ArchiveEventType : uint8_t {
+  ARCHIVE_KILL = 1,
+  ARCHIVE_LOOT,
+  ARCHIVE_GOLD,
+  ARCHIVE_EXP,
+  ARCHIVE_SPENT,
+  ARCHIVE_EVENT_TYPES
+};
+
+inline const char *ArchiveEventTypeName(int64_t type) {
+  static const char *const names[ARCHIVE_EVENT_TYPES] = {
+      "?", "kill", "loot", "gold", "exp", "spent"};
+  return type > 0 && type < ARCHIVE_EVENT_TYPES ? names[type] : "?";
+}
+
+// First byte of every column run
+enum ArchiveEncoding : uint8_t {
+  ARCHIVE_ENC_DELTA, // zigzag varint of each value minus the previous one
+  ARCHIVE_ENC_RLE    // (zigzag varint delta, varint run length) pairs
+};
+
+struct ArchiveHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t eventCount;
+  uint32_t blockCount;
+  uint32_t blocksOffset;
+  uint32_t nameCount;
+  uint32_t namesOffset; // nameOffsets, then the chars
+  uint32_t namesSize;
+  int64_t startMs; // Session start and end, epoch ms
+  int64_t endMs;
+};
+
+struct ArchiveBlockInfo {
+  uint32_t firstEvent;
+  uint32_t eventCount;
+  uint32_t offset[ARCHIVE_COLUMNS];
+  uint32_t size[ARCHIVE_COLUMNS];
+  int64_t min[ARCHIVE_COLUMNS];
+  int64_t max[ARCHIVE_COLUMNS];
+};
+
+static_assert(sizeof(ArchiveHeader) == 48, "archive header layout");
+static_assert(sizeof(ArchiveBlockInfo) == 152, "archive block layout");
+
+struct ArchiveEvent {
+  int64_t timestampMs;
+  int64_t amount;
+  int64_t value;
+  uint32_t id;
+  uint8_t type;
+  uint8_t quality;
+};
+
+namespace ArchiveCodec {
+
+inline void putVarint(std::vector<uint8_t> &out, uint64_t v) {
+  while (v >= 0x80) {
+    out.push_back((uint8_t)(v | 0x80));
+    v >>= 7;
+  }
+  out.push_back((uint8_t)v);
+}
+
+inline bool getVarint(const uint8_t *&p, const uint8_t *end, uint64_t &v) {
+  v = 0;
+  for (int shift = 0; shift < 64 && p < end; shift += 7) {
+    uint8_t byte = *p++;
+    v |= (uint64_t)(byte & 0x7F) << shift;
+    if (!(byte & 0x80))
+      return true;
+  }
+  return false;
+}
+
+// Wrapping arithmetic, so corrupt or extreme input can't overflow
+inline int64_t wrapAdd(int64_t a, int64_t b) {
+  return (int64_t)((uint64_t)a + (uint64_t)b);
+}
+inline int64_t wrapSub(int64_t a, int64_t b) {
+  return (int64_t)((uint64_t)a - (uint64_t)b);
+}
+
+inline uint64_t zigzag(int64_t v) {
+  return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63);
+}
+inline int64_t unzigzag(uint64_t v) {
+  return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+}
+
+// Encode one column run both ways and keep the smaller
+inline void encodeColumn(const int64_t *values, uint32_t count,
+                         std::vector<uint8_t> &out) {
+  std::vector<uint8_t> delta, rle;
+  delta.push_back(ARCHIVE_ENC_DELTA);
+  rle.push_back(ARCHIVE_ENC_RLE);
+  int64_t prev = 0, runPrev = 0;
+  for (uint32_t i = 0; i < count; i++) {
+    putVarint(delta, zigzag(wrapSub(values[i], prev)));
+    prev = values[i];
+
+    uint32_t run = 1;
+    while (i + run < count && values[i + run] == values[i])
+      run++;
+    putVarint(rle, zigzag(wrapSub(values[i], runPrev)));
+    putVarint(rle, run);
+    runPrev = values[i];
+    // Delta still has to see every value; RLE skips the rest of the run
+    for (uint32_t r = 1; r < run; r++)
+      putVarint(delta, 0);
+    i += run - 1;
+  }
+  const std::vector<uint8_t> &best = rle.size() < delta.size() ? rle : delta;
+  out.insert(out.end(), best.begin(), best.end());
+}
+
+// Decode exactly `count` values; false if the run is malformed
+inline bool decodeColumn(const uint8_t *p, const uint8_t *end, uint32_t count,
+                         int64_t *out) {
+  if (p >= end)
+    return false;
+  uint8_t encoding = *p++;
+  int64_t prev = 0;
+  uint64_t v;
+  if (encoding == ARCHIVE_ENC_DELTA) {
+    for (uint32_t i = 0; i < count; i++) {
+      if (!getVarint(p, end, v))
+        return false;
+      prev = wrapAdd(prev, unzigzag(v));
+      out[i] = prev;
+    }
+    return true;
+  }
+  if (encoding == ARCHIVE_ENC_RLE) {
+    for (uint32_t i = 0; i < count;) {
+      uint64_t run;
+      if (!getVarint(p, end, v) || !getVarint(p, end, run) || run == 0 ||
+          run > count - i)
+        return false;
+      prev = wrapAdd(prev, unzigzag(v));
+      for (uint64_t r = 0; r < run; r++)
+        out[i++] = prev;
+    }
+    return true;
+  }
+  return false;
+}
+
+} // namespace ArchiveCodec
+
+// Build a complete archive in memory. Events must be in time order; names
+// are indexed by the id column of ARCHIVE_KILL events.
+inline std::vector<uint8_t>
+EncodeSessionArchive(const std::vector<ArchiveEvent> &events,
+                     const std::vector<std::string> &names, int64_t startMs,
+                     int64_t endMs) {
+  std::vector<uint8_t> out(sizeof(ArchiveHeader));
+  std::vector<ArchiveBlockInfo> blocks;
+  std::vector<int64_t> column(ARCHIVE_BLOCK_EVENTS);
+
+  for (size_t first = 0; first < events.size();
+       first += ARCHIVE_BLOCK_EVENTS) {
+    size_t left = events.size() - first;
+    ArchiveBlockInfo block = {};
+    block.firstEvent = (uint32_t)first;
+    block.eventCount =
+        left < ARCHIVE_BLOCK_EVENTS ? (uint32_t)left : ARCHIVE_BLOCK_EVENTS;
+    for (int c = 0; c < ARCHIVE_COLUMNS; c++) {
+      for (uint32_t i = 0; i < block.eventCount; i++) {
+        const ArchiveEvent &e = events[first + i];
+        int64_t values[ARCHIVE_COLUMNS] = {e.timestampMs, e.type,  e.id,
+                                           e.amount,      e.value, e.quality};
+        column[i] = values[c];
+        if (i == 0 || column[i] < block.min[c])
+          block.min[c] = column[i];
+        if (i == 0 || column[i] > block.max[c])
+          block.max[c] = column[i];
+      }
+      block.offset[c] = (uint32_t)out.size();
+      ArchiveCodec::encodeColumn(column.data(), block.eventCount, out);
+      block.size[c] = (uint32_t)out.size() - block.offset[c];
+    }
+    blocks.push_back(block);
+  }
+
+  while (out.size() % 8)
+    out.push_back(0);
+  ArchiveHeader header = {};
+  header.magic = ARCHIVE_MAGIC;
+  header.version = ARCHIVE_VERSION;
+  header.eventCount = (uint32_t)events.size();
+  header.blockCount = (uint32_t)blocks.size();
+  header.blocksOffset = (uint32_t)out.size();
+  const uint8_t *blockBytes = (const uint8_t *)blocks.data();
+  out.insert(out.end(), blockBytes,
+             blockBytes + blocks.size() * sizeof(ArchiveBlockInfo));
+
+  header.nameCount = (uint32_t)names.size();
+  header.namesOffset = (uint32_t)out.size();
+  std::vector<char> chars;
+  for (const std::string &name : names) {
+    uint32_t offset = (uint32_t)chars.size();
+    const uint8_t *bytes = (const uint8_t *)&offset;
+    out.insert(out.end(), bytes, bytes + sizeof(offset));
+    chars.insert(chars.end(), name.begin(), name.end());
+    chars.push_back('\0');
+  }
+  out.insert(out.end(), chars.begin(), chars.end());
+  header.namesSize = (uint32_t)chars.size();
+  header.startMs = startMs;
+  header.endMs = endMs;
+  memcpy(out.data(), &header, sizeof(header));
+  return out;
+}
+
+// Reader over an archive's bytes (usually a SessionArchiveFile mapping).
+// Nothing is decoded until a column of a block is asked for.
+class SessionArchive {
+public:
+  bool attach(const void *data, size_t size) {
+    *this = SessionArchive();
+    if (!data || size < sizeof(ArchiveHeader))
+      return false;
+    const uint8_t *base = (const uint8_t *)data;
+    const ArchiveHeader *header = (const ArchiveHeader *)base;
+    if (header->magic != ARCHIVE_MAGIC || header->version != ARCHIVE_VERSION)
+      return false;
+    if (!inBounds(header->blocksOffset,
+                  (uint64_t)header->blockCount * sizeof(ArchiveBlockInfo),
+                  size) ||
+        header->blocksOffset % 8 != 0 ||
+        !inBounds(header->namesOffset, (uint64_t)header->nameCount * 4, size) ||
+        !inBounds(header->namesOffset + (uint64_t)header->nameCount * 4,
+                  header->namesSize, size))
+      return false;
+    // Names are read as C strings; the last one must end inside the file
+    if (header->namesSize > 0 &&
+        base[header->namesOffset + header->nameCount * 4 + header->namesSize -
+             1] != '\0')
+      return false;
+
+    const ArchiveBlockInfo *blocks =
+        (const ArchiveBlockInfo *)(base + header->blocksOffset);
+    for (uint32_t b = 0; b < header->blockCount; b++) {
+      if (blocks[b].eventCount > ARCHIVE_BLOCK_EVENTS)
+        return false;
+      for (int c = 0; c < ARCHIVE_COLUMNS; c++)
+        if (!inBounds(blocks[b].offset[c], blocks[b].size[c], size))
+          return false;
+    }
+
+    m_base = base;
+    m_header = header;
+    m_blocks = blocks;
+    m_nameOffsets = (const uint32_t *)(base + header->namesOffset);
+    m_names = (const char *)(m_nameOffsets + header->nameCount);
+    return true;
+  }
+
+  bool loaded() const { return m_header != nullptr; }
+  const ArchiveHeader &header() const { return *m_header; }
+  uint32_t blockCount() const { return m_header->blockCount; }
+  const ArchiveBlockInfo &block(uint32_t b) const { return m_blocks[b]; }
+
+  // Whether any event in the block can have column c within [lo, hi]
+  bool blockMayMatch(uint32_t b, int c, int64_t lo, int64_t hi) const {
+    return m_blocks[b].max[c] >= lo && m_blocks[b].min[c] <= hi;
+  }
+
+  // Decode one column of block b into out[block(b).eventCount]
+  bool decode(uint32_t b, int c, int64_t *out) const {
+    const ArchiveBlockInfo &block = m_blocks[b];
+    const uint8_t *p = m_base + block.offset[c];
+    return ArchiveCodec::decodeColumn(p, p + block.size[c], block.eventCount,
+                                      out);
+  }
+
+  // Mob name for an ARCHIVE_KILL id
+  const char *name(int64_t id) const {
+    if (id < 0 || id >= m_header->nameCount ||
+        m_nameOffsets[id] >= m_header->namesSize)
+      return "";
+    return m_names + m_nameOffsets[id];
+  }
+
+private:
+  static bool inBounds(uint64_t offset, uint64_t length, size_t size) {
+    return offset <= size && length <= size - offset;
+  }
+
+  const uint8_t *m_base{nullptr};
+  const ArchiveHeader *m_header{nullptr};
+  const ArchiveBlockInfo *m_blocks{nullptr};
+  const uint32_t *m_nameOffsets{nullptr};
+  const char *m_names{nullptr};
+};
+
+// Read-only memory mapping of a whole file
+class SessionArchiveFile {
+public:
+  SessionArchiveFile() = default;
+  ~SessionArchiveFile() { close(); }
+  SessionArchiveFile(const SessionArchiveFile &) = delete;
+  SessionArchiveFile &operator=(const SessionArchiveFile &) = delete;
+
+  bool open(const char *path) {
+    close();
+#ifdef _WIN32
+    m_file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr,
+                         OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    LARGE_INTEGER size;
+    if (m_file == INVALID_HANDLE_VALUE || !GetFileSizeEx(m_file, &size) ||
+        size.QuadPart == 0 || size.QuadPart > 0xFFFFFFFF) {
+      close();
+      return false;
+    }
+    m_mapping =
+        CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    m_data = m_mapping ? MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0)
+                       : nullptr;
+    m_size = (size_t)size.QuadPart;
+#else
+    m_fd = ::open(path, O_RDONLY);
+    struct stat st;
+    if (m_fd < 0 || fstat(m_fd, &st) != 0 || st.st_size == 0 ||
+        (uint64_t)st.st_size > 0xFFFFFFFF) {
+      close();
+      return false;
+    }
+    void *data = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE,
+                      m_fd, 0);
+    m_data = data == MAP_FAILED ? nullptr : data;
+    m_size = (size_t)st.st_size;
+#endif
+    if (!m_data || !m_archive.attach(m_data, m_size)) {
+      close();
+      return false;
+    }
+    return true;
+  }
+
+  void close() {
+    m_archive = SessionArchive();
+#ifdef _WIN32
+    if (m_data)
+      UnmapViewOfFile(m_data);
+    if (m_mapping)
+      CloseHandle(m_mapping);
+    if (m_file != INVALID_HANDLE_VALUE)
+      CloseHandle(m_file);
+    m_mapping = nullptr;
+    m_file = INVALID_HANDLE_VALUE;
+#else
+    if (m_data)
+      munmap((void *)m_data, m_size);
+    if (m_fd >= 0)
+      ::close(m_fd);
+    m_fd = -1;
+#endif
+    m_data = nullptr;
+    m_size = 0;
+  }
+
+  const SessionArchive &archive() const { return m_archive; }
+  size_t size() const { return m_size; }
+
+private:
+  SessionArchive m_archive;
+  const void *m_data{nullptr};
+  size_t m_size{0};
+#ifdef _WIN32
+  HANDLE m_file{INVALID_HANDLE_VALUE};
+  HANDLE m_mapping{nullptr};
+#else
+  int m_fd{-1};
+#endif
+};
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// A fixed set of int64 counters that many threads add to without sharing
+// cache lines. Each thread is given a shard the first time it adds; adds are
+// relaxed atomic increments on that shard's own line and readers sum all
+// shards. More threads than shards just share a shard, which stays correct.
+//
+// Reset takes the current sums as a baseline that later reads subtract, so a
+// reset never has to clear memory another thread may be adding to.
+template <int COUNTERS, int SHARDS = 8> class ShardedCounters {
+public:
+  void add(int counter, int64_t amount) {
+    m_shards[shardIndex()].values[counter].fetch_add(
+        amount, std::memory_order_relaxed);
+  }
+
+  // Cheaper add for high-rate statistics: a plain load and store with no
+  // locked instruction. Exact while each thread has its own shard; adds
+  // from two threads sharing one can occasionally be lost.
+  void addApprox(int counter, int64_t amount) {
+    std::atomic<int64_t> &value = m_shards[shardIndex()].values[counter];
+    value.store(value.load(std::memory_order_relaxed) + amount,
+                std::memory_order_relaxed);
+  }
+
+  int64_t read(int counter) const {
+    return sum(counter) - m_baseline[counter].load(std::memory_order_relaxed);
+  }
+
+  void reset() {
+    for (int c = 0; c < COUNTERS; c++)
+      m_baseline[c].store(sum(c), std::memory_order_relaxed);
+  }
+
+private:
+  struct alignas(64) Shard {
+    std::atomic<int64_t> values[COUNTERS]{};
+  };
+
+  static int shardIndex() {
+    static std::atomic<int> nextShard{0};
+    thread_local int index = nextShard.fetch_add(1) % SHARDS;
+    return index;
+  }
+
+  int64_t sum(int counter) const {
+    int64_t total = 0;
+    for (int s = 0; s < SHARDS; s++)
+      total += m_shards[s].values[counter].load(std::memory_order_relaxed);
+    return total;
+  }
+
+  Shard m_shards[SHARDS];
+  std::atomic<int64_t> m_baseline[COUNTERS]{};
+};
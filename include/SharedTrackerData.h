@@ -0,0 +1,724 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// Layout of the shared memory block, included by both the DLL and the GUI so
+// the two sides can never drift apart.
+
+// Shared memory name for IPC between DLL and GUI
+#define TRACKER_SHARED_MEMORY_NAME "DreadmystTrackerSharedMemory"
+#define TRACKER_MUTEX_NAME "DreadmystTrackerMutex"
+// Auto-reset event the DLL signals after each publish that changed the data
+#define TRACKER_UPDATE_EVENT_NAME "DreadmystTrackerUpdateEvent"
+
+// 32-bit atomics on memory shared between processes (x86 is TSO, so on
+// MSVC a compiler barrier is enough for acquire/release)
+inline uint32_t SharedLoadAcquire(const volatile uint32_t *p) {
+#ifdef _MSC_VER
+  uint32_t v = *p;
+  _ReadWriteBarrier();
+  return v;
+#else
+  return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+#endif
+}
+
+inline void SharedStoreRelease(volatile uint32_t *p, uint32_t v) {
+#ifdef _MSC_VER
+  _ReadWriteBarrier();
+  *p = v;
+#else
+  __atomic_store_n(p, v, __ATOMIC_RELEASE);
+#endif
+}
+
+// Returns the previous value; the swap happened if it equals `expected`
+inline uint32_t SharedCompareExchange(volatile uint32_t *p, uint32_t expected,
+                                      uint32_t desired) {
+#ifdef _MSC_VER
+  return (uint32_t)_InterlockedCompareExchange((volatile long *)p,
+                                               (long)desired, (long)expected);
+#else
+  return __sync_val_compare_and_swap(p, expected, desired);
+#endif
+}
+
+// Fixed-size log-bucketed histogram (HDR-style). Values below 8 get exact
+// buckets; above that each power of two is split into 8 linear sub-buckets,
+// so any reported value is within ~6% of the true one. 240 buckets cover the
+// full uint32 range in under 1 KB, and histograms merge by adding counts.
+struct LogHistogram {
+  static constexpr int SUB_BITS = 3;
+  static constexpr int SUB_BUCKETS = 1 << SUB_BITS;
+  static constexpr int BUCKETS = (32 - SUB_BITS + 1) * SUB_BUCKETS;
+
+  uint32_t counts[BUCKETS];
+  uint64_t total;
+  uint64_t sum;
+  uint32_t max;
+
+  void clear() { memset(this, 0, sizeof(*this)); }
+
+  // weight is how many samples this one stands for (sampled recording)
+  void record(uint32_t value, uint32_t weight = 1) {
+    counts[bucketOf(value)] += weight;
+    total += weight;
+    sum += (uint64_t)value * weight;
+    if (value > max)
+      max = value;
+  }
+
+  void merge(const LogHistogram &other) {
+    for (int i = 0; i < BUCKETS; i++)
+      counts[i] += other.counts[i];
+    total += other.total;
+    sum += other.sum;
+    if (other.max > max)
+      max = other.max;
+  }
+
+  // Value at quantile q (0..1), reported as the bucket midpoint and clamped
+  // to the exact max so high percentiles never overshoot it.
+  uint32_t percentile(double q) const {
+    if (total == 0)
+      return 0;
+    uint64_t rank = (uint64_t)(q * total + 0.5);
+    if (rank < 1)
+      rank = 1;
+    if (rank >= total)
+      return max;
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKETS; i++) {
+      seen += counts[i];
+      if (seen >= rank) {
+        uint32_t mid = bucketLow(i) + bucketWidth(i) / 2;
+        return mid < max ? mid : max;
+      }
+    }
+    return max;
+  }
+
+  static int bucketOf(uint32_t value) {
+    if (value < SUB_BUCKETS)
+      return (int)value;
+    int exp = floorLog2(value);
+    int sub = (int)(value >> (exp - SUB_BITS)) & (SUB_BUCKETS - 1);
+    return (exp - SUB_BITS + 1) * SUB_BUCKETS + sub;
+  }
+
+  static uint32_t bucketLow(int idx) {
+    if (idx < SUB_BUCKETS)
+      return (uint32_t)idx;
+    int exp = idx / SUB_BUCKETS + SUB_BITS - 1;
+    uint32_t sub = idx % SUB_BUCKETS;
+    return (SUB_BUCKETS + sub) << (exp - SUB_BITS);
+  }
+
+  static uint32_t bucketWidth(int idx) {
+    if (idx < SUB_BUCKETS)
+      return 1;
+    return 1u << (idx / SUB_BUCKETS - 1);
+  }
+
+  static int floorLog2(uint32_t value) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanReverse(&index, value);
+    return (int)index;
+#else
+    return 31 - __builtin_clz(value);
+#endif
+  }
+};
+
+// Horizons for the exponentially weighted rates below
+enum RateHorizon { RATE_1M = 0, RATE_10M = 1, RATE_1H = 2, RATE_HORIZONS = 3 };
+
+// One interval's aggregates (also used for sums over several intervals)
+struct SeriesSample {
+  int64_t damage{0};
+  int64_t gold{0};
+  int64_t xp{0};
+  int64_t kills{0};
+  int64_t loot{0};
+
+  SeriesSample &operator+=(const SeriesSample &o) {
+    damage += o.damage;
+    gold += o.gold;
+    xp += o.xp;
+    kills += o.kills;
+    loot += o.loot;
+    return *this;
+  }
+};
+
+// Fixed-capacity ring of per-interval aggregates stored as one array per
+// metric, so a window of a single metric is one contiguous copy (two when it
+// wraps). `head` counts samples ever written; the newest lives at slot
+// (head - 1) % N. The writer fills a slot before bumping head, so a reader
+// that checks head again after copying can tell if the window was overrun.
+template <int N> struct TimeSeriesRing {
+  static constexpr int CAPACITY = N;
+
+  int64_t damage[N];
+  int64_t gold[N];
+  int32_t xp[N];
+  int32_t kills[N];
+  int32_t loot[N];
+
+  volatile uint32_t head;   // Samples written since reset
+  int64_t headTime;         // Epoch ms at the end of the newest sample
+  uint32_t intervalMs;      // Span covered by one sample
+
+  void clear(uint32_t interval) {
+    memset(this, 0, sizeof(*this));
+    intervalMs = interval;
+  }
+
+  void push(const SeriesSample &s, int64_t endTime) {
+    uint32_t slot = head % N;
+    damage[slot] = s.damage;
+    gold[slot] = s.gold;
+    xp[slot] = (int32_t)s.xp;
+    kills[slot] = (int32_t)s.kills;
+    loot[slot] = (int32_t)s.loot;
+    headTime = endTime;
+    head = head + 1;
+  }
+
+  int available() const { return head < (uint32_t)N ? (int)head : N; }
+
+  // Copies the newest `count` samples of one column into out, oldest first.
+  // Returns how many were copied (fewer when the ring isn't full yet).
+  template <typename T>
+  int copyWindow(const T (&column)[N], int count, T *out) const {
+    uint32_t end = head;
+    int avail = end < (uint32_t)N ? (int)end : N;
+    if (count > avail)
+      count = avail;
+    if (count <= 0)
+      return 0;
+    int first = (int)((end - count) % N);
+    int run = N - first < count ? N - first : count;
+    memcpy(out, &column[first], run * sizeof(T));
+    memcpy(out + run, &column[0], (count - run) * sizeof(T));
+    return count;
+  }
+
+  // Sum of `count` samples, skipping the newest `skip`. Clipped to what the
+  // ring still holds.
+  SeriesSample sum(int skip, int count) const {
+    SeriesSample total;
+    uint32_t end = head;
+    int avail = end < (uint32_t)N ? (int)end : N;
+    if (skip + count > avail)
+      count = avail - skip;
+    for (int i = 0; i < count; i++) {
+      uint32_t slot = (end - 1 - skip - i) % N;
+      total.damage += damage[slot];
+      total.gold += gold[slot];
+      total.xp += xp[slot];
+      total.kills += kills[slot];
+      total.loot += loot[slot];
+    }
+    return total;
+  }
+};
+
+// The last hour per second, the last day per minute and the last week per
+// hour. Seconds are pushed one at a time and folded into the coarser tiers
+// as each minute and hour completes, so memory stays fixed however long the
+// session runs.
+struct SeriesHistory {
+  static constexpr uint32_t SECONDS_PER_MINUTE = 60;
+  static constexpr uint32_t SECONDS_PER_HOUR = 3600;
+
+  TimeSeriesRing<3600> perSecond;
+  TimeSeriesRing<1440> perMinute;
+  TimeSeriesRing<168> perHour;
+  SeriesSample minuteSoFar; // Seconds since the last minute boundary
+  SeriesSample hourSoFar;   // Seconds since the last hour boundary
+
+  void clear() {
+    perSecond.clear(1000);
+    perMinute.clear(SECONDS_PER_MINUTE * 1000);
+    perHour.clear(SECONDS_PER_HOUR * 1000);
+    minuteSoFar = SeriesSample();
+    hourSoFar = SeriesSample();
+  }
+
+  void pushSecond(const SeriesSample &s, int64_t endTime) {
+    perSecond.push(s, endTime);
+    minuteSoFar += s;
+    hourSoFar += s;
+    uint32_t seconds = perSecond.head;
+    if (seconds % SECONDS_PER_MINUTE == 0) {
+      perMinute.push(minuteSoFar, endTime);
+      minuteSoFar = SeriesSample();
+    }
+    if (seconds % SECONDS_PER_HOUR == 0) {
+      perHour.push(hourSoFar, endTime);
+      hourSoFar = SeriesSample();
+    }
+  }
+
+  // Totals over the last `seconds` completed seconds, taking whole hours and
+  // minutes from the coarse tiers and only the ragged ends from finer ones,
+  // so even multi-hour ranges cost a few dozen reads. Once the history runs
+  // out the range is cut short; `covered` receives the seconds summed.
+  SeriesSample sumLast(uint32_t seconds, uint32_t *covered = nullptr) const {
+    SeriesSample total;
+    uint32_t written = perSecond.head;
+    if (seconds > written)
+      seconds = written;
+
+    // Ages count back from the newest second. Minute boundaries fall at
+    // intoMinute + 60k and hour boundaries at intoHour + 3600k.
+    uint32_t intoMinute = written % SECONDS_PER_MINUTE;
+    uint32_t intoHour = written % SECONDS_PER_HOUR;
+    uint32_t age = 0;
+
+    if (seconds >= intoHour) {
+      total += hourSoFar;
+      age = intoHour;
+      uint32_t hours = (seconds - age) / SECONDS_PER_HOUR;
+      if (hours > (uint32_t)perHour.available())
+        hours = perHour.available();
+      total += perHour.sum(0, (int)hours);
+      age += hours * SECONDS_PER_HOUR;
+    } else if (seconds >= intoMinute) {
+      total += minuteSoFar;
+      age = intoMinute;
+    }
+
+    if (age >= intoMinute) {
+      int skip = (int)((age - intoMinute) / SECONDS_PER_MINUTE);
+      int minutes = (int)((seconds - age) / SECONDS_PER_MINUTE);
+      if (skip + minutes > perMinute.available())
+        minutes = perMinute.available() - skip;
+      if (minutes > 0) {
+        total += perMinute.sum(skip, minutes);
+        age += minutes * SECONDS_PER_MINUTE;
+      }
+    }
+
+    int rest = (int)(seconds - age);
+    if ((int)age + rest > perSecond.available())
+      rest = perSecond.available() - (int)age;
+    if (rest > 0) {
+      total += perSecond.sum((int)age, rest);
+      age += rest;
+    }
+
+    if (covered)
+      *covered = age;
+    return total;
+  }
+};
+
+// Percentile summary of one histogram, for display
+struct HitSizeSummary {
+  int32_t id{0}; // Spell id, or 0 for an overall summary
+  uint64_t count{0};
+  uint32_t p50{0};
+  uint32_t p90{0};
+  uint32_t p99{0};
+  uint32_t max{0};
+};
+
+// Drop rates of one mob. Loot is joined to the most recent kill within the
+// drop window; rates are shares of that mob's kills with 95% Wilson bounds.
+struct MobDropItem {
+  char name[32]{};
+  uint16_t itemId{0};
+  uint8_t quality{0};
+  int32_t kills{0}; // Kills that dropped this item at least once
+  float rate{0}, low{0}, high{0};
+};
+
+struct MobDrops {
+  char name[32]{};
+  int32_t kills{0};
+  int32_t killsWithDrop{0};
+  int32_t drops{0}; // Loot events joined to this mob's kills
+  int32_t dropsByQuality[6]{};
+  float dropRate{0}, low{0}, high{0}; // killsWithDrop / kills
+  MobDropItem items[3]{};             // Most often dropped first
+};
+
+// Detours whose cost is measured (index into SharedTrackerData::hookLatency)
+enum HookId {
+  HOOK_ADD_LINE = 0,
+  HOOK_RECV_MSG,
+  HOOK_COMBAT_MSG,
+  HOOK_EXP_NOTIFY,
+  HOOK_ITEM_NOTIFY,
+  HOOK_COUNT
+};
+
+// Cycles spent in our detour code per call, excluding the original function
+struct HookLatency {
+  char name[16];
+  LogHistogram cycles; // total doubles as the call count
+};
+
+// Registry state of each hook (SharedTrackerData::hookState)
+enum HookState : uint8_t {
+  HOOK_STATE_MISSING = 0, // Target not found or MinHook refused it
+  HOOK_STATE_OFF,
+  HOOK_STATE_ON
+};
+
+// Fidelity levels the DLL steps through when hook time exceeds its budget
+enum OverheadMode {
+  OVERHEAD_FULL = 0, // Everything recorded and published per event
+  OVERHEAD_REDUCED,  // Sampled damage breakdown, chat parsed on the tick
+  OVERHEAD_MINIMAL,  // As reduced, sparser sampling, publish on the tick only
+  OVERHEAD_MODES
+};
+
+// Startup milestones in the order they're reached; initialization runs in
+// three prioritized steps (shared memory, hooks, game lookups), so the GUI
+// has partial functionality long before the last one
+enum InitStage {
+  INIT_SHARED_MEMORY = 0, // GUI can connect, counters live
+  INIT_MODULE_MAPPED,     // Game image mapped and readable
+  INIT_HOOKS,             // Chat/combat hooks installed, tick running
+  INIT_SIGNATURES,        // sApplication/sContentMgr patterns found
+  INIT_SINGLETONS,        // Both singletons constructed
+  INIT_OVERLAY,           // Overlay initialized; startup complete
+  INIT_FIRST_EVENT,       // First tracked game event
+  INIT_STAGES
+};
+
+// initStageMs values other than a time
+enum : int32_t {
+  INIT_STAGE_PENDING = -1,
+  INIT_STAGE_SKIPPED = -2 // Timed out or not possible; startup went on
+};
+
+// GameBridge name caches, indexes nameCacheHits/nameCacheMisses
+enum NameCacheId { NAME_CACHE_NPC, NAME_CACHE_ITEM, NAME_CACHES };
+
+// Requests from the GUI (or the DLL's own exports) to the tracker
+enum TrackerCommandType : uint32_t {
+  CMD_NONE = 0,
+  CMD_RESET_STATS = 1,
+  CMD_TOGGLE_OVERLAY = 2,
+  CMD_SET_FILTER = 3,      // flags + text (filter terms)
+  CMD_SET_RATE_LIMIT = 4,  // flags, args[0] msgs/min, args[1] burst
+  CMD_SET_REFRESH_RATE = 5, // args[0] publish interval in ms
+  CMD_SET_HOOK_ENABLED = 6, // flags (CMD_FLAG_ENABLED), args[0] HookId
+  CMD_SET_DROP_WINDOW = 7,  // args[0] kill-to-loot join window in ms
+  CMD_PREPARE_UNLOAD = 8    // Save the session, stop startup; FreeLibrary next
+};
+
+// Flag bits for CMD_SET_FILTER, CMD_SET_RATE_LIMIT and CMD_SET_HOOK_ENABLED
+enum : uint32_t {
+  CMD_FLAG_ENABLED = 1,
+  CMD_FLAG_BLOCK_ITEMS = 2,
+  CMD_FLAG_REGEX = 4
+};
+
+struct TrackerCommand {
+  uint32_t type;
+  uint32_t flags;
+  int32_t args[2];
+  char text[512];
+};
+
+// Bounded multi-producer, single-consumer command queue living in shared
+// memory. Producers claim a position with a CAS on writePos, fill the slot
+// and then publish it through the slot's state; the DLL drains slots in
+// order at a safe point and acknowledges each by sequence number. A slot's
+// state is 2*lap while free and 2*lap+1 while holding a command, so the
+// zero-filled mapping starts out as an empty queue.
+struct CommandRing {
+  static constexpr uint32_t CAPACITY = 16; // Power of two
+
+  struct Slot {
+    volatile uint32_t state;
+    uint32_t seq;
+    TrackerCommand cmd;
+  } slots[CAPACITY];
+
+  volatile uint32_t writePos; // Next position to claim (producers)
+  volatile uint32_t readPos;  // Next position to drain (DLL only)
+  volatile uint32_t ackedSeq; // Sequence number of the last applied command
+
+  // Returns the command's sequence number, or 0 if the queue is full
+  uint32_t push(const TrackerCommand &cmd) {
+    uint32_t pos = SharedLoadAcquire(&writePos);
+    for (;;) {
+      Slot &slot = slots[pos % CAPACITY];
+      uint32_t free = (pos / CAPACITY) * 2;
+      int32_t diff = (int32_t)(SharedLoadAcquire(&slot.state) - free);
+      if (diff == 0) {
+        uint32_t seen = SharedCompareExchange(&writePos, pos, pos + 1);
+        if (seen == pos)
+          break;
+        pos = seen; // Another producer won; retry at its position
+      } else if (diff < 0) {
+        return 0; // Slot still holds last lap's command
+      } else {
+        pos = SharedLoadAcquire(&writePos);
+      }
+    }
+    Slot &slot = slots[pos % CAPACITY];
+    slot.cmd = cmd;
+    slot.seq = pos + 1;
+    SharedStoreRelease(&slot.state, (pos / CAPACITY) * 2 + 1);
+    return pos + 1;
+  }
+
+  // Consumer side: takes the next command if one has been published
+  bool pop(TrackerCommand &out, uint32_t &seq) {
+    uint32_t pos = readPos;
+    Slot &slot = slots[pos % CAPACITY];
+    uint32_t full = (pos / CAPACITY) * 2 + 1;
+    if (SharedLoadAcquire(&slot.state) != full)
+      return false;
+    out = slot.cmd;
+    seq = slot.seq;
+    SharedStoreRelease(&slot.state, full + 1); // Free for the next lap
+    readPos = pos + 1;
+    return true;
+  }
+
+  void ack(uint32_t seq) { SharedStoreRelease(&ackedSeq, seq); }
+
+  bool isAcked(uint32_t seq) const {
+    return (int32_t)(SharedLoadAcquire(&ackedSeq) - seq) >= 0;
+  }
+};
+
+// Structure shared between DLL and external GUI
+struct SharedTrackerData {
+  // Magic number to verify valid data (0 until DLL initializes it)
+  uint32_t magic{0};
+
+  // Player stats
+  int totalKills{0};
+  int totalLootItems{0};
+  int64_t totalGold{0};
+  int totalExp{0};
+  int64_t goldSpent{0};   // Repair costs, purchases, etc.
+  int64_t totalDamage{0}; // Total damage dealt (for DPS)
+
+  // Party stats
+  int partyKills{0};
+  int partyLootItems{0};
+  int64_t partyGold{0};
+  int partyExp{0};
+
+  // Loot by quality (indices 0-5 for QualityLv0-QualityLv5)
+  int lootByQuality[6]{0, 0, 0, 0, 0, 0};
+
+  // Last 10 loot entries (circular buffer)
+  struct RecentLoot {
+    char itemName[64]{};
+    uint8_t quality{0};
+    int amount{0};
+    int64_t timestamp{0};
+  } recentLoot[10]{};
+  int recentLootIndex{0};
+
+  // Last 10 kill entries (circular buffer)
+  struct RecentKill {
+    char mobName[64]{};
+    int expGained{0};
+    int64_t timestamp{0};
+  } recentKills[10]{};
+  int recentKillIndex{0};
+
+  // Overlay visible flag (can be toggled from GUI)
+  bool overlayVisible{false};
+
+  // Session start time
+  int64_t sessionStartTime{0};
+
+  // Combat DPS tracking
+  int64_t combatStartTime{0}; // When current combat started (ms since epoch)
+  int64_t combatDamage{0};    // Damage dealt in current combat
+  int64_t lastDamageTime{0};  // When last damage was dealt (for timeout)
+  double lastCombatDPS{0.0};  // DPS from last completed combat
+  bool inCombat{false};       // Currently in combat
+
+  // Chat filter settings (set by GUI, read by DLL)
+  bool chatFilterEnabled{false};
+  char chatFilterTerms[512]{};  // Comma-separated filter terms
+  bool blockLinkedItems{false}; // Block messages containing item links
+  bool useRegexFilter{false}; // Use regex matching instead of simple substring
+
+  // Anti-AFK settings
+  bool antiAfkEnabled{false}; // Periodically send input to prevent AFK kick
+
+  // Chat flood rate limiting (set by GUI, checked in recvMsg before filters)
+  bool chatRateLimitEnabled{false};
+  int chatRateLimitPerMinute{0}; // Sustained messages allowed per sender
+  int chatRateLimitBurst{0};     // Messages a sender may send back-to-back
+
+  // Throttle counters (written by DLL), top senders by dropped messages
+  int64_t chatThrottledTotal{0};
+  struct ThrottledSender {
+    char name[32]{};
+    int throttled{0};
+  } throttledSenders[8]{};
+
+  // Rolling DPS over the last 5/30/60 seconds and the current fight's DPS
+  double dps5s{0.0};
+  double dps30s{0.0};
+  double dps60s{0.0};
+  double combatDPS{0.0};
+  int combatIdleTimeoutMs{0}; // Set by GUI; no damage this long ends combat
+
+  // Damage breakdown, highest first
+  struct DamageSource {
+    int32_t id{0}; // Target GUID or spell id
+    int64_t damage{0};
+    int hits{0};
+    int maxHit{0};
+  };
+  DamageSource topTargets[8]{};
+  DamageSource topSpells[8]{};
+  int64_t breakdownDamage{0}; // Total damage seen by the breakdown
+
+  // Hit-size distributions. Session figures include the current fight;
+  // hitBySpell follows the order of topSpells.
+  HitSizeSummary hitDamage{};
+  HitSizeSummary hitDamageFight{}; // Current fight, or the last one
+  HitSizeSummary hitHealing{};
+  HitSizeSummary hitBySpell[8]{};
+  LogHistogram damageHistogram{}; // Full session damage distribution
+
+  // Exponentially weighted rates per hour, indexed by RateHorizon
+  double xpPerHour[RATE_HORIZONS]{};
+  double killsPerHour[RATE_HORIZONS]{};
+  double goldPerHour[RATE_HORIZONS]{};
+  double lootPerHour[RATE_HORIZONS]{};
+
+  // Level projection from xpPerHour[RATE_10M]; secondsToLevel is -1 when it
+  // can't be estimated (see ProjectLevel)
+  int playerLevel{0};
+  int expToLevel{0};
+  int64_t secondsToLevel{-1};
+
+  // DLL-side monotonic session clock (survives GUI restarts)
+  int64_t sessionElapsedMs{0};
+
+  // Damage/gold/xp/kills/loot over time, for graphing and range queries
+  SeriesHistory history{};
+
+  // Bumped by the DLL when a publish changed the content (see
+  // PublishedContentHash); readers repaint when it moves
+  volatile uint32_t version{0};
+  int64_t publishQpc{0}; // QueryPerformanceCounter at the last bump
+
+  // GUI -> DLL requests; settings above are only written by the DLL
+  CommandRing commands{};
+  int publishIntervalMs{0}; // Current tick/publish period
+
+  // Per-hook overhead on the game thread, recorded in place by the detours.
+  // tscTicksPerUs converts the cycle counts for display.
+  HookLatency hookLatency[HOOK_COUNT]{};
+  double tscTicksPerUs{0.0};
+
+  // Overhead governor: hook time per 60 Hz frame, averaged over each tick,
+  // against the budget that moves it between OverheadMode levels
+  int overheadMode{OVERHEAD_FULL};
+  int overheadModeSwitches{0};
+  int overheadBudgetUs{0};
+  double overheadUsPerFrame{0.0};
+
+  // Hook-path allocations that overflowed the per-thread arena to the heap
+  uint32_t arenaHeapAllocations{0};
+
+  // Hook registry: per-hook state (HookState) and how long install took
+  uint8_t hookState[HOOK_COUNT]{};
+  int64_t hookInstallUs{0};
+
+  // Startup timeline: ms from DLL attach to each InitStage, or
+  // INIT_STAGE_PENDING / INIT_STAGE_SKIPPED
+  int32_t initStageMs[INIT_STAGES]{};
+
+  // Items in the mapped DreadmystItems.bin, 0 when it wasn't found
+  uint32_t itemDbItems{0};
+
+  // Name lookups answered by the GameBridge caches vs. sent to ContentMgr
+  int64_t nameCacheHits[NAME_CACHES]{};
+  int64_t nameCacheMisses[NAME_CACHES]{};
+
+  // Loot valued at vendor price. netGold is totalGold + itemValue -
+  // goldSpent; the rates are per hour, indexed by RateHorizon.
+  int64_t itemValue{0};
+  int64_t netGold{0};
+  int64_t lootValueByQuality[6]{};
+  double itemValuePerHour[RATE_HORIZONS]{};
+  double netGoldPerHour[RATE_HORIZONS]{};
+
+  // Session event log: events so far, and sessions archived to disk
+  uint32_t sessionLogEvents{0};
+  uint32_t sessionsArchived{0};
+
+  // Per-mob drop rates, most killed first (dropMobCount are valid). Loot
+  // with no kill inside dropWindowMs counts as unattributed.
+  MobDrops dropMobs[8]{};
+  int32_t dropMobCount{0};
+  int32_t dropWindowMs{0};
+  int64_t dropsUnattributed{0};
+};
+
+// Hash of what a publish shows, so the DLL can skip bumping the version when
+// a tick republished the same data. Left out: the version itself, the
+// command ring (GUI -> DLL), the hook latencies the detours write in place
+// and the TSC calibration that converts them. The session clock counts in
+// whole seconds, as displayed, and the history by its newest second rather
+// than its 140 KB of rings.
+inline uint64_t PublishedContentHash(const SharedTrackerData &data) {
+  constexpr uint64_t K = 0xFF51AFD7ED558CCDull;
+  uint64_t h = 0x9E3779B97F4A7C15ull;
+  auto mix = [&h](uint64_t word) {
+    h = (h ^ word) * K;
+    h ^= h >> 32;
+  };
+  // Four independent lanes per 32 bytes, so the multiplies overlap. Every
+  // step is invertible, so changing any one word always changes the hash.
+  auto range = [&](size_t begin, size_t end) {
+    const uint8_t *p = (const uint8_t *)&data + begin;
+    size_t length = end - begin;
+    uint64_t lane[4] = {h, h + 1, h + 2, h + 3};
+    for (; length >= 32; p += 32, length -= 32) {
+      uint64_t words[4];
+      memcpy(words, p, 32);
+      for (int i = 0; i < 4; i++) {
+        lane[i] = (lane[i] ^ words[i]) * K;
+        lane[i] ^= lane[i] >> 29;
+      }
+    }
+    for (uint64_t l : lane)
+      mix(l);
+    for (; length >= 8; p += 8, length -= 8) {
+      uint64_t word;
+      memcpy(&word, p, 8);
+      mix(word);
+    }
+    uint64_t tail = 0;
+    memcpy(&tail, p, length);
+    mix(tail ^ (uint64_t)length << 56);
+  };
+
+  range(0, offsetof(SharedTrackerData, sessionElapsedMs));
+  mix((uint64_t)(data.sessionElapsedMs / 1000));
+  mix(data.history.perSecond.head);
+  mix((uint64_t)data.history.perSecond.headTime);
+  range(offsetof(SharedTrackerData, publishIntervalMs),
+        offsetof(SharedTrackerData, hookLatency));
+  range(offsetof(SharedTrackerData, overheadMode), sizeof(SharedTrackerData));
+  return h;
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <cstdint>
+#include <utility>
+
+// Small software rasterizer for sparklines. Draws anti-aliased line and area
+// charts into a caller-owned 32-bit pixel buffer (0xAARRGGBB, the layout of
+// a top-down 32bpp DIB), so the GUI can blit a whole chart row with one call.
+// It never allocates and has no platform dependencies.
+class SparklineCanvas {
+public:
+  // A view onto width x height pixels; stride is the buffer's row length in
+  // pixels, so several canvases can share one buffer side by side.
+  SparklineCanvas(uint32_t *pixels, int width, int height, int stride)
+      : m_pixels(pixels), m_width(width), m_height(height), m_stride(stride) {}
+
+  static constexpr uint32_t argb(uint8_t a, uint8_t r, uint8_t g, uint8_t b) {
+    return ((uint32_t)a << 24) | ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
+  }
+
+  void clear(uint32_t color) {
+    for (int y = 0; y < m_height; y++) {
+      uint32_t *row = m_pixels + y * m_stride;
+      for (int x = 0; x < m_width; x++)
+        row[x] = color;
+    }
+  }
+
+  // Filled area under the series. The top pixel of each column is blended by
+  // how much of it lies under the curve. maxValue <= 0 auto-scales.
+  void drawArea(const float *values, int count, float maxValue,
+                uint32_t color) {
+    if (count < 2 || m_width < 2 || m_height < 2)
+      return;
+    float scale = yScale(values, count, maxValue);
+    for (int x = 0; x < m_width; x++) {
+      float yf = (m_height - 1) - sampleAt(values, count, x) * scale;
+      if (yf < 0.0f)
+        yf = 0.0f;
+      int top = (int)yf;
+      float frac = yf - top;
+      plot(x, top, color, 1.0f - frac);
+      for (int y = top + 1; y < m_height; y++)
+        plot(x, y, color, 1.0f);
+    }
+  }
+
+  // Polyline through the series using Wu's anti-aliased lines.
+  void drawLine(const float *values, int count, float maxValue,
+                uint32_t color) {
+    if (count < 2 || m_width < 2 || m_height < 2)
+      return;
+    float scale = yScale(values, count, maxValue);
+    float dx = (float)(m_width - 1) / (count - 1);
+    float prevY = pointY(values[0], scale);
+    for (int i = 1; i < count; i++) {
+      float y = pointY(values[i], scale);
+      wuLine((i - 1) * dx, prevY, i * dx, y, color);
+      prevY = y;
+    }
+  }
+
+private:
+  uint32_t *m_pixels;
+  int m_width;
+  int m_height;
+  int m_stride;
+
+  float yScale(const float *values, int count, float maxValue) const {
+    if (maxValue <= 0.0f) {
+      for (int i = 0; i < count; i++)
+        if (values[i] > maxValue)
+          maxValue = values[i];
+    }
+    return maxValue > 0.0f ? (m_height - 1) / maxValue : 0.0f;
+  }
+
+  float pointY(float value, float scale) const {
+    float y = (m_height - 1) - (value > 0.0f ? value : 0.0f) * scale;
+    return y < 0.0f ? 0.0f : y;
+  }
+
+  // Series value under pixel column x, linearly interpolated
+  float sampleAt(const float *values, int count, int x) const {
+    float t = (float)x * (count - 1) / (m_width - 1);
+    int i = (int)t;
+    if (i >= count - 1)
+      return values[count - 1] > 0.0f ? values[count - 1] : 0.0f;
+    float v = values[i] + (values[i + 1] - values[i]) * (t - i);
+    return v > 0.0f ? v : 0.0f;
+  }
+
+  // Blend color over the pixel at the color's alpha times coverage (0..1)
+  void plot(int x, int y, uint32_t color, float coverage) {
+    if (x < 0 || y < 0 || x >= m_width || y >= m_height || coverage <= 0.0f)
+      return;
+    uint32_t a = (uint32_t)((color >> 24) * coverage + 0.5f);
+    if (a == 0)
+      return;
+    uint32_t &dst = m_pixels[y * m_stride + x];
+    // Weight 0..256 so full coverage replaces the pixel exactly, rounded
+    // rather than truncated so partial coverage doesn't darken
+    a += a >> 7;
+    uint32_t inv = 256 - a;
+    uint32_t rb = (color & 0xFF00FF) * a + (dst & 0xFF00FF) * inv + 0x800080;
+    uint32_t g = (color & 0x00FF00) * a + (dst & 0x00FF00) * inv + 0x008000;
+    dst = 0xFF000000 | (rb >> 8 & 0xFF00FF) | (g >> 8 & 0x00FF00);
+  }
+
+  void wuLine(float x0, float y0, float x1, float y1, uint32_t color) {
+    bool steep = (y1 > y0 ? y1 - y0 : y0 - y1) > (x1 > x0 ? x1 - x0 : x0 - x1);
+    if (steep) {
+      std::swap(x0, y0);
+      std::swap(x1, y1);
+    }
+    if (x0 > x1) {
+      std::swap(x0, x1);
+      std::swap(y0, y1);
+    }
+    float gradient = x1 - x0 > 0.0f ? (y1 - y0) / (x1 - x0) : 1.0f;
+
+    int xStart = (int)(x0 + 0.5f);
+    int xEnd = (int)(x1 + 0.5f);
+    float y = y0 + gradient * (xStart - x0);
+    for (int x = xStart; x <= xEnd; x++) {
+      int iy = y >= 0.0f ? (int)y : (int)y - 1;
+      float frac = y - iy;
+      if (steep) {
+        plot(iy, x, color, 1.0f - frac);
+        plot(iy + 1, x, color, frac);
+      } else {
+        plot(x, iy, color, 1.0f - frac);
+        plot(x, iy + 1, color, frac);
+      }
+      y += gradient;
+    }
+  }
+};
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "HookRegistry.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+// Startup readiness polling. The game may still be unpacking or
+// constructing its singletons when we're injected, so startup polls each
+// condition with a backoff. The clock is a parameter so the harness tests
+// can run a simulated startup: the DLL passes GetTickCount64 and Sleep.
+//
+//   struct Clock {
+//     uint64_t nowMs();
+//     void sleepMs(uint32_t ms);
+//   };
+
+static constexpr uint32_t POLL_FIRST_WAIT_MS = 5;
+static constexpr uint32_t POLL_MAX_WAIT_MS = 250;
+
+// Poll a readiness condition, backing off from 5 ms to 250 ms between
+// checks, until it passes, the deadline goes by or stop is set
+template <typename Clock, typename Check>
+bool PollWithBackoff(Clock &clock, Check ready, uint64_t deadline,
+                     const std::atomic<bool> &stop) {
+  uint32_t waitMs = POLL_FIRST_WAIT_MS;
+  while (!ready()) {
+    if (stop || clock.nowMs() >= deadline)
+      return false;
+    clock.sleepMs(waitMs);
+    waitMs = waitMs * 2 > POLL_MAX_WAIT_MS ? POLL_MAX_WAIT_MS : waitMs * 2;
+  }
+  return true;
+}
+
+// A game global found through an instruction that loads it, "A1 <address>"
+// (mov eax, [address]). The pattern is scanned for until it first matches,
+// then the address is kept, so a poll still waiting on one global doesn't
+// rescan the image for the others.
+struct GlobalSignature {
+  const char *pattern;
+  uint32_t address{0}; // Of the global; 0 until the pattern has matched
+  uint32_t scans{0};   // Image scans so far
+
+  explicit GlobalSignature(const char *pattern) : pattern(pattern) {}
+
+  bool resolve(const uint8_t *base, size_t size) {
+    if (address)
+      return true;
+    scans++;
+    if (const uint8_t *at = FindPattern(base, size, pattern))
+      memcpy(&address, at + 1, sizeof(address));
+    return address != 0;
+  }
+};
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <cstdint>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <atomic>
+#include <climits>
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Publish-to-reader wakeup. The DLL signals after each publish that changed
+// the shared data; the GUI blocks until then instead of polling. Signals
+// coalesce like an auto-reset event: several publishes before the reader
+// wakes give it one wakeup.
+//
+// On Windows this is the named auto-reset event, and the GUI waits on
+// handle() together with its window messages. Elsewhere it's a futex on a
+// 32-bit counter that both sides map shared, so the tests can measure the
+// wake latency on Linux.
+enum NotifyWait { NOTIFY_SIGNALED, NOTIFY_TIMEOUT, NOTIFY_FAILED };
+
+class UpdateNotifier {
+public:
+  UpdateNotifier() = default;
+  ~UpdateNotifier() { close(); }
+  UpdateNotifier(const UpdateNotifier &) = delete;
+  UpdateNotifier &operator=(const UpdateNotifier &) = delete;
+
+#ifdef _WIN32
+  // Signaling side: creates the event (or opens it if it already exists)
+  bool create(const char *name) {
+    close();
+    m_event = CreateEventA(nullptr, FALSE, FALSE, name);
+    return m_event != nullptr;
+  }
+
+  // Waiting side: opens the event the DLL created
+  bool open(const char *name) {
+    close();
+    m_event = OpenEventA(SYNCHRONIZE, FALSE, name);
+    return m_event != nullptr;
+  }
+
+  // For MsgWaitForMultipleObjects; nullptr when not open
+  HANDLE handle() const { return m_event; }
+#else
+  // `word` lives in memory both sides map (MAP_SHARED), so the futex is
+  // shared between processes. A waiter only wakes for signals after attach.
+  bool attach(std::atomic<uint32_t> *word) {
+    close();
+    m_word = word;
+    if (m_word)
+      m_seen = m_word->load(std::memory_order_acquire);
+    return m_word != nullptr;
+  }
+#endif
+
+  bool valid() const {
+#ifdef _WIN32
+    return m_event != nullptr;
+#else
+    return m_word != nullptr;
+#endif
+  }
+
+  void signal() {
+#ifdef _WIN32
+    if (m_event)
+      SetEvent(m_event);
+#else
+    if (!m_word)
+      return;
+    m_word->fetch_add(1, std::memory_order_release);
+    syscall(SYS_futex, (uint32_t *)m_word, FUTEX_WAKE, INT_MAX, nullptr,
+            nullptr, 0);
+#endif
+  }
+
+  // Block until a signal since the last wakeup, or timeoutMs passes
+  NotifyWait wait(uint32_t timeoutMs) {
+#ifdef _WIN32
+    if (!m_event)
+      return NOTIFY_FAILED;
+    DWORD result = WaitForSingleObject(m_event, timeoutMs);
+    if (result == WAIT_OBJECT_0)
+      return NOTIFY_SIGNALED;
+    return result == WAIT_TIMEOUT ? NOTIFY_TIMEOUT : NOTIFY_FAILED;
+#else
+    if (!m_word)
+      return NOTIFY_FAILED;
+    uint64_t deadline = nowNs() + (uint64_t)timeoutMs * 1000000;
+    for (;;) {
+      uint32_t current = m_word->load(std::memory_order_acquire);
+      if (current != m_seen) {
+        m_seen = current;
+        return NOTIFY_SIGNALED;
+      }
+      uint64_t now = nowNs();
+      if (now >= deadline)
+        return NOTIFY_TIMEOUT;
+      timespec left = {(time_t)((deadline - now) / 1000000000),
+                       (long)((deadline - now) % 1000000000)};
+      // Sleeps only while the counter still holds the value we've seen;
+      // EAGAIN (it moved) and EINTR both just recheck
+      syscall(SYS_futex, (uint32_t *)m_word, FUTEX_WAIT, current, &left,
+              nullptr, 0);
+    }
+#endif
+  }
+
+  void close() {
+#ifdef _WIN32
+    if (m_event)
+      CloseHandle(m_event);
+    m_event = nullptr;
+#else
+    m_word = nullptr;
+#endif
+  }
+
+private:
+#ifdef _WIN32
+  HANDLE m_event{nullptr};
+#else
+  static uint64_t nowNs() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + (uint64_t)ts.tv_nsec;
+  }
+
+  std::atomic<uint32_t> *m_word{nullptr};
+  uint32_t m_seen{0}; // Counter value at this waiter's last wakeup
+#endif
+};
@@ -1,10 +1,17 @@
 #define _CRT_SECURE_NO_WARNINGS
 #include "DreadmystTracker.h"
+#include "ChatLine.h"
+#include "OverheadGovernor.h"
+#include "SessionArchive.h"
 #include <MinHook.h>
 #include <chrono>
+#include <cmath>
+#include <ctime>
+#include <intrin.h>
+#include <mutex>
 #include <psapi.h>
-#include <regex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <windows.h>
 
@@ -20,22 +27,21 @@ public:
     return instance;
   }
 
-  // Parse a chat message and update tracker stats
-  void parseMessage(const std::string &message) {
+  // Parse a chat message and update tracker stats. Names stay views into
+  // the message until they're copied into arena or tracker storage.
+  void parseMessage(const char *message) {
     if (!g_trackerInstance)
       return;
 
-    // Parse "You receive: [Item Name]" or "You receive: [Item Name] xN"
-    parseLootMessage(message);
-
-    // Parse "You gained X experience" or similar
-    parseExpMessage(message);
-
-    // Parse kill messages (varies by game)
-    parseKillMessage(message);
-
-    // Parse gold messages
-    parseGoldMessage(message);
+    ChatLineEvents events = ParseChatEvents(message);
+    if (events.loot)
+      onLoot(events.lootName, events.lootAmount);
+    if (events.exp)
+      g_trackerInstance->notifyExpGained(events.expAmount);
+    if (events.kill)
+      g_trackerInstance->notifyMobKilled(events.killName, 0);
+    if (events.gold)
+      g_trackerInstance->notifyGoldChanged(events.goldAmount);
   }
 
   void setTracker(Tracker *tracker) { g_trackerInstance = tracker; }
@@ -44,93 +50,47 @@ private:
   ChatParser() = default;
   Tracker *g_trackerInstance = nullptr;
 
-  void parseLootMessage(const std::string &msg) {
-    // Pattern: "You receive: [Item] xN" or "You receive: [Item]"
-    // Also handles: "You receive: [Gold] x5"
-    static std::regex lootRegex(R"(You receive:\s*\[([^\]]+)\](?:\s*x(\d+))?)",
-                                std::regex::icase);
-
-    std::smatch match;
-    if (std::regex_search(msg, match, lootRegex)) {
-      std::string itemName = match[1].str();
-      int amount = 1;
-      if (match[2].matched) {
-        amount = std::stoi(match[2].str());
-      }
-
-      // Check if it's gold
-      if (itemName == "Gold" || itemName == "gold") {
-        g_trackerInstance->notifyGoldChanged(amount);
-      } else {
-        // Create loot entry
-        LootEntry entry;
-        entry.itemName = itemName;
-        entry.amount = amount;
-        entry.quality = guessQuality(itemName);
-        entry.timestamp =
-            std::chrono::duration_cast<std::chrono::milliseconds>(
-                std::chrono::system_clock::now().time_since_epoch())
-                .count();
-        g_trackerInstance->notifyLootReceived(entry);
-      }
-    }
-  }
-
-  void parseExpMessage(const std::string &msg) {
-    // Pattern: "You gained X experience" or "You gain X exp" or "+X XP"
-    static std::regex expRegex(
-        R"((?:You (?:gained?|received?)|got|\+)\s*(\d+)\s*(?:experience|exp|xp))",
-        std::regex::icase);
-
-    std::smatch match;
-    if (std::regex_search(msg, match, expRegex)) {
-      int exp = std::stoi(match[1].str());
-      g_trackerInstance->notifyExpGained(exp);
-    }
-  }
-
-  void parseKillMessage(const std::string &msg) {
-    // Pattern: "You killed [Monster Name]" or "You have slain [Name]"
-    // Also: "[Monster] has been defeated"
-    static std::regex killRegex(
-        R"((?:You (?:killed?|slain|defeated)|has been defeated)\s*(?:\[([^\]]+)\]|(\w+)))",
-        std::regex::icase);
-
-    std::smatch match;
-    if (std::regex_search(msg, match, killRegex)) {
-      std::string mobName = match[1].matched ? match[1].str() : match[2].str();
-      g_trackerInstance->notifyMobKilled(mobName, 0);
+  void onLoot(std::string_view itemName, int amount) {
+    // Check if it's gold
+    if (itemName == "Gold" || itemName == "gold") {
+      g_trackerInstance->notifyGoldChanged(amount);
+      return;
     }
-  }
-
-  void parseGoldMessage(const std::string &msg) {
-    // Pattern: "You received X Gold" (separate from loot format)
-    static std::regex goldRegex(
-        R"((?:You (?:received?|got|looted))\s*(\d+)\s*(?:Gold|gold|coins?))",
-        std::regex::icase);
 
-    std::smatch match;
-    if (std::regex_search(msg, match, goldRegex)) {
-      int gold = std::stoi(match[1].str());
-      g_trackerInstance->notifyGoldChanged(gold);
+    // Create loot entry
+    LootEntry entry(HookArena::resource());
+    entry.itemName.assign(itemName.data(), itemName.size());
+    entry.amount = amount;
+    const ItemDbRecord *record = GameBridge::getInstance().findItemByName(
+        itemName.data(), itemName.size());
+    if (record) {
+      entry.item.m_itemId = record->id;
+      entry.quality = (ItemQuality)record->quality;
+    } else {
+      entry.quality = guessQuality(itemName);
     }
+    entry.timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
+                          std::chrono::system_clock::now().time_since_epoch())
+                          .count();
+    g_trackerInstance->notifyLootReceived(entry);
   }
 
-  // Guess item quality based on name (color codes in name, or keywords)
-  ItemQuality guessQuality(const std::string &itemName) {
+  // Guess item quality based on name (color codes in name, or keywords) for
+  // items the item table doesn't know
+  ItemQuality guessQuality(std::string_view itemName) {
     // Check for common quality indicators in item names
-    if (itemName.find("Legendary") != std::string::npos ||
-        itemName.find("Divine") != std::string::npos)
+    if (itemName.find("Legendary") != std::string_view::npos ||
+        itemName.find("Divine") != std::string_view::npos)
       return ItemQuality::QualityLv5;
-    if (itemName.find("Epic") != std::string::npos ||
-        itemName.find("Imperial") != std::string::npos)
+    if (itemName.find("Epic") != std::string_view::npos ||
+        itemName.find("Imperial") != std::string_view::npos)
       return ItemQuality::QualityLv4;
-    if (itemName.find("Rare") != std::string::npos ||
-        itemName.find("Holy") != std::string::npos)
+    if (itemName.find("Rare") != std::string_view::npos ||
+        itemName.find("Holy") != std::string_view::npos)
       return ItemQuality::QualityLv3;
-    if (itemName.find("Uncommon") != std::string::npos ||
-        itemName.find("Large") != std::string::npos ||
-        itemName.find("Curious") != std::string::npos)
+    if (itemName.find("Uncommon") != std::string_view::npos ||
+        itemName.find("Large") != std::string_view::npos ||
+        itemName.find("Curious") != std::string_view::npos)
       return ItemQuality::QualityLv2;
     return ItemQuality::QualityLv1; // Common
   }
@@ -153,7 +113,8 @@ void __fastcall HookedAddMessage(void *thisPtr, void *edx, const char *message,
 
   // Parse the message for tracking
   if (message) {
-    ChatParser::getInstance().parseMessage(std::string(message));
+    HookArenaScope arenaScope;
+    ChatParser::getInstance().parseMessage(message);
   }
 }
 
@@ -198,43 +159,27 @@ void *ScanPattern(const char *pattern) {
     return nullptr;
   }
 
-  uint8_t *base = (uint8_t *)info.lpBaseOfDll;
-  size_t size = info.SizeOfImage;
-
-  // Parse pattern string into bytes
-  std::vector<std::pair<uint8_t, bool>> bytes;
-  const char *p = pattern;
-  while (*p) {
-    while (*p == ' ')
-      p++;
-    if (!*p)
-      break;
-
-    if (*p == '?') {
-      bytes.push_back({0, true}); // wildcard
-      while (*p == '?')
-        p++;
-    } else {
-      char hex[3] = {p[0], p[1], 0};
-      bytes.push_back({(uint8_t)strtol(hex, nullptr, 16), false});
-      p += 2;
-    }
-  }
-
-  // Scan
-  for (size_t i = 0; i < size - bytes.size(); i++) {
-    bool match = true;
-    for (size_t j = 0; j < bytes.size(); j++) {
-      if (!bytes[j].second && base[i + j] != bytes[j].first) {
-        match = false;
-        break;
-      }
-    }
-    if (match)
-      return base + i;
-  }
+  return (void *)FindPattern((const uint8_t *)info.lpBaseOfDll,
+                             info.SizeOfImage, pattern);
+}
 
-  return nullptr;
+// Full path of `name` in the directory this DLL was loaded from (not the
+// game's). Our data files and archives live next to the DLL.
+static bool PathNextToModule(const char *name, char (&path)[MAX_PATH]) {
+  HMODULE self = nullptr;
+  if (!GetModuleHandleExA(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS |
+                              GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
+                          (LPCSTR)&PathNextToModule, &self))
+    return false;
+  DWORD len = GetModuleFileNameA(self, path, MAX_PATH);
+  if (len == 0 || len >= MAX_PATH)
+    return false;
+  char *slash = strrchr(path, '\\');
+  size_t dirLen = slash ? (size_t)(slash - path + 1) : 0;
+  if (dirLen + strlen(name) >= MAX_PATH)
+    return false;
+  strcpy(path + dirLen, name);
+  return true;
 }
 
 //=============================================================================
@@ -245,22 +190,68 @@ GameBridge &GameBridge::getInstance() {
   return instance;
 }
 
-bool GameBridge::initialize() {
-  // Find sApplication
-  void *appPattern = ScanPattern(PATTERN_APPLICATION);
-  if (appPattern) {
-    // The pattern points to: mov eax, [address]
-    // So we read the address from offset 1
-    m_application = *(void **)((uint8_t *)appPattern + 1);
-  }
+GameBridge::GameBridge()
+    : m_applicationSig(PATTERN_APPLICATION),
+      m_contentMgrSig(PATTERN_CONTENTMGR) {}
+
+bool GameBridge::isModuleMapped() {
+  HMODULE mod = GetModuleHandle(nullptr);
+  MODULEINFO info;
+  return mod &&
+         GetModuleInformation(GetCurrentProcess(), mod, &info, sizeof(info)) &&
+         info.SizeOfImage > 0;
+}
+
+bool GameBridge::resolveSignatures() {
+  if (m_application && m_contentMgr)
+    return true;
+  MODULEINFO info;
+  if (!GetModuleInformation(GetCurrentProcess(), GetModuleHandle(nullptr),
+                            &info, sizeof(info)))
+    return false;
+  // Each pattern points at mov eax, [address]; one that has matched isn't
+  // scanned for again while the other is still missing
+  auto base = (const uint8_t *)info.lpBaseOfDll;
+  if (m_applicationSig.resolve(base, info.SizeOfImage))
+    m_application = (void *)(uintptr_t)m_applicationSig.address;
+  if (m_contentMgrSig.resolve(base, info.SizeOfImage))
+    m_contentMgr = (void *)(uintptr_t)m_contentMgrSig.address;
+  return m_application && m_contentMgr;
+}
 
-  // Find sContentMgr similarly
-  void *cmPattern = ScanPattern(PATTERN_CONTENTMGR);
-  if (cmPattern) {
-    m_contentMgr = *(void **)((uint8_t *)cmPattern + 1);
+bool GameBridge::singletonsReady() {
+  // The patterns give the address of each singleton pointer; the game fills
+  // them in while it starts up
+  if (!m_application || !m_contentMgr)
+    return false;
+  __try {
+    return *(void *volatile *)m_application != nullptr &&
+           *(void *volatile *)m_contentMgr != nullptr;
+  } __except (EXCEPTION_EXECUTE_HANDLER) {
+    return false;
   }
+}
 
-  return m_application != nullptr;
+void GameBridge::checkContentReload() {
+  if (!m_contentMgr)
+    return;
+  void *contentMgr;
+  __try {
+    contentMgr = *(void *volatile *)m_contentMgr;
+  } __except (EXCEPTION_EXECUTE_HANDLER) {
+    return;
+  }
+  if (contentMgr != m_cachedContentMgr) {
+    // A new ContentMgr means reloaded tables; cached names may be stale
+    m_cachedContentMgr = contentMgr;
+    m_npcNames.invalidate();
+    m_itemNames.invalidate();
+    m_levelTable.clear();
+    if (contentMgr) {
+      for (int level = 1; level < LEVEL_TABLE_SIZE; level++)
+        m_levelTable.set(level, queryLevelExp(level));
+    }
+  }
 }
 
 World *GameBridge::getWorld() {
@@ -295,17 +286,106 @@ int GameBridge::getPlayerLevel() { return 0; }
 int GameBridge::getPlayerExp() { return 0; }
 int GameBridge::getPlayerGold() { return 0; }
 
-std::string GameBridge::getItemName(uint16_t itemId) {
-  // In the game this is: sContentMgr->db("item_template").data(itemId, "name")
-  // We can call this directly!
-  return "Unknown Item";
+bool GameBridge::loadItemDatabase() {
+  if (m_itemDb.loaded())
+    return true;
+
+  char path[MAX_PATH];
+  if (!PathNextToModule(ITEM_DB_FILE_NAME, path))
+    return false;
+
+  m_itemDbFile = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr,
+                             OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (m_itemDbFile == INVALID_HANDLE_VALUE)
+    return false;
+
+  LARGE_INTEGER size;
+  if (GetFileSizeEx(m_itemDbFile, &size) && size.QuadPart > 0 &&
+      size.QuadPart < 0x10000000) {
+    m_itemDbMapping = CreateFileMappingA(m_itemDbFile, nullptr, PAGE_READONLY,
+                                         0, 0, nullptr);
+    if (m_itemDbMapping)
+      m_itemDbView = MapViewOfFile(m_itemDbMapping, FILE_MAP_READ, 0, 0, 0);
+    if (m_itemDbView && m_itemDb.attach(m_itemDbView, (size_t)size.QuadPart))
+      return true;
+  }
+
+  unloadItemDatabase();
+  return false;
+}
+
+void GameBridge::unloadItemDatabase() {
+  m_itemDb.detach();
+  if (m_itemDbView) {
+    UnmapViewOfFile(m_itemDbView);
+    m_itemDbView = nullptr;
+  }
+  if (m_itemDbMapping) {
+    CloseHandle(m_itemDbMapping);
+    m_itemDbMapping = nullptr;
+  }
+  if (m_itemDbFile != INVALID_HANDLE_VALUE) {
+    CloseHandle(m_itemDbFile);
+    m_itemDbFile = INVALID_HANDLE_VALUE;
+  }
+}
+
+std::string GameBridge::queryContentName(const char *table, int key) {
+  // In the game this is: sContentMgr->db(table).data(key, "name") - a string
+  // lookup of the table, then of the row. Empty until we have the offsets.
+  return std::string();
+}
+
+uint32_t GameBridge::queryLevelExp(int level) {
+  // sContentMgr->db("exp_table").data(level, "exp"); 0 until we have the
+  // offsets, which leaves the level projection unknown
+  return 0;
+}
+
+const char *GameBridge::getItemName(uint16_t itemId, const char *fallback) {
+  // The offline table answers without touching game memory; ContentMgr is
+  // only asked (through the cache) for items it doesn't know
+  if (const ItemDbRecord *record = m_itemDb.findById(itemId))
+    return m_itemDb.nameOf(*record);
+  const char *name = m_itemNames.get(itemId, [this](uint32_t id) {
+    return queryContentName("item_template", (int)id);
+  });
+  return name ? name : fallback;
+}
+
+const char *GameBridge::getNpcName(int entry, const char *fallback) {
+  const char *name = m_npcNames.get((uint32_t)entry, [this](uint32_t key) {
+    return queryContentName("npc_template", (int)key);
+  });
+  return name ? name : fallback;
+}
+
+int64_t GameBridge::nameCacheHits(NameCacheId cache) const {
+  return cache == NAME_CACHE_NPC ? m_npcNames.hits() : m_itemNames.hits();
+}
+
+int64_t GameBridge::nameCacheMisses(NameCacheId cache) const {
+  return cache == NAME_CACHE_NPC ? m_npcNames.misses() : m_itemNames.misses();
 }
 
 ItemQuality GameBridge::getItemQuality(uint16_t itemId) {
   // sContentMgr->db("item_template").data(itemId, "quality")
+  if (const ItemDbRecord *record = m_itemDb.findById(itemId))
+    return (ItemQuality)record->quality;
   return ItemQuality::QualityLv1;
 }
 
+uint32_t GameBridge::getItemValue(uint16_t itemId) {
+  // sContentMgr->db("item_template").data(itemId, "sell_price")
+  const ItemDbRecord *record = m_itemDb.findById(itemId);
+  return record ? record->vendorValue : 0;
+}
+
+const ItemDbRecord *GameBridge::findItemByName(const char *name,
+                                               size_t length) const {
+  return m_itemDb.findByName(name, length);
+}
+
 bool GameBridge::isInParty() {
   // Would check World::m_party or similar
   return false;
@@ -352,9 +432,70 @@ static OrigRecvMsg_t g_origRecvMsg = nullptr;
 // Forward declaration for chat filter access
 static SharedTrackerData *g_sharedData = nullptr;
 
+// Guards the chat filter/rate limit settings in g_sharedData: recvMsg reads
+// them shared, command processing writes them exclusive
+static SRWLOCK g_chatSettingsLock = SRWLOCK_INIT;
+
 // Static tracker reference for hooks (Must be declared before hooks)
 static Tracker *g_trackerInstance = nullptr;
 
+
+//=============================================================================
+// Overhead modes - Work deferred while OverheadGovernor sheds load
+//=============================================================================
+
+// Chat lines that addLine copies out in the cheaper modes, to be parsed on
+// the tick instead of the game thread. Single producer (the game thread),
+// single consumer (the tick).
+class DeferredChatLines {
+public:
+  static DeferredChatLines &getInstance() {
+    static DeferredChatLines instance;
+    return instance;
+  }
+
+  // False when the queue is full or the line too long; parse it inline then
+  bool push(const char *line) {
+    size_t len = strlen(line);
+    uint32_t head = m_head.load(std::memory_order_relaxed);
+    if (len >= LINE_LENGTH ||
+        head - m_tail.load(std::memory_order_acquire) >= CAPACITY)
+      return false;
+    memcpy(m_lines[head % CAPACITY], line, len + 1);
+    m_head.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  template <typename Fn> void drain(Fn &&parse) {
+    uint32_t tail = m_tail.load(std::memory_order_relaxed);
+    uint32_t head = m_head.load(std::memory_order_acquire);
+    for (; tail != head; tail++) {
+      parse(m_lines[tail % CAPACITY]);
+      m_tail.store(tail + 1, std::memory_order_release);
+    }
+  }
+
+private:
+  DeferredChatLines() = default;
+
+  static constexpr uint32_t CAPACITY = 64;
+  static constexpr size_t LINE_LENGTH = 256;
+
+  char m_lines[CAPACITY][LINE_LENGTH];
+  std::atomic<uint32_t> m_head{0};
+  std::atomic<uint32_t> m_tail{0};
+};
+
+// Hook overhead timing. Each detour reads the TSC on entry and exit and
+// subtracts the cycles spent inside the original game function, so only our
+// own work lands in the per-hook histogram.
+static void RecordHookCycles(HookId hook, uint64_t cycles) {
+  OverheadGovernor::getInstance().addCycles(cycles);
+  if (g_sharedData)
+    g_sharedData->hookLatency[hook].cycles.record(
+        cycles > 0xFFFFFFFF ? 0xFFFFFFFF : (uint32_t)cycles);
+}
+
 // Function pointer
 typedef void(__thiscall *OrigSpentGold_t)(void *thisPtr, void *data);
 static OrigSpentGold_t g_origSpentGold = nullptr;
@@ -378,9 +519,14 @@ static OrigCombatMsg_t g_origCombatMsg = nullptr;
 // The packet contains: targetGuid, casterGuid, amount, spellId, etc.
 // We read the amount from the packet data buffer
 void __fastcall HookedCombatMsg(void *thisPtr, void *edx, void *data) {
+  uint64_t hookStart = __rdtsc();
+  uint64_t origCycles = 0;
+
   // Call original first
   if (g_origCombatMsg) {
+    uint64_t origStart = __rdtsc();
     g_origCombatMsg(thisPtr, data);
+    origCycles = __rdtsc() - origStart;
   }
 
   // Parse damage from the packet data
@@ -393,40 +539,88 @@ void __fastcall HookedCombatMsg(void *thisPtr, void *edx, void *data) {
     // Offset 4: casterGuid (int32)
     // Offset 8: amount (int32) - negative = damage, positive = heal
     // This is a simplification - actual offsets may differ
+    // Offset 12: spellId (int32)
     int32_t *packetData = (int32_t *)data;
+    int32_t targetGuid = packetData[0];
     int32_t amount = packetData[2]; // Approximate offset for m_amount
+    int32_t spellId = packetData[3];
 
-    // If amount is negative, it's damage dealt
+    // If amount is negative, it's damage dealt; positive is healing
     if (amount < 0) {
       int damage = -amount;
-      g_trackerInstance->notifyDamageDealt(damage);
+      g_trackerInstance->notifyDamageDealt(damage, targetGuid, spellId);
+    } else if (amount > 0) {
+      g_trackerInstance->notifyHealingDone(amount, spellId);
     }
   }
-}
 
-// Global debug string for GUI display
-static char g_debugText[512] = "Waiting for exp event...";
-static int g_expEventCount = 0;
+  RecordHookCycles(HOOK_COMBAT_MSG, __rdtsc() - hookStart - origCycles);
+}
 
 void __fastcall HookedExpNotify(void *thisPtr, void *edx, void *data) {
+  uint64_t hookStart = __rdtsc();
+  uint64_t origCycles = 0;
+
   // Call original first
   if (g_origExpNotify) {
+    uint64_t origStart = __rdtsc();
     g_origExpNotify(thisPtr, data);
+    origCycles = __rdtsc() - origStart;
   }
 
   // Count mob kills (exp is tracked via addLine hook)
-  g_expEventCount++;
   if (g_trackerInstance) {
+    // The packet's npc entry offset isn't confirmed yet, so the kill isn't
+    // named through getNpcName
+    HookArenaScope arenaScope;
     g_trackerInstance->notifyMobKilled("Enemy", 0);
   }
+
+  RecordHookCycles(HOOK_EXP_NOTIFY, __rdtsc() - hookStart - origCycles);
+}
+
+// Exp, loot and gold-spent messages from a chat line. Runs in addLine, or on
+// the tick for lines the overhead governor deferred.
+static void ParseChatLine(const char *strPtr) {
+  if (!g_trackerInstance)
+    return;
+  AddLineEvents events = ParseAddLine(strPtr);
+
+  if (events.expAmount > 0)
+    g_trackerInstance->notifyExpGained(events.expAmount);
+
+  if (events.loot) {
+    if (events.lootIsGold) {
+      g_trackerInstance->notifyGoldChanged(events.lootAmount);
+    } else {
+      // Chat only carries the name; the item table maps it back to an id
+      const ItemDbRecord *record = GameBridge::getInstance().findItemByName(
+          events.lootName.data(), events.lootName.size());
+      LootEntry entry(HookArena::resource());
+      entry.item.m_itemId = record ? record->id : 0;
+      entry.itemName.assign(events.lootName.data(), events.lootName.size());
+      entry.quality =
+          record ? (ItemQuality)record->quality : ItemQuality::QualityLv1;
+      entry.amount = events.lootAmount;
+      g_trackerInstance->notifyLootReceived(entry);
+    }
+  }
+
+  if (events.goldSpent > 0)
+    g_trackerInstance->notifyGoldSpent(events.goldSpent);
 }
 
 // Hook for GameChat::addLine - parses exp from chat strings
 void __fastcall HookedAddLine(void *thisPtr, void *edx, void *strBuf,
                               int channel, void *linkedItem) {
+  uint64_t hookStart = __rdtsc();
+  uint64_t origCycles = 0;
+
   // Call original first
   if (g_origAddLine) {
+    uint64_t origStart = __rdtsc();
     g_origAddLine(thisPtr, strBuf, channel, linkedItem);
+    origCycles = __rdtsc() - origStart;
   }
 
   // Try to extract string from the std::string buffer
@@ -449,90 +643,279 @@ void __fastcall HookedAddLine(void *thisPtr, void *edx, void *strBuf,
 
     if (strPtr && (uintptr_t)strPtr > 0x10000 &&
         (uintptr_t)strPtr < 0x7FFFFFFF) {
-      // Check for exp message: "You gained X experience"
-      if (strstr(strPtr, "You gained") && strstr(strPtr, "experience")) {
-        // Parse the number: "You gained %d experience"
-        int expAmount = 0;
-        const char *numStart = strPtr + 11; // Skip "You gained "
-        while (*numStart && (*numStart < '0' || *numStart > '9'))
-          numStart++;
-        while (*numStart >= '0' && *numStart <= '9') {
-          expAmount = expAmount * 10 + (*numStart - '0');
-          numStart++;
-        }
-
-        if (expAmount > 0 && g_trackerInstance) {
-          g_trackerInstance->notifyExpGained(expAmount);
-          sprintf(g_debugText, "Exp gained: %d\nTotal events: %d", expAmount,
-                  g_expEventCount);
-        }
+      if (OverheadGovernor::getInstance().mode() == OVERHEAD_FULL ||
+          !DeferredChatLines::getInstance().push(strPtr)) {
+        HookArenaScope arenaScope;
+        ParseChatLine(strPtr);
       }
+    }
+  }
 
-      // Check for loot message: "You receive: [ItemName]" or "[Player]
-      // received: [ItemName]"
-      const char *receivePos = strstr(strPtr, "receive: [");
-      if (receivePos && g_trackerInstance) {
-        // Find the brackets to extract item name
-        const char *nameStart = strstr(receivePos, "[");
-        const char *nameEnd = strstr(nameStart ? nameStart + 1 : nullptr, "]");
-
-        if (nameStart && nameEnd && nameEnd > nameStart) {
-          nameStart++; // Skip [
-          char itemName[64] = {0};
-          int len = (int)(nameEnd - nameStart);
-          if (len > 63)
-            len = 63;
-          strncpy(itemName, nameStart, len);
-          itemName[len] = '\0';
-
-          // Check for amount " xN" after the ]
-          int amount = 1;
-          const char *amtPos = strstr(nameEnd, " x");
-          if (amtPos) {
-            amount = atoi(amtPos + 2);
-            if (amount < 1)
-              amount = 1;
-          }
+  RecordHookCycles(HOOK_ADD_LINE, __rdtsc() - hookStart - origCycles);
+}
 
-          // Check if it's gold
-          if (strstr(itemName, "Gold") || strstr(itemName, "gold")) {
-            g_trackerInstance->notifyGoldChanged(amount);
-            sprintf(g_debugText, "Gold: +%d\nExp events: %d", amount,
-                    g_expEventCount);
-          } else {
-            LootEntry entry;
-            entry.item.m_itemId = 0;
-            entry.itemName = itemName;
-            entry.quality = ItemQuality::QualityLv1;
-            entry.amount = amount;
-            g_trackerInstance->notifyLootReceived(entry);
-            sprintf(g_debugText, "Loot: %s x%d\nExp events: %d", itemName,
-                    amount, g_expEventCount);
-          }
-        }
+// Pull the character data out of a game-side std::string.
+// MSVC layout: 16-byte SSO buffer (or heap pointer), size, capacity at +20.
+// Returns nullptr if the pointer doesn't look like user-mode memory.
+static const char *ReadGameString(void *strBuf) {
+  if (!strBuf)
+    return nullptr;
+
+  uint32_t *ssoBuf = (uint32_t *)strBuf;
+  uint32_t capacity = ssoBuf[5];
+
+  const char *strPtr =
+      capacity < 16 ? (const char *)strBuf : *(const char **)strBuf;
+
+  if (strPtr && (uintptr_t)strPtr > 0x10000 &&
+      (uintptr_t)strPtr < 0x7FFFFFFF) {
+    return strPtr;
+  }
+  return nullptr;
+}
+
+//=============================================================================
+// Chat Rate Limiter - Per-sender token buckets for trade chat floods
+//=============================================================================
+class ChatRateLimiter {
+public:
+  static ChatRateLimiter &getInstance() {
+    static ChatRateLimiter instance;
+    return instance;
+  }
+
+  // Take a token from the sender's bucket. Returns true if the sender is over
+  // the limit and the message should be dropped.
+  bool shouldThrottle(const char *sender, int perMinute, int burst,
+                      uint64_t nowMs) {
+    if (perMinute <= 0)
+      perMinute = DEFAULT_PER_MINUTE;
+    if (burst <= 0)
+      burst = DEFAULT_BURST;
+
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    int idx = findOrInsert(sender);
+    Entry &e = m_entries[idx];
+    touch(idx);
+
+    // Refill based on time since the sender's last message
+    double elapsed = (double)(nowMs - e.lastRefillMs);
+    e.lastRefillMs = nowMs;
+    e.tokens += elapsed * perMinute / 60000.0;
+    if (e.tokens > burst)
+      e.tokens = burst;
+
+    if (e.tokens >= 1.0) {
+      e.tokens -= 1.0;
+      return false;
+    }
+
+    e.throttled++;
+    m_totalThrottled++;
+    return true;
+  }
+
+  // Rate-limit how often the throttle table is copied out during a flood
+  bool publishDue(uint64_t nowMs) {
+    if (nowMs - m_lastPublishMs < PUBLISH_INTERVAL_MS)
+      return false;
+    m_lastPublishMs = nowMs;
+    return true;
+  }
+
+  // Copy the total and the worst offenders into shared memory
+  void publish(SharedTrackerData *shared) {
+    if (!shared)
+      return;
+
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    constexpr int TOP = sizeof(shared->throttledSenders) /
+                        sizeof(shared->throttledSenders[0]);
+    int top[TOP];
+    int topCount = 0;
+
+    // Partial insertion sort - table is small and this runs a few times a sec
+    for (int i = 0; i < CAPACITY; i++) {
+      if (!m_entries[i].used || m_entries[i].throttled == 0)
+        continue;
+      int pos = topCount < TOP ? topCount++ : TOP;
+      while (pos > 0 &&
+             m_entries[top[pos - 1]].throttled < m_entries[i].throttled) {
+        if (pos < TOP)
+          top[pos] = top[pos - 1];
+        pos--;
+      }
+      if (pos < TOP)
+        top[pos] = i;
+    }
+
+    shared->chatThrottledTotal = m_totalThrottled;
+    for (int i = 0; i < TOP; i++) {
+      auto &dst = shared->throttledSenders[i];
+      if (i < topCount) {
+        strncpy(dst.name, m_entries[top[i]].name, sizeof(dst.name) - 1);
+        dst.name[sizeof(dst.name) - 1] = '\0';
+        dst.throttled = m_entries[top[i]].throttled;
+      } else {
+        dst.name[0] = '\0';
+        dst.throttled = 0;
       }
+    }
+  }
 
-      // Check for gold spent: "You spent X Gold"
-      const char *spentPos = strstr(strPtr, "You spent ");
-      if (spentPos && strstr(spentPos, " Gold") && g_trackerInstance) {
-        int goldSpent = atoi(spentPos + 10); // Skip "You spent "
-        if (goldSpent > 0) {
-          g_trackerInstance->notifyGoldSpent(goldSpent);
-          sprintf(g_debugText, "Gold spent: -%d\nExp: %d", goldSpent,
-                  g_expEventCount);
-        }
+  void reset() {
+    std::lock_guard<std::mutex> lock(m_lock);
+    clear();
+  }
+
+private:
+  ChatRateLimiter() { clear(); }
+
+  static constexpr int CAPACITY = 128;    // Tracked senders (LRU evicted)
+  static constexpr int HASH_BUCKETS = 256; // Power of two
+  static constexpr int DEFAULT_PER_MINUTE = 20;
+  static constexpr int DEFAULT_BURST = 5;
+  static constexpr uint64_t PUBLISH_INTERVAL_MS = 250;
+
+  struct Entry {
+    char name[32];
+    uint32_t hash;
+    double tokens;
+    uint64_t lastRefillMs;
+    int throttled;
+    int16_t nextInBucket; // Hash chain
+    int16_t lruPrev;      // Towards most recently used
+    int16_t lruNext;      // Towards least recently used
+    bool used;
+  };
+
+  Entry m_entries[CAPACITY];
+  int16_t m_buckets[HASH_BUCKETS];
+  int16_t m_lruHead{-1}; // Most recently used
+  int16_t m_lruTail{-1}; // Eviction candidate
+  int m_used{0};
+  int64_t m_totalThrottled{0};
+  uint64_t m_lastPublishMs{0};
+  std::mutex m_lock;
+
+  static uint32_t hashName(const char *s) {
+    // FNV-1a, case-insensitive so "Bob" and "bob" share a bucket
+    uint32_t h = 2166136261u;
+    for (; *s; s++) {
+      h ^= (uint8_t)tolower((uint8_t)*s);
+      h *= 16777619u;
+    }
+    return h;
+  }
+
+  void clear() {
+    memset(m_entries, 0, sizeof(m_entries));
+    for (int i = 0; i < HASH_BUCKETS; i++)
+      m_buckets[i] = -1;
+    m_lruHead = m_lruTail = -1;
+    m_used = 0;
+    m_totalThrottled = 0;
+  }
+
+  int findOrInsert(const char *sender) {
+    uint32_t h = hashName(sender);
+    int bucket = h & (HASH_BUCKETS - 1);
+
+    for (int i = m_buckets[bucket]; i != -1; i = m_entries[i].nextInBucket) {
+      if (m_entries[i].hash == h && _stricmp(m_entries[i].name, sender) == 0)
+        return i;
+    }
+
+    // Take a free slot, or evict the least recently seen sender
+    int idx;
+    if (m_used < CAPACITY) {
+      idx = m_used++;
+    } else {
+      idx = m_lruTail;
+      unlinkLru(idx);
+      unlinkBucket(idx);
+    }
+
+    Entry &e = m_entries[idx];
+    memset(&e, 0, sizeof(e));
+    strncpy(e.name, sender, sizeof(e.name) - 1);
+    e.hash = h;
+    e.tokens = 0.0;
+    e.lastRefillMs = 0; // First refill tops the bucket up to a full burst
+    e.used = true;
+    e.lruPrev = e.lruNext = -1;
+    e.nextInBucket = m_buckets[bucket];
+    m_buckets[bucket] = (int16_t)idx;
+    return idx;
+  }
+
+  void unlinkBucket(int idx) {
+    int bucket = m_entries[idx].hash & (HASH_BUCKETS - 1);
+    int16_t *link = &m_buckets[bucket];
+    while (*link != -1) {
+      if (*link == idx) {
+        *link = m_entries[idx].nextInBucket;
+        return;
       }
+      link = &m_entries[*link].nextInBucket;
     }
   }
-}
+
+  void unlinkLru(int idx) {
+    Entry &e = m_entries[idx];
+    if (e.lruPrev != -1)
+      m_entries[e.lruPrev].lruNext = e.lruNext;
+    else if (m_lruHead == idx)
+      m_lruHead = e.lruNext;
+    if (e.lruNext != -1)
+      m_entries[e.lruNext].lruPrev = e.lruPrev;
+    else if (m_lruTail == idx)
+      m_lruTail = e.lruPrev;
+    e.lruPrev = e.lruNext = -1;
+  }
+
+  // Move to the front of the LRU list
+  void touch(int idx) {
+    if (m_lruHead == idx)
+      return;
+    unlinkLru(idx);
+    Entry &e = m_entries[idx];
+    e.lruNext = m_lruHead;
+    if (m_lruHead != -1)
+      m_entries[m_lruHead].lruPrev = (int16_t)idx;
+    m_lruHead = (int16_t)idx;
+    if (m_lruTail == -1)
+      m_lruTail = (int16_t)idx;
+  }
+};
 
 // Hook for GameChat::recvMsg - filters chat messages before display
 void __fastcall HookedRecvMsg(void *thisPtr, void *edx, void *msgStr,
                               void *fromStr, int channel, void *linkedItem) {
+  uint64_t hookStart = __rdtsc();
   bool shouldBlock = false;
 
+  AcquireSRWLockShared(&g_chatSettingsLock);
   __try {
-    if (g_sharedData && g_sharedData->chatFilterEnabled) {
+    // Flood control runs first so a spamming sender never reaches the
+    // substring/regex filters below
+    if (g_sharedData && g_sharedData->chatRateLimitEnabled && fromStr) {
+      const char *sender = ReadGameString(fromStr);
+      if (sender && sender[0] != '\0') {
+        auto &limiter = ChatRateLimiter::getInstance();
+        uint64_t nowMs = GetTickCount64();
+        shouldBlock = limiter.shouldThrottle(
+            sender, g_sharedData->chatRateLimitPerMinute,
+            g_sharedData->chatRateLimitBurst, nowMs);
+        if (shouldBlock && limiter.publishDue(nowMs)) {
+          limiter.publish(g_sharedData);
+        }
+      }
+    }
+
+    if (!shouldBlock && g_sharedData && g_sharedData->chatFilterEnabled) {
 
       // Check for linked item blocking
       if (g_sharedData->blockLinkedItems && linkedItem != nullptr) {
@@ -541,18 +924,9 @@ void __fastcall HookedRecvMsg(void *thisPtr, void *edx, void *msgStr,
 
       // Check filter terms if we have any and haven't already decided to block
       if (!shouldBlock && g_sharedData->chatFilterTerms[0] != '\0' && msgStr) {
-        char *strPtr = nullptr;
-        uint32_t *ssoBuf = (uint32_t *)msgStr;
-        uint32_t capacity = ssoBuf[5];
-
-        if (capacity < 16) {
-          strPtr = (char *)msgStr;
-        } else {
-          strPtr = *(char **)msgStr;
-        }
+        const char *strPtr = ReadGameString(msgStr);
 
-        if (strPtr && (uintptr_t)strPtr > 0x10000 &&
-            (uintptr_t)strPtr < 0x7FFFFFFF) {
+        if (strPtr) {
 
           // Also block if message contains item brackets and blockLinkedItems
           // is on
@@ -602,27 +976,19 @@ void __fastcall HookedRecvMsg(void *thisPtr, void *edx, void *msgStr,
       // If blockLinkedItems is on but no filter terms, still check for brackets
       if (!shouldBlock && g_sharedData->blockLinkedItems &&
           g_sharedData->chatFilterTerms[0] == '\0' && msgStr) {
-        char *strPtr = nullptr;
-        uint32_t *ssoBuf = (uint32_t *)msgStr;
-        uint32_t capacity = ssoBuf[5];
-
-        if (capacity < 16) {
-          strPtr = (char *)msgStr;
-        } else {
-          strPtr = *(char **)msgStr;
-        }
-
-        if (strPtr && (uintptr_t)strPtr > 0x10000 &&
-            (uintptr_t)strPtr < 0x7FFFFFFF) {
-          if (strchr(strPtr, '[') != nullptr) {
-            shouldBlock = true;
-          }
+        const char *strPtr = ReadGameString(msgStr);
+        if (strPtr && strchr(strPtr, '[') != nullptr) {
+          shouldBlock = true;
         }
       }
     }
   } __except (EXCEPTION_EXECUTE_HANDLER) {
     shouldBlock = false;
   }
+  ReleaseSRWLockShared(&g_chatSettingsLock);
+
+  // Filtering is all ours; the original runs after the measurement
+  RecordHookCycles(HOOK_RECV_MSG, __rdtsc() - hookStart);
 
   if (shouldBlock) {
     return; // Don't call original - block message
@@ -635,19 +1001,29 @@ void __fastcall HookedRecvMsg(void *thisPtr, void *edx, void *msgStr,
 
 // Our hook function for ItemNotify
 void __fastcall HookedItemNotify(void *thisPtr, void *edx, void *data) {
+  uint64_t hookStart = __rdtsc();
+  uint64_t origCycles = 0;
+
   if (g_origNotifyItemAdd) {
+    uint64_t origStart = __rdtsc();
     g_origNotifyItemAdd(thisPtr, data);
+    origCycles = __rdtsc() - origStart;
   }
 
   if (g_trackerInstance) {
-    // Notify loot received (Generic item for now)
-    LootEntry entry;
+    // Notify loot received (Generic item for now). The packet's item id and
+    // count offsets aren't confirmed yet; a guessed id would be valued,
+    // counted as gold and archived as if it were real.
+    HookArenaScope arenaScope;
+    LootEntry entry(HookArena::resource());
     entry.item.m_itemId = 0;
     entry.itemName = "Looted Item";
     entry.quality = ItemQuality::QualityLv1; // Common
     entry.amount = 1;
     g_trackerInstance->notifyLootReceived(entry);
   }
+
+  RecordHookCycles(HOOK_ITEM_NOTIFY, __rdtsc() - hookStart - origCycles);
 }
 
 // Our hook function for PkNotify
@@ -658,10 +1034,55 @@ void __fastcall HookedPkNotify(void *thisPtr, void *edx, void *data) {
 
   if (g_trackerInstance) {
     // Notify mob killed
+    HookArenaScope arenaScope;
     g_trackerInstance->notifyMobKilled("Enemy", 0);
   }
 }
 
+//=============================================================================
+// Hook registry - Every detour we install, applied as one batch
+//=============================================================================
+
+// One row per detour, indexed by HookId; HookRegistry resolves and installs
+// them as one batch through the MinHook backend below.
+static const HookSpec g_hookTable[HOOK_COUNT] = {
+    {"addLine", ADDLINE_VA, nullptr, (LPVOID)&HookedAddLine,
+     reinterpret_cast<LPVOID *>(&g_origAddLine), true},
+    {"recvMsg", RECVMSG_VA, nullptr, (LPVOID)&HookedRecvMsg,
+     reinterpret_cast<LPVOID *>(&g_origRecvMsg), true},
+    {"CombatMsg", COMBAT_MSG_VA, nullptr, (LPVOID)&HookedCombatMsg,
+     reinterpret_cast<LPVOID *>(&g_origCombatMsg), true},
+    {"ExpNotify", EXP_NOTIFY_VA, PATTERN_EXP_NOTIFY, (LPVOID)&HookedExpNotify,
+     reinterpret_cast<LPVOID *>(&g_origExpNotify), true},
+    {"ItemNotify", ITEM_NOTIFY_VA, PATTERN_ITEM_NOTIFY,
+     (LPVOID)&HookedItemNotify,
+     reinterpret_cast<LPVOID *>(&g_origNotifyItemAdd), true},
+};
+
+// HookBackend over MinHook
+class MinHookBackend : public HookBackend {
+public:
+  bool initialize() override { return MH_Initialize() == MH_OK; }
+
+  bool create(void *target, void *detour, void **original) override {
+    return MH_CreateHook(target, detour, original) == MH_OK;
+  }
+
+  bool queue(void *target, bool enable) override {
+    return (enable ? MH_QueueEnableHook(target)
+                   : MH_QueueDisableHook(target)) == MH_OK;
+  }
+
+  bool applyQueued() override { return MH_ApplyQueued() == MH_OK; }
+
+  void removeAll() override {
+    MH_DisableHook(MH_ALL_HOOKS);
+    MH_Uninitialize();
+  }
+};
+
+static MinHookBackend g_minHookBackend;
+
 void *EventHooks::s_origExpNotify = nullptr;
 void *EventHooks::s_origNotifyItemAdd = nullptr;
 void *EventHooks::s_origUnitDied = nullptr;
@@ -674,77 +1095,40 @@ EventHooks &EventHooks::getInstance() {
   return instance;
 }
 
+EventHooks::EventHooks() : m_hooks(g_minHookBackend) {}
+
 bool EventHooks::install() {
-  if (m_installed)
-    return true;
+  LARGE_INTEGER installStart;
+  QueryPerformanceCounter(&installStart);
 
-  // Initialize MinHook
-  if (MH_Initialize() != MH_OK) {
+  // The game may be rebased (ASLR); the table's VAs assume 0x00400000
+  MODULEINFO info;
+  if (!GetModuleInformation(GetCurrentProcess(), GetModuleHandle(nullptr),
+                            &info, sizeof(info)))
+    return false;
+  HookImage image = {(const uint8_t *)info.lpBaseOfDll, info.SizeOfImage,
+                     0x00400000};
+  if (!m_hooks.install(g_hookTable, image))
     return false;
-  }
-
-  // Get module base (game may be rebased due to ASLR)
-  HMODULE gameModule = GetModuleHandle(nullptr);
-  DWORD_PTR moduleBase = (DWORD_PTR)gameModule;
-
-  // Calculate actual addresses (handle ASLR rebasing)
-  // The VAs assume base 0x00400000
-  // Actual address = moduleBase + (VA - 0x00400000)
-
-  // Create hook for ExpNotify
-  void *expNotifyAddr = (void *)(moduleBase + (EXP_NOTIFY_VA - 0x00400000));
-  if (MH_CreateHook(expNotifyAddr, (LPVOID)&HookedExpNotify,
-                    reinterpret_cast<LPVOID *>(&g_origExpNotify)) == MH_OK) {
-    MH_EnableHook(expNotifyAddr);
-    s_origExpNotify = (void *)g_origExpNotify;
-  }
-
-  // Create hook for ItemNotify
-  void *itemNotifyAddr = (void *)(moduleBase + (ITEM_NOTIFY_VA - 0x00400000));
-  if (MH_CreateHook(itemNotifyAddr, (LPVOID)&HookedItemNotify,
-                    reinterpret_cast<LPVOID *>(&g_origNotifyItemAdd)) ==
-      MH_OK) {
-    MH_EnableHook(itemNotifyAddr);
-    s_origNotifyItemAdd = (void *)g_origNotifyItemAdd;
-  }
-
-  // Create hook for GameChat::addLine - parses exp from chat strings
-  void *addLineAddr = (void *)(moduleBase + (ADDLINE_VA - 0x00400000));
-  if (MH_CreateHook(addLineAddr, (LPVOID)&HookedAddLine,
-                    reinterpret_cast<LPVOID *>(&g_origAddLine)) == MH_OK) {
-    MH_EnableHook(addLineAddr);
-  }
-
-  // Create hook for CombatMsg - for DPS tracking
-  void *combatMsgAddr = (void *)(moduleBase + (COMBAT_MSG_VA - 0x00400000));
-  if (MH_CreateHook(combatMsgAddr, (LPVOID)&HookedCombatMsg,
-                    reinterpret_cast<LPVOID *>(&g_origCombatMsg)) == MH_OK) {
-    MH_EnableHook(combatMsgAddr);
-    s_origCombatMsg = (void *)g_origCombatMsg;
-  }
 
-  // Create hook for GameChat::recvMsg - for chat filtering
-  void *recvMsgAddr = (void *)(moduleBase + (RECVMSG_VA - 0x00400000));
-  if (MH_CreateHook(recvMsgAddr, (LPVOID)&HookedRecvMsg,
-                    reinterpret_cast<LPVOID *>(&g_origRecvMsg)) == MH_OK) {
-    MH_EnableHook(recvMsgAddr);
-  }
+  s_origExpNotify = (void *)g_origExpNotify;
+  s_origNotifyItemAdd = (void *)g_origNotifyItemAdd;
+  s_origCombatMsg = (void *)g_origCombatMsg;
 
-  m_installed = true;
+  LARGE_INTEGER installEnd, freq;
+  QueryPerformanceCounter(&installEnd);
+  QueryPerformanceFrequency(&freq);
+  m_installUs =
+      (installEnd.QuadPart - installStart.QuadPart) * 1000000 / freq.QuadPart;
   return true;
 }
 
-void EventHooks::uninstall() {
-  if (!m_installed)
-    return;
-
-  // Disable and remove all hooks
-  MH_DisableHook(MH_ALL_HOOKS);
-  MH_Uninitialize();
-
-  m_installed = false;
+bool EventHooks::setHookEnabled(HookId hook, bool enabled) {
+  return m_hooks.setEnabled(hook, enabled);
 }
 
+void EventHooks::uninstall() { m_hooks.uninstall(); }
+
 // Legacy hook functions (kept for compatibility)
 void __fastcall EventHooks::HookExpNotify(void *game, void *edx, void *data) {
   // Handled by HookedExpNotify above
@@ -796,7 +1180,14 @@ void OverlayRenderer::render() {
     renderKillHistory();
 }
 
-void OverlayRenderer::renderStatsPanel() {}
+void OverlayRenderer::renderStatsPanel() {
+  // Shared with the publisher; holding the reference keeps it alive while
+  // we draw, however often the tracker rebuilds it
+  std::shared_ptr<const StatsSnapshot> stats =
+      Tracker::getInstance().getStatsSnapshot();
+  if (!stats)
+    return;
+}
 
 void OverlayRenderer::renderLootHistory() {
   // Similar SFML drawing for loot list
@@ -816,53 +1207,1160 @@ void OverlayRenderer::showLootPanel(bool show) { m_showLoot = show; }
 
 void OverlayRenderer::showKillPanel(bool show) { m_showKills = show; }
 
-void OverlayRenderer::updateStats(const CombatStats &player,
-                                  const CombatStats &party) {
-  m_playerStats = player;
-  m_partyStats = party;
-}
-
 void OverlayRenderer::addLootEntry(const LootEntry &entry) {
-  m_lootHistory.insert(m_lootHistory.begin(), entry);
-  if (m_lootHistory.size() > 50) {
-    m_lootHistory.pop_back();
-  }
+  m_lootHistory.push(entry);
 }
 
 void OverlayRenderer::addKillEntry(const KillEntry &entry) {
-  m_killHistory.insert(m_killHistory.begin(), entry);
-  if (m_killHistory.size() > 50) {
-    m_killHistory.pop_back();
-  }
+  m_killHistory.push(entry);
 }
 
 //=============================================================================
-// Tracker Implementation
+// CombatMeter - Rolling DPS windows and combat segmentation
 //=============================================================================
-Tracker &Tracker::getInstance() {
-  static Tracker instance;
-  return instance;
-}
+class CombatMeter {
+public:
+  static CombatMeter &getInstance() {
+    static CombatMeter instance;
+    return instance;
+  }
 
-bool Tracker::initialize() {
-  if (m_initialized)
-    return true;
+  // Returns true if this hit closed out the previous fight
+  bool addDamage(int amount, uint64_t nowMs) {
+    std::lock_guard<std::mutex> lock(m_lock);
+    bool ended = false;
 
-  // Initialize shared memory for external GUI FIRST (so GUI can connect even if
-  // hooks fail)
+    advanceTo(nowMs / 1000);
+    m_buckets[(nowMs / 1000) & RING_MASK] += amount;
+    for (int w = 0; w < WINDOW_COUNT; w++)
+      m_windowSum[w] += amount;
+
+    // A hit after the idle timeout closes the old fight and opens a new one
+    if (m_inCombat && nowMs - m_lastDamageMs > m_idleTimeoutMs) {
+      endCombat();
+      ended = true;
+    }
+    if (!m_inCombat) {
+      m_inCombat = true;
+      m_combatStartMs = nowMs;
+      m_combatDamage = 0;
+    }
+    m_combatDamage += amount;
+    m_lastDamageMs = nowMs;
+    return ended;
+  }
+
+  // Roll the ring forward and end combat once we've been idle long enough.
+  // Called from the tracker tick so fights end even with no further packets.
+  // Returns true if a fight ended.
+  bool tick(uint64_t nowMs, uint64_t idleTimeoutMs) {
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    if (idleTimeoutMs > 0)
+      m_idleTimeoutMs = idleTimeoutMs;
+
+    advanceTo(nowMs / 1000);
+    if (m_inCombat && nowMs - m_lastDamageMs > m_idleTimeoutMs) {
+      endCombat();
+      return true;
+    }
+    return false;
+  }
+
+  void publish(SharedTrackerData *shared, uint64_t nowMs, int64_t epochMs) {
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    advanceTo(nowMs / 1000);
+
+    shared->dps5s = m_windowSum[0] / (double)WINDOW_SECONDS[0];
+    shared->dps30s = m_windowSum[1] / (double)WINDOW_SECONDS[1];
+    shared->dps60s = m_windowSum[2] / (double)WINDOW_SECONDS[2];
+
+    // Shared timestamps are wall-clock; translate from the tick clock
+    shared->combatStartTime = m_combatStartMs
+                                  ? epochMs - (int64_t)(nowMs - m_combatStartMs)
+                                  : 0;
+    shared->lastDamageTime = m_lastDamageMs
+                                 ? epochMs - (int64_t)(nowMs - m_lastDamageMs)
+                                 : 0;
+    shared->combatDamage = m_combatDamage;
+    shared->inCombat = m_inCombat;
+    shared->lastCombatDPS = m_lastCombatDPS;
+    shared->combatDPS =
+        m_inCombat ? m_combatDamage / combatSeconds(m_combatStartMs, nowMs)
+                   : 0.0;
+  }
+
+  void reset() {
+    std::lock_guard<std::mutex> lock(m_lock);
+    memset(m_buckets, 0, sizeof(m_buckets));
+    memset(m_windowSum, 0, sizeof(m_windowSum));
+    m_headSecond = 0;
+    m_inCombat = false;
+    m_combatStartMs = 0;
+    m_lastDamageMs = 0;
+    m_combatDamage = 0;
+    m_lastCombatDPS = 0.0;
+  }
+
+private:
+  CombatMeter() = default;
+
+  // One bucket per second; ring must cover the longest window
+  static constexpr int RING_SECONDS = 64;
+  static constexpr uint64_t RING_MASK = RING_SECONDS - 1;
+  static constexpr int WINDOW_COUNT = 3;
+  static constexpr int WINDOW_SECONDS[WINDOW_COUNT] = {5, 30, 60};
+  static constexpr uint64_t DEFAULT_IDLE_TIMEOUT_MS = 5000;
+
+  int64_t m_buckets[RING_SECONDS]{};
+  int64_t m_windowSum[WINDOW_COUNT]{}; // Running sum per window
+  uint64_t m_headSecond{0};            // Second held by the newest bucket
+
+  bool m_inCombat{false};
+  uint64_t m_combatStartMs{0};
+  uint64_t m_lastDamageMs{0};
+  int64_t m_combatDamage{0};
+  double m_lastCombatDPS{0.0};
+  uint64_t m_idleTimeoutMs{DEFAULT_IDLE_TIMEOUT_MS};
+
+  std::mutex m_lock;
+
+  static double combatSeconds(uint64_t startMs, uint64_t endMs) {
+    double secs = (endMs - startMs) / 1000.0;
+    return secs < 1.0 ? 1.0 : secs;
+  }
+
+  // Step the head to `second`, expiring buckets as they leave each window.
+  // Cost is bounded by the ring size however long we've been idle.
+  void advanceTo(uint64_t second) {
+    if (second <= m_headSecond)
+      return;
+
+    if (second - m_headSecond >= RING_SECONDS) {
+      memset(m_buckets, 0, sizeof(m_buckets));
+      memset(m_windowSum, 0, sizeof(m_windowSum));
+      m_headSecond = second;
+      return;
+    }
+
+    while (m_headSecond < second) {
+      m_headSecond++;
+      for (int w = 0; w < WINDOW_COUNT; w++) {
+        uint64_t expired = m_headSecond - WINDOW_SECONDS[w];
+        m_windowSum[w] -= m_buckets[expired & RING_MASK];
+      }
+      m_buckets[m_headSecond & RING_MASK] = 0;
+    }
+  }
+
+  void endCombat() {
+    // Measure to the last hit so the idle tail doesn't dilute the number
+    m_lastCombatDPS =
+        m_combatDamage / combatSeconds(m_combatStartMs, m_lastDamageMs);
+    m_inCombat = false;
+  }
+};
+
+//=============================================================================
+// DamageBreakdown - Damage grouped by target and by spell
+//=============================================================================
+
+// Fixed-capacity open-addressing table of damage totals that keeps its top-K
+// up to date on every hit. Totals only grow, so an entry can only move up the
+// ranking and each update is a short bubble through K slots.
+template <int CAPACITY, int TOP_K> class DamageTable {
+public:
+  struct Entry {
+    int32_t key;
+    int64_t damage;
+    int hits;
+    int maxHit;
+    bool used;
+  };
+
+  DamageTable() { clear(); }
+
+  // weight is how many hits this one stands for when the damage is sampled;
+  // it scales the totals but not maxHit, which is a real hit's size.
+  void add(int32_t key, int amount, int weight = 1) {
+    int idx = findOrInsert(key);
+    if (idx < 0)
+      return; // Table full - still in the breakdown total, just unattributed
+
+    Entry &e = m_entries[idx];
+    e.damage += (int64_t)amount * weight;
+    e.hits += weight;
+    if (amount > e.maxHit)
+      e.maxHit = amount;
+
+    updateTop(idx);
+  }
+
+  int topCount() const { return m_topCount; }
+  const Entry &top(int rank) const { return m_entries[m_top[rank]]; }
+
+  void clear() {
+    memset(m_entries, 0, sizeof(m_entries));
+    m_used = 0;
+    m_topCount = 0;
+  }
+
+private:
+  static_assert((CAPACITY & (CAPACITY - 1)) == 0, "power of two");
+  static constexpr int MAX_LOAD = CAPACITY * 3 / 4;
+
+  Entry m_entries[CAPACITY];
+  int m_used{0};
+  int m_top[TOP_K]{};
+  int m_topCount{0};
+
+  int findOrInsert(int32_t key) {
+    uint32_t h = (uint32_t)key * 2654435761u; // Knuth multiplicative hash
+    for (int probe = 0; probe < CAPACITY; probe++) {
+      int idx = (h + probe) & (CAPACITY - 1);
+      Entry &e = m_entries[idx];
+      if (e.used && e.key == key)
+        return idx;
+      if (!e.used) {
+        if (m_used >= MAX_LOAD)
+          return -1;
+        e.used = true;
+        e.key = key;
+        m_used++;
+        return idx;
+      }
+    }
+    return -1;
+  }
+
+  void updateTop(int idx) {
+    int pos = -1;
+    for (int i = 0; i < m_topCount; i++) {
+      if (m_top[i] == idx) {
+        pos = i;
+        break;
+      }
+    }
+
+    if (pos < 0) {
+      if (m_topCount < TOP_K) {
+        pos = m_topCount++;
+      } else if (m_entries[idx].damage >
+                 m_entries[m_top[TOP_K - 1]].damage) {
+        pos = TOP_K - 1;
+      } else {
+        return;
+      }
+      m_top[pos] = idx;
+    }
+
+    while (pos > 0 &&
+           m_entries[m_top[pos - 1]].damage < m_entries[m_top[pos]].damage) {
+      int tmp = m_top[pos - 1];
+      m_top[pos - 1] = m_top[pos];
+      m_top[pos] = tmp;
+      pos--;
+    }
+  }
+};
+
+class DamageBreakdown {
+public:
+  static DamageBreakdown &getInstance() {
+    static DamageBreakdown instance;
+    return instance;
+  }
+
+  void addDamage(int targetGuid, int spellId, int amount, int weight = 1) {
+    std::lock_guard<std::mutex> lock(m_lock);
+    m_targets.add(targetGuid, amount, weight);
+    m_spells.add(spellId, amount, weight);
+    m_totalDamage += (int64_t)amount * weight;
+  }
+
+  void publish(SharedTrackerData *shared) {
+    std::lock_guard<std::mutex> lock(m_lock);
+    copyTop(m_targets, shared->topTargets);
+    copyTop(m_spells, shared->topSpells);
+    shared->breakdownDamage = m_totalDamage;
+  }
+
+  void reset() {
+    std::lock_guard<std::mutex> lock(m_lock);
+    m_targets.clear();
+    m_spells.clear();
+    m_totalDamage = 0;
+  }
+
+private:
+  DamageBreakdown() = default;
+
+  static constexpr int TOP_K = sizeof(SharedTrackerData::topTargets) /
+                               sizeof(SharedTrackerData::topTargets[0]);
+
+  using Table = DamageTable<256, TOP_K>;
+
+  Table m_targets;
+  Table m_spells;
+  int64_t m_totalDamage{0};
+  std::mutex m_lock;
+
+  static void copyTop(const Table &table,
+                      SharedTrackerData::DamageSource (&dst)[TOP_K]) {
+    for (int i = 0; i < TOP_K; i++) {
+      if (i < table.topCount()) {
+        const auto &e = table.top(i);
+        dst[i].id = e.key;
+        dst[i].damage = e.damage;
+        dst[i].hits = e.hits;
+        dst[i].maxHit = e.maxHit;
+      } else {
+        dst[i] = SharedTrackerData::DamageSource{};
+      }
+    }
+  }
+};
+
+//=============================================================================
+// HitSizeStats - Streaming hit-size percentiles for damage and healing
+//=============================================================================
+class HitSizeStats {
+public:
+  static HitSizeStats &getInstance() {
+    static HitSizeStats instance;
+    return instance;
+  }
+
+  // weight as for DamageTable::add: the hits one sampled hit stands for
+  void recordDamage(int spellId, int amount, int weight = 1) {
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    if (!m_fightOpen) {
+      m_fightDamage.clear();
+      m_fightOpen = true;
+    }
+    m_fightDamage.record((uint32_t)amount, (uint32_t)weight);
+
+    if (LogHistogram *spell = findOrInsert(spellId))
+      spell->record((uint32_t)amount, (uint32_t)weight);
+  }
+
+  void recordHealing(int amount) {
+    std::lock_guard<std::mutex> lock(m_lock);
+    m_healing.record((uint32_t)amount);
+  }
+
+  // Fold the finished fight into the session. The fight histogram is kept
+  // (as "last fight") until the next hit opens a new one.
+  void endFight() {
+    std::lock_guard<std::mutex> lock(m_lock);
+    if (m_fightOpen) {
+      m_sessionDamage.merge(m_fightDamage);
+      m_fightOpen = false;
+    }
+  }
+
+  void publish(SharedTrackerData *shared) {
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    // Session view includes the fight still in progress
+    shared->damageHistogram = m_sessionDamage;
+    if (m_fightOpen)
+      shared->damageHistogram.merge(m_fightDamage);
+
+    summarize(shared->damageHistogram, 0, shared->hitDamage);
+    summarize(m_fightDamage, 0, shared->hitDamageFight);
+    summarize(m_healing, 0, shared->hitHealing);
+
+    for (int i = 0; i < 8; i++) {
+      int32_t spellId = shared->topSpells[i].id;
+      const LogHistogram *spell =
+          shared->topSpells[i].damage > 0 ? find(spellId) : nullptr;
+      if (spell) {
+        summarize(*spell, spellId, shared->hitBySpell[i]);
+      } else {
+        shared->hitBySpell[i] = HitSizeSummary{};
+      }
+    }
+  }
+
+  void reset() {
+    std::lock_guard<std::mutex> lock(m_lock);
+    clear();
+  }
+
+private:
+  HitSizeStats() { clear(); }
+
+  // Per-spell histograms are ~1 KB each, so only the first 64 spells seen
+  // get one; the overall histograms still include every hit.
+  static constexpr int SPELL_CAPACITY = 64;
+
+  struct SpellEntry {
+    int32_t spellId;
+    bool used;
+    LogHistogram hist;
+  };
+
+  SpellEntry m_spells[SPELL_CAPACITY];
+  LogHistogram m_sessionDamage; // Completed fights
+  LogHistogram m_fightDamage;   // Current (or last) fight
+  LogHistogram m_healing;
+  bool m_fightOpen{false};
+  std::mutex m_lock;
+
+  void clear() {
+    memset(m_spells, 0, sizeof(m_spells));
+    m_sessionDamage.clear();
+    m_fightDamage.clear();
+    m_healing.clear();
+    m_fightOpen = false;
+  }
+
+  static void summarize(const LogHistogram &hist, int32_t id,
+                        HitSizeSummary &out) {
+    out.id = id;
+    out.count = hist.total;
+    out.p50 = hist.percentile(0.50);
+    out.p90 = hist.percentile(0.90);
+    out.p99 = hist.percentile(0.99);
+    out.max = hist.max;
+  }
+
+  LogHistogram *findOrInsert(int32_t spellId) {
+    uint32_t h = (uint32_t)spellId * 2654435761u;
+    for (int probe = 0; probe < SPELL_CAPACITY; probe++) {
+      SpellEntry &e = m_spells[(h + probe) & (SPELL_CAPACITY - 1)];
+      if (e.used && e.spellId == spellId)
+        return &e.hist;
+      if (!e.used) {
+        e.used = true;
+        e.spellId = spellId;
+        return &e.hist;
+      }
+    }
+    return nullptr;
+  }
+
+  const LogHistogram *find(int32_t spellId) const {
+    uint32_t h = (uint32_t)spellId * 2654435761u;
+    for (int probe = 0; probe < SPELL_CAPACITY; probe++) {
+      const SpellEntry &e = m_spells[(h + probe) & (SPELL_CAPACITY - 1)];
+      if (!e.used)
+        return nullptr;
+      if (e.spellId == spellId)
+        return &e.hist;
+    }
+    return nullptr;
+  }
+};
+
+//=============================================================================
+// RateMeter - Exponentially weighted event rates over several horizons
+//=============================================================================
+
+// Continuous-time EWMA: the rate decays by exp(-dt/tau) between events and
+// each event of size v adds v/tau, so updates and reads are O(1) no matter
+// how irregular the events are. Reads divide by (1 - exp(-age/tau)) so the
+// rate isn't dragged towards zero while the meter is younger than tau.
+class RateMeter {
+public:
+  // Callers read the clock before taking the lock, so nowMs can be a little
+  // behind the last event; that event's time stands and this one adds
+  // undecayed.
+  void add(double value, uint64_t nowMs) {
+    uint64_t dtMs = age(nowMs, m_lastMs);
+    for (int h = 0; h < RATE_HORIZONS; h++) {
+      double tau = HORIZON_MS[h];
+      m_rate[h] = m_rate[h] * decay(dtMs, tau) + value / tau;
+    }
+    if (nowMs > m_lastMs)
+      m_lastMs = nowMs;
+  }
+
+  // Rate per hour over horizon h, decayed to now
+  double perHour(int h, uint64_t nowMs) const {
+    double tau = HORIZON_MS[h];
+    double warm = 1.0 - decay(age(nowMs, m_startMs), tau);
+    if (warm < 1e-3)
+      return 0.0;
+    return m_rate[h] * decay(age(nowMs, m_lastMs), tau) / warm * 3600000.0;
+  }
+
+  void reset(uint64_t nowMs) {
+    for (int h = 0; h < RATE_HORIZONS; h++)
+      m_rate[h] = 0.0;
+    m_startMs = m_lastMs = nowMs;
+  }
+
+private:
+  static constexpr double HORIZON_MS[RATE_HORIZONS] = {60000.0, 600000.0,
+                                                       3600000.0};
+
+  double m_rate[RATE_HORIZONS]{}; // Events per ms
+  uint64_t m_startMs{0};
+  uint64_t m_lastMs{0};
+
+  // Milliseconds from thenMs to nowMs, 0 if nowMs is earlier
+  static uint64_t age(uint64_t nowMs, uint64_t thenMs) {
+    return nowMs > thenMs ? nowMs - thenMs : 0;
+  }
+
+  static double decay(uint64_t dtMs, double tau) {
+    return exp(-(double)dtMs / tau);
+  }
+};
+
+class SessionRates {
+public:
+  static SessionRates &getInstance() {
+    static SessionRates instance;
+    return instance;
+  }
+
+  enum Metric { XP, KILLS, GOLD, LOOT, ITEM_VALUE, SPENT, METRIC_COUNT };
+
+  void add(Metric metric, double value, uint64_t nowMs) {
+    std::lock_guard<std::mutex> lock(m_lock);
+    m_meters[metric].add(value, nowMs);
+  }
+
+  void publish(SharedTrackerData *shared, uint64_t nowMs) {
+    std::lock_guard<std::mutex> lock(m_lock);
+    for (int h = 0; h < RATE_HORIZONS; h++) {
+      shared->xpPerHour[h] = m_meters[XP].perHour(h, nowMs);
+      shared->killsPerHour[h] = m_meters[KILLS].perHour(h, nowMs);
+      shared->goldPerHour[h] = m_meters[GOLD].perHour(h, nowMs);
+      shared->lootPerHour[h] = m_meters[LOOT].perHour(h, nowMs);
+      shared->itemValuePerHour[h] = m_meters[ITEM_VALUE].perHour(h, nowMs);
+      // The meters are linear in their inputs, so the net rate is just the
+      // sum of the parts; no separate meter to keep in step
+      shared->netGoldPerHour[h] = shared->goldPerHour[h] +
+                                  shared->itemValuePerHour[h] -
+                                  m_meters[SPENT].perHour(h, nowMs);
+    }
+
+    // Time to next level at the 10 minute pace
+    auto &bridge = GameBridge::getInstance();
+    LevelProjection projection =
+        ProjectLevel(bridge.getPlayerLevel(), bridge.getPlayerExp(),
+                     bridge.levelTable(), shared->xpPerHour[RATE_10M]);
+    shared->playerLevel = projection.level;
+    shared->expToLevel = projection.expToLevel;
+    shared->secondsToLevel = projection.secondsToLevel;
+  }
+
+  void reset(uint64_t nowMs) {
+    std::lock_guard<std::mutex> lock(m_lock);
+    for (auto &meter : m_meters)
+      meter.reset(nowMs);
+  }
+
+private:
+  SessionRates() { reset(GetTickCount64()); }
+
+  RateMeter m_meters[METRIC_COUNT];
+  std::mutex m_lock;
+};
+
+//=============================================================================
+// SeriesRecorder - Per-second aggregates for the shared time-series ring
+//=============================================================================
+
+// Events accumulate into the current second; the tick flushes whole seconds
+// into SharedTrackerData::history (with zero samples for idle seconds), so
+// the rings always advance one slot per wall second and never allocate.
+class SeriesRecorder {
+public:
+  static SeriesRecorder &getInstance() {
+    static SeriesRecorder instance;
+    return instance;
+  }
+
+  void addDamage(int64_t amount) { m_pending.damage += amount; }
+  void addGold(int64_t amount) { m_pending.gold += amount; }
+  void addExp(int amount) { m_pending.xp += amount; }
+  void addKill() { m_pending.kills++; }
+  void addLoot(int amount) { m_pending.loot += amount; }
+
+  // Called under the shared memory mutex
+  void flush(SeriesHistory &history, uint64_t nowMs, int64_t epochMs) {
+    if (m_clearPending.exchange(false)) {
+      history.clear();
+      m_pending.take();
+      m_secondStartMs = nowMs;
+    }
+    if (nowMs < m_secondStartMs + 1000)
+      return;
+
+    uint64_t elapsed = (nowMs - m_secondStartMs) / 1000;
+    auto endOf = [&](uint64_t second) {
+      return epochMs - (int64_t)(nowMs - (m_secondStartMs + second * 1000));
+    };
+
+    // The pending second, then idle seconds (no more than the hour tier
+    // spans, e.g. after the machine slept)
+    history.pushSecond(m_pending.take(), endOf(1));
+    uint64_t idle = elapsed - 1;
+    if (idle > MAX_IDLE_SECONDS)
+      idle = MAX_IDLE_SECONDS;
+    for (uint64_t i = elapsed - idle; i < elapsed; i++)
+      history.pushSecond(SeriesSample(), endOf(i + 1));
+
+    m_secondStartMs += elapsed * 1000;
+  }
+
+  // Applied by the next flush so the ring is only touched under the mutex
+  void reset() { m_clearPending = true; }
+
+private:
+  SeriesRecorder() = default;
+
+  static constexpr uint64_t MAX_IDLE_SECONDS =
+      (uint64_t)decltype(SeriesHistory::perHour)::CAPACITY *
+      SeriesHistory::SECONDS_PER_HOUR;
+
+  // Event side adds, tick side drains
+  struct PendingSample {
+    std::atomic<int64_t> damage{0};
+    std::atomic<int64_t> gold{0};
+    std::atomic<int> xp{0};
+    std::atomic<int> kills{0};
+    std::atomic<int> loot{0};
+
+    SeriesSample take() {
+      SeriesSample s;
+      s.damage = damage.exchange(0);
+      s.gold = gold.exchange(0);
+      s.xp = xp.exchange(0);
+      s.kills = kills.exchange(0);
+      s.loot = loot.exchange(0);
+      return s;
+    }
+  };
+
+  PendingSample m_pending;
+  uint64_t m_secondStartMs{0};
+  std::atomic<bool> m_clearPending{true};
+};
+
+//=============================================================================
+// DropRates - Per-mob drop rates from loot joined to the kill before it
+//=============================================================================
+
+// Streaming join of kills to loot: each loot event belongs to the most recent
+// kill if it arrived within the drop window, so only that one kill is ever
+// remembered. Counts go into fixed-capacity open-addressing tables (mobs by
+// name, items by mob and item id) whose top lists are kept ranked as counts
+// grow, so publishing never walks the session's history. Items the database
+// doesn't know arrive with id 0 and are keyed by name instead, so they stay
+// separate rows.
+class DropRates {
+public:
+  static DropRates &getInstance() {
+    static DropRates instance;
+    return instance;
+  }
+
+  void addKill(std::string_view mobName, uint64_t nowMs) {
+    std::lock_guard<std::mutex> lock(m_lock);
+    m_lastKillMob = findOrInsertMob(mobName);
+    m_lastKillMs = nowMs;
+    m_lastKillDropped = false;
+    m_lastKillItemCount = 0;
+    if (m_lastKillMob < 0)
+      return; // Table full - its loot counts as unattributed
+
+    m_mobs[m_lastKillMob].kills++;
+    RankTop(m_topMobs, m_topMobCount, m_lastKillMob,
+            [this](int i) { return m_mobs[i].kills; });
+  }
+
+  void addLoot(const LootEntry &loot, uint64_t nowMs) {
+    std::lock_guard<std::mutex> lock(m_lock);
+    // nowMs was read before the lock, so a kill on another thread can be
+    // stamped later; that loot joins it rather than wrapping the age
+    uint64_t killAgeMs = nowMs > m_lastKillMs ? nowMs - m_lastKillMs : 0;
+    if (m_lastKillMob < 0 || killAgeMs > m_windowMs) {
+      m_unattributed++;
+      return;
+    }
+
+    MobEntry &mob = m_mobs[m_lastKillMob];
+    int quality = (int)loot.quality < 6 ? (int)loot.quality : 5;
+    mob.drops++;
+    mob.dropsByQuality[quality]++;
+    if (!m_lastKillDropped) {
+      m_lastKillDropped = true;
+      mob.killsWithDrop++;
+    }
+
+    // An item counts once per kill, so its rate is a share of kills
+    char name[32] = {};
+    strncpy_s(name, sizeof(name), loot.itemName.c_str(), _TRUNCATE);
+    uint16_t itemId = loot.item.m_itemId;
+    uint64_t itemKey = itemId != 0
+                           ? itemId
+                           : NAME_KEY | ItemDbNameHash(name, strlen(name));
+    for (int i = 0; i < m_lastKillItemCount; i++)
+      if (m_lastKillItems[i] == itemKey)
+        return;
+    if (m_lastKillItemCount < MAX_ITEMS_PER_KILL)
+      m_lastKillItems[m_lastKillItemCount++] = itemKey;
+
+    int idx = findOrInsertItem((uint64_t)m_lastKillMob << 33 | itemKey, name);
+    if (idx < 0)
+      return;
+    ItemEntry &item = m_items[idx];
+    item.itemId = itemId;
+    item.kills++;
+    item.quality = (uint8_t)quality;
+    RankTop(mob.topItems, mob.topItemCount, idx,
+            [this](int i) { return m_items[i].kills; });
+  }
+
+  void setWindow(int windowMs) {
+    std::lock_guard<std::mutex> lock(m_lock);
+    m_windowMs = (uint64_t)(windowMs < MIN_WINDOW_MS   ? MIN_WINDOW_MS
+                            : windowMs > MAX_WINDOW_MS ? MAX_WINDOW_MS
+                                                       : windowMs);
+  }
+
+  void publish(SharedTrackerData *shared) {
+    std::lock_guard<std::mutex> lock(m_lock);
+    shared->dropMobCount = m_topMobCount;
+    shared->dropWindowMs = (int32_t)m_windowMs;
+    shared->dropsUnattributed = m_unattributed;
+    for (int i = 0; i < m_topMobCount; i++) {
+      const MobEntry &mob = m_mobs[m_topMobs[i]];
+      MobDrops &dst = shared->dropMobs[i];
+      memcpy(dst.name, mob.name, sizeof(dst.name));
+      dst.kills = mob.kills;
+      dst.killsWithDrop = mob.killsWithDrop;
+      dst.drops = mob.drops;
+      memcpy(dst.dropsByQuality, mob.dropsByQuality,
+             sizeof(dst.dropsByQuality));
+      Wilson(mob.killsWithDrop, mob.kills, dst.dropRate, dst.low, dst.high);
+
+      for (int j = 0; j < TOP_ITEMS; j++) {
+        MobDropItem &out = dst.items[j];
+        if (j >= mob.topItemCount) {
+          out = MobDropItem();
+          continue;
+        }
+        const ItemEntry &item = m_items[mob.topItems[j]];
+        memcpy(out.name, item.name, sizeof(out.name));
+        out.itemId = item.itemId;
+        out.quality = item.quality;
+        out.kills = item.kills;
+        Wilson(item.kills, mob.kills, out.rate, out.low, out.high);
+      }
+    }
+  }
+
+  void reset() {
+    std::lock_guard<std::mutex> lock(m_lock);
+    memset(m_mobs, 0, sizeof(m_mobs));
+    memset(m_items, 0, sizeof(m_items));
+    m_mobsUsed = m_itemsUsed = 0;
+    m_topMobCount = 0;
+    m_lastKillMob = -1;
+    m_unattributed = 0;
+  }
+
+private:
+  DropRates() { reset(); }
+
+  static constexpr int MOB_CAPACITY = 256;   // Power of two
+  static constexpr int ITEM_CAPACITY = 4096; // Power of two
+  static constexpr int TOP_MOBS = sizeof(SharedTrackerData::dropMobs) /
+                                  sizeof(SharedTrackerData::dropMobs[0]);
+  static constexpr int TOP_ITEMS =
+      sizeof(MobDrops::items) / sizeof(MobDrops::items[0]);
+  static constexpr int MAX_ITEMS_PER_KILL = 16;
+  static constexpr int MIN_WINDOW_MS = 1000;
+  static constexpr int MAX_WINDOW_MS = 300000;
+  static constexpr uint64_t DEFAULT_WINDOW_MS = 10000;
+  // Set in item keys that hold a name hash rather than an item id
+  static constexpr uint64_t NAME_KEY = 1ull << 32;
+
+  struct MobEntry {
+    uint32_t hash;
+    char name[32];
+    int kills;
+    int killsWithDrop;
+    int drops;
+    int dropsByQuality[6];
+    int topItems[TOP_ITEMS]; // Indexes into m_items
+    int topItemCount;
+    bool used;
+  };
+
+  struct ItemEntry {
+    uint64_t key; // Mob index << 33 | item id, or NAME_KEY | name hash
+    char name[32];
+    int kills;
+    uint16_t itemId;
+    uint8_t quality;
+    bool used;
+  };
+
+  MobEntry m_mobs[MOB_CAPACITY];
+  ItemEntry m_items[ITEM_CAPACITY];
+  int m_mobsUsed{0};
+  int m_itemsUsed{0};
+  int m_topMobs[TOP_MOBS]{};
+  int m_topMobCount{0};
+
+  // The kill loot is currently being joined to
+  int m_lastKillMob{-1};
+  uint64_t m_lastKillMs{0};
+  bool m_lastKillDropped{false};
+  uint64_t m_lastKillItems[MAX_ITEMS_PER_KILL]{};
+  int m_lastKillItemCount{0};
+
+  uint64_t m_windowMs{DEFAULT_WINDOW_MS};
+  int64_t m_unattributed{0};
+  std::mutex m_lock;
+
+  // Names are truncated to the published width before hashing, so the key
+  // and the stored name always agree
+  int findOrInsertMob(std::string_view mobName) {
+    char name[32] = {};
+    memcpy(name, mobName.data(), (std::min)(mobName.size(), sizeof(name) - 1));
+    uint32_t h = ItemDbNameHash(name, strlen(name));
+    for (int probe = 0; probe < MOB_CAPACITY; probe++) {
+      MobEntry &e = m_mobs[(h + probe) & (MOB_CAPACITY - 1)];
+      if (e.used && e.hash == h && strcmp(e.name, name) == 0)
+        return (int)(&e - m_mobs);
+      if (!e.used) {
+        if (m_mobsUsed >= MOB_CAPACITY * 3 / 4)
+          return -1;
+        e.used = true;
+        e.hash = h;
+        memcpy(e.name, name, sizeof(name));
+        m_mobsUsed++;
+        return (int)(&e - m_mobs);
+      }
+    }
+    return -1;
+  }
+
+  // Name-keyed entries also compare the name, as mobs do, so two unknown
+  // items whose hashes collide stay apart
+  int findOrInsertItem(uint64_t key, const char (&name)[32]) {
+    uint32_t h = (uint32_t)(key ^ key >> 32) * 2654435761u; // Knuth
+    bool byName = (key & NAME_KEY) != 0;
+    for (int probe = 0; probe < ITEM_CAPACITY; probe++) {
+      ItemEntry &e = m_items[(h + probe) & (ITEM_CAPACITY - 1)];
+      if (e.used && e.key == key && (!byName || strcmp(e.name, name) == 0))
+        return (int)(&e - m_items);
+      if (!e.used) {
+        if (m_itemsUsed >= ITEM_CAPACITY * 3 / 4)
+          return -1;
+        e.used = true;
+        e.key = key;
+        memcpy(e.name, name, sizeof(e.name));
+        m_itemsUsed++;
+        return (int)(&e - m_items);
+      }
+    }
+    return -1;
+  }
+
+  // Move entry `idx` into place in a top list ranked by count(idx). Counts
+  // only grow, so an entry only ever moves up (as in DamageTable).
+  template <int K, typename Count>
+  static void RankTop(int (&top)[K], int &topCount, int idx, Count count) {
+    int pos = -1;
+    for (int i = 0; i < topCount; i++) {
+      if (top[i] == idx) {
+        pos = i;
+        break;
+      }
+    }
+    if (pos < 0) {
+      if (topCount < K)
+        pos = topCount++;
+      else if (count(idx) > count(top[K - 1]))
+        pos = K - 1;
+      else
+        return;
+      top[pos] = idx;
+    }
+    while (pos > 0 && count(top[pos - 1]) < count(top[pos])) {
+      int tmp = top[pos - 1];
+      top[pos - 1] = top[pos];
+      top[pos] = tmp;
+      pos--;
+    }
+  }
+
+  // Proportion with its 95% Wilson score interval, which stays sensible for
+  // the handful of kills a rare drop starts from
+  static void Wilson(int successes, int trials, float &rate, float &low,
+                     float &high) {
+    if (trials <= 0) {
+      rate = low = high = 0.0f;
+      return;
+    }
+    const double z = 1.96;
+    double n = trials;
+    double p = (successes < trials ? successes : trials) / n;
+    double denom = 1.0 + z * z / n;
+    double center = (p + z * z / (2.0 * n)) / denom;
+    double half =
+        z * std::sqrt(p * (1.0 - p) / n + z * z / (4.0 * n * n)) / denom;
+    rate = (float)p;
+    low = (float)(center - half > 0.0 ? center - half : 0.0);
+    high = (float)(center + half < 1.0 ? center + half : 1.0);
+  }
+};
+
+//=============================================================================
+// SessionArchiver - Event log of the session, archived when it ends
+//=============================================================================
+
+// Each economy event appends one fixed-size record. When the session ends
+// (stats reset) the log is encoded as a columnar SessionArchive and written
+// to the Sessions directory next to the DLL for the tools. The tick also
+// checkpoints the running session to the same file every few minutes and on
+// request before an unload, so a crash or unload loses little of it. All
+// of this runs on the tick thread, never from DllMain.
+class SessionArchiver {
+public:
+  static SessionArchiver &getInstance() {
+    static SessionArchiver instance;
+    return instance;
+  }
+
+  void start(int64_t nowMs) {
+    std::lock_guard<std::mutex> lock(m_lock);
+    m_events.clear();
+    m_names.clear();
+    m_nameIds.clear();
+    m_startMs = nowMs;
+    m_checkpointedEvents = 0;
+  }
+
+  void record(ArchiveEventType type, uint32_t id, int64_t amount,
+              int64_t value = 0, uint8_t quality = 0) {
+    std::lock_guard<std::mutex> lock(m_lock);
+    push(type, id, amount, value, quality);
+  }
+
+  void recordKill(std::string_view mobName) {
+    std::lock_guard<std::mutex> lock(m_lock);
+    // Looked up by hash so a name seen before builds no key string
+    uint32_t hash = ItemDbNameHash(mobName.data(), mobName.size());
+    auto range = m_nameIds.equal_range(hash);
+    auto found = range.first;
+    while (found != range.second && m_names[found->second] != mobName)
+      ++found;
+    uint32_t id;
+    if (found != range.second) {
+      id = found->second;
+    } else {
+      id = (uint32_t)m_names.size();
+      m_nameIds.emplace(hash, id);
+      m_names.emplace_back(mobName);
+    }
+    push(ARCHIVE_KILL, id, 1, 0, 0);
+  }
+
+  // Write the session so far to `directory` and start a new one. Sessions
+  // without a single event aren't worth a file.
+  bool finish(const char *directory, int64_t nowMs) {
+    std::vector<ArchiveEvent> events;
+    std::vector<std::string> names;
+    int64_t startMs;
+    {
+      std::lock_guard<std::mutex> lock(m_lock);
+      events.swap(m_events);
+      names.swap(m_names);
+      m_nameIds.clear();
+      startMs = m_startMs;
+      m_startMs = nowMs;
+      m_checkpointedEvents = 0;
+    }
+    // Encoding runs outside the lock so hooks keep logging the new session
+    bool ok = write(directory, events, names, startMs, nowMs);
+    if (ok)
+      m_archived++;
+    return ok;
+  }
+
+  // Write the session so far without ending it, if anything was logged
+  // since the last checkpoint. The file is the one finish() will replace.
+  bool checkpoint(const char *directory, int64_t nowMs) {
+    std::vector<ArchiveEvent> events;
+    std::vector<std::string> names;
+    int64_t startMs;
+    {
+      std::lock_guard<std::mutex> lock(m_lock);
+      if (m_events.size() == m_checkpointedEvents)
+        return false;
+      events = m_events;
+      names = m_names;
+      startMs = m_startMs;
+      m_checkpointedEvents = m_events.size();
+    }
+    return write(directory, events, names, startMs, nowMs);
+  }
+
+  void publish(SharedTrackerData *shared) {
+    std::lock_guard<std::mutex> lock(m_lock);
+    shared->sessionLogEvents = (uint32_t)m_events.size();
+    shared->sessionsArchived = m_archived;
+  }
+
+private:
+  SessionArchiver() { m_events.reserve(4096); }
+
+  // Enough for days of farming; past it the rest of the session isn't logged
+  static constexpr size_t MAX_EVENTS = 1 << 20;
+
+  // Encode and write one session. The bytes go to a temporary file that then
+  // replaces the archive, so a crash mid-write keeps the last checkpoint.
+  static bool write(const char *directory,
+                    const std::vector<ArchiveEvent> &events,
+                    const std::vector<std::string> &names, int64_t startMs,
+                    int64_t endMs) {
+    if (events.empty())
+      return false;
+    if (startMs == 0)
+      startMs = events.front().timestampMs;
+    std::vector<uint8_t> bytes =
+        EncodeSessionArchive(events, names, startMs, endMs);
+
+    char path[MAX_PATH];
+    char tempPath[MAX_PATH];
+    time_t startSec = (time_t)(startMs / 1000);
+    struct tm local;
+    localtime_s(&local, &startSec);
+    CreateDirectoryA(directory, nullptr);
+    snprintf(path, MAX_PATH, "%s\\session-%04d%02d%02d-%02d%02d%02d%s",
+             directory, local.tm_year + 1900, local.tm_mon + 1, local.tm_mday,
+             local.tm_hour, local.tm_min, local.tm_sec,
+             ARCHIVE_FILE_EXTENSION);
+    snprintf(tempPath, MAX_PATH, "%s.tmp", path);
+    HANDLE file = CreateFileA(tempPath, GENERIC_WRITE, 0, nullptr,
+                              CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+      return false;
+    DWORD written = 0;
+    bool ok = WriteFile(file, bytes.data(), (DWORD)bytes.size(), &written,
+                        nullptr) &&
+              written == bytes.size();
+    CloseHandle(file);
+    if (ok)
+      ok = MoveFileExA(tempPath, path, MOVEFILE_REPLACE_EXISTING) != 0;
+    if (!ok)
+      DeleteFileA(tempPath);
+    return ok;
+  }
+
+  void push(ArchiveEventType type, uint32_t id, int64_t amount, int64_t value,
+            uint8_t quality) {
+    if (m_events.size() >= MAX_EVENTS)
+      return;
+    ArchiveEvent event = {};
+    event.timestampMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                            std::chrono::system_clock::now().time_since_epoch())
+                            .count();
+    event.amount = amount;
+    event.value = value;
+    event.id = id;
+    event.type = type;
+    event.quality = quality;
+    m_events.push_back(event);
+  }
+
+  std::mutex m_lock;
+  std::vector<ArchiveEvent> m_events;
+  std::vector<std::string> m_names; // Mob names by ARCHIVE_KILL id
+  std::unordered_multimap<uint32_t, uint32_t> m_nameIds; // Name hash -> id
+  int64_t m_startMs{0};
+  size_t m_checkpointedEvents{0}; // Log size at the last checkpoint
+  std::atomic<uint32_t> m_archived{0};
+};
+
+// Real time for PollWithBackoff
+struct TickClock {
+  uint64_t nowMs() const { return GetTickCount64(); }
+  void sleepMs(uint32_t ms) const { Sleep(ms); }
+};
+
+//=============================================================================
+// Tracker Implementation
+//=============================================================================
+Tracker &Tracker::getInstance() {
+  static Tracker instance;
+  return instance;
+}
+
+bool Tracker::initialize() {
+  if (m_initialized)
+    return true;
+
+  m_attachTick = GetTickCount64();
+  for (int i = 0; i < INIT_STAGES; i++)
+    m_initStageMs[i] = INIT_STAGE_PENDING;
+  uint64_t deadline = m_attachTick + READY_TIMEOUT_MS;
+  TickClock clock;
+  auto &bridge = GameBridge::getInstance();
+
+  // Stage 1: shared memory and counters, so the GUI can connect within
+  // milliseconds of injection even if nothing after this works
   if (!initSharedMemory()) {
     // Non-fatal - GUI just won't work, but log it
   }
+  m_counters.reset();
+  bridge.loadItemDatabase(); // One small file mapping; optional
+  markInitStage(INIT_SHARED_MEMORY);
+
+  // Stage 2: chat and combat hooks. They're placed by VA, so they only need
+  // the image mapped, not the slow signature scans.
+  markInitStage(INIT_MODULE_MAPPED,
+                PollWithBackoff(
+                    clock, [&] { return bridge.isModuleMapped(); }, deadline,
+                    m_stopInit));
+  if (m_stopInit)
+    return false;
+  installHooks();
+  markInitStage(INIT_HOOKS);
+
+  // Stage 3: the costly lookups - signature scans, the game singletons and
+  // the overlay. The hooks are already counting while these run. On timeout
+  // carry on; only the GameBridge queries go without.
+  // An unload can be requested at any point, so every step checks first.
+  bool found = PollWithBackoff(
+      clock, [&] { return bridge.resolveSignatures(); }, deadline,
+      m_stopInit);
+  if (m_stopInit)
+    return false;
+  markInitStage(INIT_SIGNATURES, found);
 
-  m_playerStats.reset();
-  m_partyStats.reset();
-  updateSharedMemory();
+  bool ready = found && PollWithBackoff(
+                            clock, [&] { return bridge.singletonsReady(); },
+                            deadline, m_stopInit);
+  if (m_stopInit)
+    return false;
+  markInitStage(INIT_SINGLETONS, ready);
 
-  // Initialize game bridge (may fail if patterns don't match)
-  if (!GameBridge::getInstance().initialize()) {
-    // Continue anyway - shared memory is up for GUI
-  }
+  // Initialize overlay (may fail)
+  if (m_stopInit)
+    return false;
+  OverlayRenderer::getInstance().initialize();
+  if (m_stopInit)
+    return false;
+  markInitStage(INIT_OVERLAY);
+
+  return true;
+}
 
+void Tracker::installHooks() {
   // Set global instance for hooks
   g_trackerInstance = this;
 
@@ -875,43 +2373,52 @@ bool Tracker::initialize() {
     onLootReceived(loot);
   };
 
-  hooks.onMobKilled = [this](const std::string &name, int exp) {
+  hooks.onMobKilled = [this](std::string_view name, int exp) {
     onMobKilled(name, exp);
   };
 
   // Hooks may fail if patterns don't match - that's ok
   hooks.install();
 
-  // Initialize overlay (may fail)
-  OverlayRenderer::getInstance().initialize();
-
   m_initialized = true;
-  updateSharedMemory();
 
-  return true;
+  // Periodic tick so combat ends and DPS windows decay without new events.
+  // A timer-queue timer (not a std::thread) so shutdown from DllMain doesn't
+  // have to join a thread while holding the loader lock.
+  CreateTimerQueueTimer(
+      &m_tickTimer, nullptr,
+      [](PVOID param, BOOLEAN) { static_cast<Tracker *>(param)->tick(); },
+      this, m_tickIntervalMs, m_tickIntervalMs, WT_EXECUTEDEFAULT);
 }
 
 void Tracker::shutdown() {
+  m_stopInit = true; // Stage 3 may still be polling
   if (!m_initialized)
     return;
 
-  m_initialized = false; // Signal thread to stop
+  m_initialized = false;
 
-  // Wait for test thread to finish
-  if (m_testThread.joinable()) {
-    m_testThread.join();
+  // Stop the tick timer and wait for any running callback to finish
+  if (m_tickTimer) {
+    DeleteTimerQueueTimer(nullptr, m_tickTimer, INVALID_HANDLE_VALUE);
+    m_tickTimer = nullptr;
   }
 
   g_trackerInstance = nullptr;
 
+  // No archiving here: this runs under the loader lock, and at process exit
+  // other threads may have died holding the archiver's lock. The tick has
+  // checkpointed the session, and the Unloader asks for a final save
+  // (CMD_PREPARE_UNLOAD) before it unloads us.
   EventHooks::getInstance().uninstall();
   OverlayRenderer::getInstance().shutdown();
+  GameBridge::getInstance().unloadItemDatabase();
   cleanupSharedMemory();
 }
 
 void Tracker::notifyExpGained(int amount) { onExpGained(amount); }
 
-void Tracker::notifyMobKilled(const std::string &name, int exp) {
+void Tracker::notifyMobKilled(std::string_view name, int exp) {
   onMobKilled(name, exp);
 }
 
@@ -922,76 +2429,238 @@ void Tracker::notifyLootReceived(const LootEntry &loot) {
 void Tracker::notifyGoldChanged(int amount) {
   // Accumulate gold from chat parsing
   if (amount > 0) {
-    m_playerStats.totalGold += amount;
-    updateSharedMemory();
+    m_counters.add(STAT_GOLD, amount);
+    SessionRates::getInstance().add(SessionRates::GOLD, amount,
+                                    GetTickCount64());
+    SeriesRecorder::getInstance().addGold(amount);
+    SessionArchiver::getInstance().record(ARCHIVE_GOLD, 0, amount);
+    m_statsDirty = true;
+    publishEvent();
   }
 }
 
 void Tracker::notifyGoldSpent(int amount) {
   // Track gold spent (repair costs, purchases, etc.)
   if (amount > 0) {
-    m_playerStats.goldSpent += amount;
-    updateSharedMemory();
+    m_counters.add(STAT_GOLD_SPENT, amount);
+    SessionRates::getInstance().add(SessionRates::SPENT, amount,
+                                    GetTickCount64());
+    SessionArchiver::getInstance().record(ARCHIVE_SPENT, 0, amount);
+    m_statsDirty = true;
+    publishEvent();
   }
 }
 
-void Tracker::notifyDamageDealt(int amount) {
+void Tracker::notifyDamageDealt(int amount, int targetGuid, int spellId) {
   // Track damage dealt for DPS calculation
   if (amount > 0) {
-    m_playerStats.totalDamage += amount;
-    updateSharedMemory();
+    m_counters.add(STAT_DAMAGE, amount);
+    if (CombatMeter::getInstance().addDamage(amount, GetTickCount64()))
+      HitSizeStats::getInstance().endFight();
+    int weight;
+    if (OverheadGovernor::getInstance().sampleDamage(weight)) {
+      DamageBreakdown::getInstance().addDamage(targetGuid, spellId, amount,
+                                               weight);
+      HitSizeStats::getInstance().recordDamage(spellId, amount, weight);
+    }
+    SeriesRecorder::getInstance().addDamage(amount);
+    m_statsDirty = true;
+    publishEvent();
+  }
+}
+
+void Tracker::notifyHealingDone(int amount, int spellId) {
+  // Only feeds the hit-size distribution; published on the next tick
+  if (amount > 0) {
+    HitSizeStats::getInstance().recordHealing(amount);
   }
 }
 
-void Tracker::onMobKilled(const std::string &name, int exp) {
-  KillEntry entry;
-  entry.mobName = name;
+void Tracker::tick() {
+  // Skip if the previous tick is still running (timer callbacks can overlap)
+  if (m_ticking.test_and_set())
+    return;
+
+  // Safe point for GUI requests: nothing else publishes mid-tick
+  processCommands();
+
+  // The tick is one event batch for the arena
+  HookArenaScope arenaScope;
+
+  // The name caches' ContentMgr check runs here and nowhere else, so the
+  // lookups on the game thread stay plain cache reads
+  GameBridge::getInstance().checkContentReload();
+
+  // Chat lines the governor deferred, then its verdict on the last interval
+  uint64_t nowMs = GetTickCount64();
+  DeferredChatLines::getInstance().drain(ParseChatLine);
+  if (m_sharedData)
+    OverheadGovernor::getInstance().update(nowMs,
+                                           m_sharedData->tscTicksPerUs,
+                                           m_sharedData->overheadBudgetUs);
+
+  uint64_t idleTimeoutMs =
+      m_sharedData ? (uint64_t)m_sharedData->combatIdleTimeoutMs : 0;
+  if (CombatMeter::getInstance().tick(nowMs, idleTimeoutMs))
+    HitSizeStats::getInstance().endFight();
+  refreshStatsSnapshot(nowMs, true);
+  updateSharedMemory();
+
+  if (nowMs - m_lastCheckpointTick >= SESSION_CHECKPOINT_MS)
+    checkpointSession();
+
+  m_ticking.clear();
+}
+
+void Tracker::onMobKilled(std::string_view name, int exp) {
+  KillEntry entry(HookArena::resource());
+  entry.mobName.assign(name.data(), name.size());
   entry.expGained = exp;
   entry.timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
                         std::chrono::system_clock::now().time_since_epoch())
                         .count();
   entry.isPartyKill = GameBridge::getInstance().isInParty();
 
-  m_killHistory.push_back(entry);
-  m_playerStats.totalKills++;
+  m_counters.add(STAT_KILLS, 1);
+  SessionRates::getInstance().add(SessionRates::KILLS, 1, GetTickCount64());
+  SeriesRecorder::getInstance().addKill();
+  SessionArchiver::getInstance().recordKill(name);
+  DropRates::getInstance().addKill(name, GetTickCount64());
 
   if (entry.isPartyKill) {
-    m_partyStats.totalKills++;
+    m_counters.add(STAT_PARTY_KILLS, 1);
   }
 
-  OverlayRenderer::getInstance().addKillEntry(entry);
-  OverlayRenderer::getInstance().updateStats(m_playerStats, m_partyStats);
-  updateSharedMemory();
+  {
+    std::lock_guard<std::mutex> lock(m_historyLock);
+    m_killHistory.push(entry);
+    OverlayRenderer::getInstance().addKillEntry(entry);
+  }
+  m_statsDirty = true;
+  publishEvent();
 }
 
 void Tracker::onLootReceived(const LootEntry &loot) {
-  m_lootHistory.push_back(loot);
-  m_playerStats.totalLootItems += loot.amount;
-  m_playerStats.lootByQuality[loot.quality] += loot.amount;
+  uint64_t nowMs = GetTickCount64();
+  m_counters.add(STAT_LOOT_ITEMS, loot.amount);
+  if ((int)loot.quality < 6)
+    m_counters.add(STAT_LOOT_QUALITY + (int)loot.quality, loot.amount);
+  SessionRates::getInstance().add(SessionRates::LOOT, loot.amount, nowMs);
+  SeriesRecorder::getInstance().addLoot(loot.amount);
 
   // Check if gold
   constexpr uint16_t GOLD_ITEM = 1;
   if (loot.item.m_itemId == GOLD_ITEM) {
-    m_playerStats.totalGold += loot.amount;
+    m_counters.add(STAT_GOLD, loot.amount);
+    SessionRates::getInstance().add(SessionRates::GOLD, loot.amount, nowMs);
+    SeriesRecorder::getInstance().addGold(loot.amount);
+    SessionArchiver::getInstance().record(ARCHIVE_GOLD, 0, loot.amount);
+  } else {
+    // Value the stack at vendor price as it arrives
+    int64_t value = 0;
+    if (loot.item.m_itemId != 0)
+      value = (int64_t)GameBridge::getInstance().getItemValue(
+                  loot.item.m_itemId) *
+              loot.amount;
+    if (value > 0) {
+      m_counters.add(STAT_ITEM_VALUE, value);
+      if ((int)loot.quality < 6)
+        m_counters.add(STAT_VALUE_QUALITY + (int)loot.quality, value);
+      SessionRates::getInstance().add(SessionRates::ITEM_VALUE, (double)value,
+                                      nowMs);
+    }
+    SessionArchiver::getInstance().record(ARCHIVE_LOOT, loot.item.m_itemId,
+                                          loot.amount, value,
+                                          (uint8_t)loot.quality);
+    DropRates::getInstance().addLoot(loot, nowMs);
   }
 
-  OverlayRenderer::getInstance().addLootEntry(loot);
-  OverlayRenderer::getInstance().updateStats(m_playerStats, m_partyStats);
-  updateSharedMemory();
+  {
+    std::lock_guard<std::mutex> lock(m_historyLock);
+    m_lootHistory.push(loot);
+    OverlayRenderer::getInstance().addLootEntry(loot);
+  }
+  m_statsDirty = true;
+  publishEvent();
 }
 
 void Tracker::onExpGained(int amount) {
-  m_playerStats.totalExp += amount;
-  OverlayRenderer::getInstance().updateStats(m_playerStats, m_partyStats);
-  updateSharedMemory();
+  m_counters.add(STAT_EXP, amount);
+  SessionRates::getInstance().add(SessionRates::XP, amount, GetTickCount64());
+  SeriesRecorder::getInstance().addExp(amount);
+  SessionArchiver::getInstance().record(ARCHIVE_EXP, 0, amount);
+  m_statsDirty = true;
+  publishEvent();
+}
+
+CombatStats Tracker::getPlayerStats() const {
+  CombatStats stats;
+  stats.totalKills = (int)m_counters.read(STAT_KILLS);
+  stats.totalLootItems = (int)m_counters.read(STAT_LOOT_ITEMS);
+  stats.totalGold = m_counters.read(STAT_GOLD);
+  stats.totalExp = (int)m_counters.read(STAT_EXP);
+  stats.goldSpent = m_counters.read(STAT_GOLD_SPENT);
+  stats.totalDamage = m_counters.read(STAT_DAMAGE);
+  stats.itemValue = m_counters.read(STAT_ITEM_VALUE);
+  for (int q = 0; q < 6; q++) {
+    stats.lootByQuality[q] = (int)m_counters.read(STAT_LOOT_QUALITY + q);
+    stats.valueByQuality[q] = m_counters.read(STAT_VALUE_QUALITY + q);
+  }
+  return stats;
+}
+
+CombatStats Tracker::getPartyStats() const {
+  // Only party kills are attributed so far
+  CombatStats stats;
+  stats.totalKills = (int)m_counters.read(STAT_PARTY_KILLS);
+  return stats;
+}
+
+void Tracker::refreshStatsSnapshot(uint64_t nowTick, bool force) {
+  if (!m_statsDirty.load())
+    return;
+  std::shared_ptr<const StatsSnapshot> current =
+      std::atomic_load(&m_statsSnapshot);
+  if (!force && current && nowTick - current->builtTick < m_tickIntervalMs)
+    return; // The tick picks the change up
+
+  // Cleared before copying, so a change that races the copy marks it again.
+  // An event publish can race the tick's rebuild; either copy is complete.
+  m_statsDirty = false;
+  auto next = std::make_shared<StatsSnapshot>();
+  next->player = getPlayerStats();
+  next->party = getPartyStats();
+  next->version = current ? current->version + 1 : 1;
+  next->builtTick = nowTick;
+  std::atomic_store(&m_statsSnapshot,
+                    std::shared_ptr<const StatsSnapshot>(std::move(next)));
+}
+
+void Tracker::publishEvent() {
+  if (m_initStageMs[INIT_FIRST_EVENT] == INIT_STAGE_PENDING)
+    markInitStage(INIT_FIRST_EVENT);
+
+  // In minimal mode the tick is the only publisher
+  if (OverheadGovernor::getInstance().mode() != OVERHEAD_MINIMAL)
+    updateSharedMemory();
 }
 
 void Tracker::resetStats() {
-  m_playerStats.reset();
-  m_partyStats.reset();
-  m_lootHistory.clear();
-  m_killHistory.clear();
-  OverlayRenderer::getInstance().updateStats(m_playerStats, m_partyStats);
+  archiveSession(); // The session being reset is complete
+  m_counters.reset();
+  {
+    std::lock_guard<std::mutex> lock(m_historyLock);
+    m_lootHistory.clear();
+    m_killHistory.clear();
+  }
+  ChatRateLimiter::getInstance().reset();
+  CombatMeter::getInstance().reset();
+  DamageBreakdown::getInstance().reset();
+  HitSizeStats::getInstance().reset();
+  DropRates::getInstance().reset();
+  startSessionClock();
+  m_statsDirty = true;
+  refreshStatsSnapshot(GetTickCount64(), true);
   updateSharedMemory();
 }
 
@@ -1003,6 +2672,88 @@ void Tracker::toggleOverlay() {
   updateSharedMemory();
 }
 
+bool Tracker::queueCommand(uint32_t type) {
+  if (!m_sharedData || !m_tickTimer)
+    return false;
+  TrackerCommand cmd = {};
+  cmd.type = type;
+  return m_sharedData->commands.push(cmd) != 0;
+}
+
+void Tracker::processCommands() {
+  if (!m_sharedData)
+    return;
+  TrackerCommand cmd;
+  uint32_t seq;
+  while (m_sharedData->commands.pop(cmd, seq)) {
+    applyCommand(cmd);
+    m_sharedData->commands.ack(seq);
+  }
+}
+
+void Tracker::applyCommand(const TrackerCommand &cmd) {
+  switch (cmd.type) {
+  case CMD_RESET_STATS:
+    resetStats();
+    break;
+
+  case CMD_TOGGLE_OVERLAY:
+    toggleOverlay();
+    break;
+
+  case CMD_SET_FILTER:
+    AcquireSRWLockExclusive(&g_chatSettingsLock);
+    m_sharedData->chatFilterEnabled = (cmd.flags & CMD_FLAG_ENABLED) != 0;
+    m_sharedData->blockLinkedItems = (cmd.flags & CMD_FLAG_BLOCK_ITEMS) != 0;
+    m_sharedData->useRegexFilter = (cmd.flags & CMD_FLAG_REGEX) != 0;
+    strncpy_s(m_sharedData->chatFilterTerms,
+              sizeof(m_sharedData->chatFilterTerms), cmd.text, _TRUNCATE);
+    ReleaseSRWLockExclusive(&g_chatSettingsLock);
+    break;
+
+  case CMD_SET_RATE_LIMIT:
+    AcquireSRWLockExclusive(&g_chatSettingsLock);
+    m_sharedData->chatRateLimitEnabled = (cmd.flags & CMD_FLAG_ENABLED) != 0;
+    if (cmd.args[0] > 0)
+      m_sharedData->chatRateLimitPerMinute = cmd.args[0];
+    if (cmd.args[1] > 0)
+      m_sharedData->chatRateLimitBurst = cmd.args[1];
+    ReleaseSRWLockExclusive(&g_chatSettingsLock);
+    break;
+
+  case CMD_SET_REFRESH_RATE: {
+    // Bounded so combat timeouts and the per-second series stay accurate
+    DWORD intervalMs = (DWORD)cmd.args[0];
+    if (intervalMs < MIN_TICK_INTERVAL_MS)
+      intervalMs = MIN_TICK_INTERVAL_MS;
+    if (intervalMs > MAX_TICK_INTERVAL_MS)
+      intervalMs = MAX_TICK_INTERVAL_MS;
+    if (intervalMs != m_tickIntervalMs && m_tickTimer) {
+      m_tickIntervalMs = intervalMs;
+      ChangeTimerQueueTimer(nullptr, m_tickTimer, intervalMs, intervalMs);
+      m_sharedData->publishIntervalMs = (int)intervalMs;
+    }
+    break;
+  }
+
+  case CMD_SET_HOOK_ENABLED:
+    if (cmd.args[0] >= 0 && cmd.args[0] < HOOK_COUNT)
+      EventHooks::getInstance().setHookEnabled(
+          (HookId)cmd.args[0], (cmd.flags & CMD_FLAG_ENABLED) != 0);
+    break;
+
+  case CMD_SET_DROP_WINDOW:
+    DropRates::getInstance().setWindow(cmd.args[0]);
+    break;
+
+  case CMD_PREPARE_UNLOAD:
+    // Stage 3 holds a module reference, so the unload waits for it to stop
+    m_stopInit = true;
+    checkpointSession();
+    break;
+  }
+}
+
 bool Tracker::initSharedMemory() {
   // Create mutex for synchronization
   m_mutexHandle = CreateMutexA(nullptr, FALSE, TRACKER_MUTEX_NAME);
@@ -1037,10 +2788,29 @@ bool Tracker::initSharedMemory() {
   ZeroMemory(m_sharedData, sizeof(SharedTrackerData));
   m_sharedData->magic = 0xDEADBEEF;
   m_sharedData->overlayVisible = true;
-  m_sharedData->sessionStartTime =
-      std::chrono::duration_cast<std::chrono::milliseconds>(
-          std::chrono::system_clock::now().time_since_epoch())
-          .count();
+  m_sharedData->publishIntervalMs = (int)m_tickIntervalMs;
+  startSessionClock();
+
+  // Hook timing names, and the TSC/QPC pair the TSC rate is measured from
+  for (int i = 0; i < HOOK_COUNT; i++)
+    strcpy_s(m_sharedData->hookLatency[i].name,
+             sizeof(m_sharedData->hookLatency[i].name), g_hookTable[i].name);
+  LARGE_INTEGER qpc;
+  QueryPerformanceCounter(&qpc);
+  m_tscCalibrationQpc = qpc.QuadPart;
+  m_tscCalibrationTsc = __rdtsc();
+
+  // Default settings; from here on the GUI changes them through commands
+  strcpy_s(m_sharedData->chatFilterTerms,
+           sizeof(m_sharedData->chatFilterTerms),
+           "wts, wtb, wtt, sell, offer, cheap, obo, \\[.*\\]");
+  m_sharedData->chatRateLimitPerMinute = 20; // After a burst of 5
+  m_sharedData->chatRateLimitBurst = 5;
+  m_sharedData->combatIdleTimeoutMs = 5000;
+  m_sharedData->overheadBudgetUs = OverheadGovernor::DEFAULT_BUDGET_US;
+
+  // Signaled after each publish so the GUI needn't poll (optional)
+  m_updateNotifier.create(TRACKER_UPDATE_EVENT_NAME);
 
   // Set global pointer for chat filter access
   g_sharedData = m_sharedData;
@@ -1048,6 +2818,49 @@ bool Tracker::initSharedMemory() {
   return true;
 }
 
+void Tracker::markInitStage(InitStage stage, bool reached) {
+  if (m_initStageMs[stage] != INIT_STAGE_PENDING)
+    return;
+  m_initStageMs[stage] = reached
+                             ? (int32_t)(GetTickCount64() - m_attachTick)
+                             : INIT_STAGE_SKIPPED;
+  updateSharedMemory();
+}
+
+void Tracker::archiveSession() {
+  char directory[MAX_PATH];
+  if (PathNextToModule(SESSION_ARCHIVE_DIR, directory))
+    SessionArchiver::getInstance().finish(
+        directory, std::chrono::duration_cast<std::chrono::milliseconds>(
+                       std::chrono::system_clock::now().time_since_epoch())
+                       .count());
+}
+
+void Tracker::checkpointSession() {
+  m_lastCheckpointTick = GetTickCount64();
+  char directory[MAX_PATH];
+  if (PathNextToModule(SESSION_ARCHIVE_DIR, directory))
+    SessionArchiver::getInstance().checkpoint(
+        directory, std::chrono::duration_cast<std::chrono::milliseconds>(
+                       std::chrono::system_clock::now().time_since_epoch())
+                       .count());
+}
+
+void Tracker::startSessionClock() {
+  // Rates and elapsed time run off the tick count so they're unaffected by
+  // wall-clock changes; sessionStartTime stays wall-clock for display.
+  m_sessionStartTick = GetTickCount64();
+  m_lastCheckpointTick = m_sessionStartTick;
+  SessionRates::getInstance().reset(m_sessionStartTick);
+  SeriesRecorder::getInstance().reset();
+  int64_t nowEpoch = std::chrono::duration_cast<std::chrono::milliseconds>(
+                         std::chrono::system_clock::now().time_since_epoch())
+                         .count();
+  SessionArchiver::getInstance().start(nowEpoch);
+  if (m_sharedData)
+    m_sharedData->sessionStartTime = nowEpoch;
+}
+
 void Tracker::cleanupSharedMemory() {
   if (m_sharedData) {
     UnmapViewOfFile(m_sharedData);
@@ -1061,49 +2874,112 @@ void Tracker::cleanupSharedMemory() {
     CloseHandle(m_mutexHandle);
     m_mutexHandle = nullptr;
   }
+  m_updateNotifier.close();
 }
 
 void Tracker::updateSharedMemory() {
+  uint64_t nowTick = GetTickCount64();
+  refreshStatsSnapshot(nowTick, false);
   if (!m_sharedData || !m_mutexHandle)
     return;
+  std::shared_ptr<const StatsSnapshot> stats =
+      std::atomic_load(&m_statsSnapshot);
 
   // Acquire mutex
   WaitForSingleObject(m_mutexHandle, 100);
 
   // Update player stats
-  m_sharedData->totalKills = m_playerStats.totalKills;
-  m_sharedData->totalLootItems = m_playerStats.totalLootItems;
-  m_sharedData->totalGold = m_playerStats.totalGold;
-  m_sharedData->totalExp = m_playerStats.totalExp;
-  m_sharedData->goldSpent = m_playerStats.goldSpent;
-  m_sharedData->totalDamage = m_playerStats.totalDamage;
+  const CombatStats &player = stats->player;
+  m_sharedData->totalKills = player.totalKills;
+  m_sharedData->totalLootItems = player.totalLootItems;
+  m_sharedData->totalGold = player.totalGold;
+  m_sharedData->totalExp = player.totalExp;
+  m_sharedData->goldSpent = player.goldSpent;
+  m_sharedData->totalDamage = player.totalDamage;
 
   // Update party stats
-  m_sharedData->partyKills = m_partyStats.totalKills;
-  m_sharedData->partyLootItems = m_partyStats.totalLootItems;
-  m_sharedData->partyGold = m_partyStats.totalGold;
-  m_sharedData->partyExp = m_partyStats.totalExp;
+  const CombatStats &party = stats->party;
+  m_sharedData->partyKills = party.totalKills;
+  m_sharedData->partyLootItems = party.totalLootItems;
+  m_sharedData->partyGold = party.totalGold;
+  m_sharedData->partyExp = party.totalExp;
 
   // Update loot by quality
-  for (int i = 0; i < 6; i++) {
-    auto it = m_playerStats.lootByQuality.find(static_cast<ItemQuality>(i));
-    m_sharedData->lootByQuality[i] =
-        (it != m_playerStats.lootByQuality.end()) ? it->second : 0;
-  }
+  for (int i = 0; i < 6; i++)
+    m_sharedData->lootByQuality[i] = player.lootByQuality[i];
+
+  // Loot value at vendor price
+  m_sharedData->itemValue = player.itemValue;
+  m_sharedData->netGold = player.netGold();
+  for (int i = 0; i < 6; i++)
+    m_sharedData->lootValueByQuality[i] = player.valueByQuality[i];
 
   m_sharedData->overlayVisible = m_overlayVisible;
 
-  // Copy debug text
-  extern char g_debugText[512];
-  memcpy(m_sharedData->debugText, g_debugText, sizeof(g_debugText));
+  // Chat flood counters
+  ChatRateLimiter::getInstance().publish(m_sharedData);
+
+  // Rolling DPS and combat state
+  int64_t nowEpoch = std::chrono::duration_cast<std::chrono::milliseconds>(
+                         std::chrono::system_clock::now().time_since_epoch())
+                         .count();
+  CombatMeter::getInstance().publish(m_sharedData, nowTick, nowEpoch);
+
+  // Damage by target and by spell
+  DamageBreakdown::getInstance().publish(m_sharedData);
+
+  // Hit-size percentiles (per spell follows the topSpells just published)
+  HitSizeStats::getInstance().publish(m_sharedData);
+  DropRates::getInstance().publish(m_sharedData);
+
+  // Recent pace and the time-to-level projection from it
+  m_sharedData->sessionElapsedMs = (int64_t)(nowTick - m_sessionStartTick);
+  SessionRates::getInstance().publish(m_sharedData, nowTick);
+
+  // Completed seconds into the time-series rings
+  SeriesRecorder::getInstance().flush(m_sharedData->history, nowTick,
+                                      nowEpoch);
+
+  // TSC rate for the hook timings, measured against QPC since startup
+  LARGE_INTEGER qpcNow, qpcFreq;
+  QueryPerformanceCounter(&qpcNow);
+  QueryPerformanceFrequency(&qpcFreq);
+  int64_t qpcElapsed = qpcNow.QuadPart - m_tscCalibrationQpc;
+  if (qpcElapsed > qpcFreq.QuadPart / 10) {
+    double elapsedUs = qpcElapsed * 1e6 / (double)qpcFreq.QuadPart;
+    m_sharedData->tscTicksPerUs =
+        (double)(__rdtsc() - m_tscCalibrationTsc) / elapsedUs;
+  }
+  OverheadGovernor::getInstance().publish(m_sharedData);
+  m_sharedData->arenaHeapAllocations = HookArena::heapAllocations();
+  auto &bridge = GameBridge::getInstance();
+  m_sharedData->itemDbItems = bridge.itemDatabaseCount();
+  for (int i = 0; i < NAME_CACHES; i++) {
+    m_sharedData->nameCacheHits[i] = bridge.nameCacheHits((NameCacheId)i);
+    m_sharedData->nameCacheMisses[i] = bridge.nameCacheMisses((NameCacheId)i);
+  }
+  SessionArchiver::getInstance().publish(m_sharedData);
+
+  // Hook registry state for the Debug tab's toggles
+  EventHooks &hooks = EventHooks::getInstance();
+  for (int i = 0; i < HOOK_COUNT; i++) {
+    HookId hook = (HookId)i;
+    if (!hooks.isHookInstalled(hook))
+      m_sharedData->hookState[i] = HOOK_STATE_MISSING;
+    else
+      m_sharedData->hookState[i] =
+          hooks.isHookEnabled(hook) ? HOOK_STATE_ON : HOOK_STATE_OFF;
+  }
+  m_sharedData->hookInstallUs = hooks.installMicros();
+  for (int i = 0; i < INIT_STAGES; i++)
+    m_sharedData->initStageMs[i] = m_initStageMs[i];
 
   // Sync recent loot entries (last 10)
-  int lootCount = (int)m_lootHistory.size();
-  m_sharedData->recentLootIndex = lootCount % 10;
+  std::lock_guard<std::mutex> historyLock(m_historyLock);
+  m_sharedData->recentLootIndex = (int)(m_lootHistory.total() % 10);
   for (int i = 0; i < 10; i++) {
-    if (i < lootCount) {
-      int srcIdx = (lootCount > 10) ? (lootCount - 10 + i) : i;
-      const LootEntry &src = m_lootHistory[srcIdx];
+    if (i < (int)m_lootHistory.size()) {
+      const LootEntry &src = m_lootHistory[i];
       strncpy(m_sharedData->recentLoot[i].itemName, src.itemName.c_str(), 63);
       m_sharedData->recentLoot[i].itemName[63] = '\0';
       m_sharedData->recentLoot[i].quality = (uint8_t)src.quality;
@@ -1115,12 +2991,10 @@ void Tracker::updateSharedMemory() {
   }
 
   // Sync recent kills (last 10)
-  int killCount = (int)m_killHistory.size();
-  m_sharedData->recentKillIndex = killCount % 10;
+  m_sharedData->recentKillIndex = (int)(m_killHistory.total() % 10);
   for (int i = 0; i < 10; i++) {
-    if (i < killCount) {
-      int srcIdx = (killCount > 10) ? (killCount - 10 + i) : i;
-      const KillEntry &src = m_killHistory[srcIdx];
+    if (i < (int)m_killHistory.size()) {
+      const KillEntry &src = m_killHistory[i];
       strncpy(m_sharedData->recentKills[i].mobName, src.mobName.c_str(), 63);
       m_sharedData->recentKills[i].mobName[63] = '\0';
       m_sharedData->recentKills[i].expGained = src.expGained;
@@ -1130,8 +3004,24 @@ void Tracker::updateSharedMemory() {
     }
   }
 
+  // Readers repaint when the version moves, so a tick that republished the
+  // same content leaves it (and the GUI) alone
+  uint64_t contentHash = PublishedContentHash(*m_sharedData);
+  bool changed = contentHash != m_publishedHash;
+  if (changed) {
+    m_publishedHash = contentHash;
+    LARGE_INTEGER qpc;
+    QueryPerformanceCounter(&qpc);
+    m_sharedData->publishQpc = qpc.QuadPart;
+    m_sharedData->version = m_sharedData->version + 1;
+  }
+
   // Release mutex
   ReleaseMutex(m_mutexHandle);
+
+  // Wake the GUI
+  if (changed)
+    m_updateNotifier.signal();
 }
 
 } // namespace DreadmystTracker
@@ -1143,18 +3033,29 @@ BOOL APIENTRY DllMain(HMODULE hModule, DWORD reason, LPVOID lpReserved) {
   using namespace DreadmystTracker;
 
   switch (reason) {
-  case DLL_PROCESS_ATTACH:
+  case DLL_PROCESS_ATTACH: {
     DisableThreadLibraryCalls(hModule);
-    // Initialize on a separate thread to not block game loading
-    CreateThread(
+    // Initialize on a separate thread to not block game loading. The thread
+    // holds its own reference to the DLL, taken here so it exists before
+    // the thread does, and drops it as it exits; a FreeLibrary meanwhile
+    // can't unmap the code it is running. If the thread can't be created
+    // the reference just keeps the DLL loaded.
+    HMODULE self = nullptr;
+    if (!GetModuleHandleExA(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS,
+                            (LPCSTR)hModule, &self))
+      break;
+    HANDLE thread = CreateThread(
         nullptr, 0,
-        [](LPVOID) -> DWORD {
-          Sleep(3000); // Wait for game to fully initialize
+        [](LPVOID module) -> DWORD {
+          // Polls for the game to be ready before hooking
           Tracker::getInstance().initialize();
-          return 0;
+          FreeLibraryAndExitThread((HMODULE)module, 0);
         },
-        nullptr, 0, nullptr);
+        self, 0, nullptr);
+    if (thread)
+      CloseHandle(thread);
     break;
+  }
 
   case DLL_PROCESS_DETACH:
     Tracker::getInstance().shutdown();
@@ -1163,10 +3064,16 @@ BOOL APIENTRY DllMain(HMODULE hModule, DWORD reason, LPVOID lpReserved) {
   return TRUE;
 }
 
+// Exports go through the command ring so they're applied at the tick's safe
+// point like GUI requests; before the tracker is running they apply directly
 extern "C" __declspec(dllexport) void ToggleOverlay() {
-  DreadmystTracker::Tracker::getInstance().toggleOverlay();
+  auto &tracker = DreadmystTracker::Tracker::getInstance();
+  if (!tracker.queueCommand(CMD_TOGGLE_OVERLAY))
+    tracker.toggleOverlay();
 }
 
 extern "C" __declspec(dllexport) void ResetStats() {
-  DreadmystTracker::Tracker::getInstance().resetStats();
+  auto &tracker = DreadmystTracker::Tracker::getInstance();
+  if (!tracker.queueCommand(CMD_RESET_STATS))
+    tracker.resetStats();
 }
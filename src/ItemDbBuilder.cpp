@@ -0,0 +1,246 @@
+// Offline builder for the tracker's item table (see ItemDatabase.h).
+// Reads item rows exported from the game's item_template and writes the
+// binary file the DLL memory-maps at startup.
+//
+// Input: one item per line, "id,quality,vendorValue,iconId,name". The name
+// is last so it may contain commas. Blank lines, lines starting with '#'
+// and a non-numeric header row are skipped.
+#include "ItemDatabase.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+struct SourceItem {
+  uint16_t id;
+  uint8_t quality;
+  uint32_t vendorValue;
+  uint16_t iconId;
+  std::string name;
+};
+
+static bool ParseField(const std::string &line, size_t &pos, uint32_t max,
+                       uint32_t &out) {
+  size_t comma = line.find(',', pos);
+  if (comma == std::string::npos || comma == pos)
+    return false;
+  char *end = nullptr;
+  unsigned long value = strtoul(line.c_str() + pos, &end, 10);
+  if (end != line.c_str() + comma || value > max)
+    return false;
+  out = (uint32_t)value;
+  pos = comma + 1;
+  return true;
+}
+
+static bool ReadItems(const char *path, std::vector<SourceItem> &items) {
+  std::ifstream in(path);
+  if (!in) {
+    std::cerr << "ERROR: cannot open " << path << "\n";
+    return false;
+  }
+
+  std::vector<bool> seen(65536, false);
+  std::string line;
+  int lineNo = 0;
+  while (std::getline(in, line)) {
+    lineNo++;
+    if (!line.empty() && line.back() == '\r')
+      line.pop_back();
+    if (line.empty() || line[0] == '#')
+      continue;
+    if (lineNo == 1 && (line[0] < '0' || line[0] > '9'))
+      continue; // Header row
+
+    uint32_t id, quality, vendorValue, iconId;
+    size_t pos = 0;
+    if (!ParseField(line, pos, 0xFFFF, id) ||
+        !ParseField(line, pos, 5, quality) ||
+        !ParseField(line, pos, 0xFFFFFFFF, vendorValue) ||
+        !ParseField(line, pos, 0xFFFF, iconId) || pos >= line.size()) {
+      std::cerr << "ERROR: " << path << ":" << lineNo
+                << ": expected id,quality,vendorValue,iconId,name\n";
+      return false;
+    }
+    if (seen[id]) {
+      std::cerr << "ERROR: " << path << ":" << lineNo << ": duplicate id "
+                << id << "\n";
+      return false;
+    }
+    seen[id] = true;
+
+    std::string name = line.substr(pos);
+    if (name.size() > 0xFFFF)
+      name.resize(0xFFFF);
+    items.push_back({(uint16_t)id, (uint8_t)quality, vendorValue,
+                     (uint16_t)iconId, name});
+  }
+  return true;
+}
+
+// Hash and displace: ids go to buckets by the seeded first hash; buckets are
+// placed largest first, each searching for a second-hash seed that puts all
+// its ids in free slots. Single-id buckets take any free slot directly.
+static bool BuildPerfectHash(const std::vector<SourceItem> &items,
+                             uint32_t hashSeed,
+                             std::vector<int32_t> &displacement,
+                             std::vector<uint32_t> &slotOf) {
+  constexpr uint32_t MAX_SEED = 1u << 20;
+  uint32_t n = (uint32_t)items.size();
+  std::vector<std::vector<uint32_t>> buckets(n);
+  for (uint32_t i = 0; i < n; i++)
+    buckets[ItemDbHash(items[i].id, hashSeed) % n].push_back(i);
+
+  std::vector<uint32_t> order(n);
+  for (uint32_t b = 0; b < n; b++)
+    order[b] = b;
+  std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+    return buckets[a].size() > buckets[b].size();
+  });
+
+  displacement.assign(n, 0);
+  slotOf.assign(n, 0);
+  std::vector<bool> taken(n, false);
+  std::vector<uint32_t> slots;
+  uint32_t nextFree = 0;
+
+  for (uint32_t b : order) {
+    const std::vector<uint32_t> &bucket = buckets[b];
+    if (bucket.empty())
+      break; // Sorted, so the rest are empty too
+
+    if (bucket.size() == 1) {
+      while (taken[nextFree])
+        nextFree++;
+      taken[nextFree] = true;
+      slotOf[bucket[0]] = nextFree;
+      displacement[b] = -(int32_t)nextFree - 1;
+      continue;
+    }
+
+    bool placed = false;
+    for (uint32_t seed = 1; seed < MAX_SEED && !placed; seed++) {
+      slots.clear();
+      placed = true;
+      for (uint32_t item : bucket) {
+        uint32_t slot = ItemDbHash(items[item].id, seed) % n;
+        if (taken[slot] ||
+            std::find(slots.begin(), slots.end(), slot) != slots.end()) {
+          placed = false;
+          break;
+        }
+        slots.push_back(slot);
+      }
+      if (placed) {
+        for (size_t i = 0; i < bucket.size(); i++) {
+          taken[slots[i]] = true;
+          slotOf[bucket[i]] = slots[i];
+        }
+        displacement[b] = (int32_t)seed;
+      }
+    }
+    if (!placed)
+      return false;
+  }
+  return true;
+}
+
+template <typename T>
+static void WriteSection(std::ofstream &out, const std::vector<T> &values) {
+  if (!values.empty())
+    out.write((const char *)values.data(), values.size() * sizeof(T));
+}
+
+int main(int argc, char *argv[]) {
+  if (argc != 3) {
+    std::cerr << "usage: ItemDbBuilder <items.csv> <" << ITEM_DB_FILE_NAME
+              << ">\n";
+    return 1;
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  std::vector<SourceItem> items;
+  if (!ReadItems(argv[1], items))
+    return 1;
+  if (items.empty()) {
+    std::cerr << "ERROR: no items in " << argv[1] << "\n";
+    return 1;
+  }
+
+  std::vector<int32_t> displacement;
+  std::vector<uint32_t> slotOf;
+  uint32_t hashSeed = 0;
+  while (!BuildPerfectHash(items, hashSeed, displacement, slotOf)) {
+    if (++hashSeed == 64) {
+      std::cerr << "ERROR: no perfect hash found\n";
+      return 1;
+    }
+  }
+
+  // Records in slot order, names packed behind them
+  uint32_t n = (uint32_t)items.size();
+  std::vector<ItemDbRecord> records(n);
+  std::vector<ItemDbName> names(n);
+  std::vector<char> strings;
+  for (uint32_t i = 0; i < n; i++) {
+    const SourceItem &item = items[i];
+    ItemDbRecord &record = records[slotOf[i]];
+    record.id = item.id;
+    record.quality = item.quality;
+    record.reserved = 0;
+    record.nameOffset = (uint32_t)strings.size();
+    record.vendorValue = item.vendorValue;
+    record.iconId = item.iconId;
+    record.nameLength = (uint16_t)item.name.size();
+    strings.insert(strings.end(), item.name.begin(), item.name.end());
+    strings.push_back('\0');
+    names[i] = {ItemDbNameHash(item.name.data(), item.name.size()),
+                slotOf[i]};
+  }
+  std::sort(names.begin(), names.end(),
+            [](const ItemDbName &a, const ItemDbName &b) {
+              return a.hash != b.hash ? a.hash < b.hash : a.slot < b.slot;
+            });
+  while (strings.size() % 4)
+    strings.push_back('\0');
+
+  ItemDbHeader header = {};
+  header.magic = ITEM_DB_MAGIC;
+  header.version = ITEM_DB_VERSION;
+  header.count = n;
+  header.hashSeed = hashSeed;
+  header.displacementOffset = sizeof(ItemDbHeader);
+  header.recordsOffset = header.displacementOffset + n * sizeof(int32_t);
+  header.namesOffset = header.recordsOffset + n * sizeof(ItemDbRecord);
+  header.stringsOffset = header.namesOffset + n * sizeof(ItemDbName);
+  header.stringsSize = (uint32_t)strings.size();
+
+  std::ofstream out(argv[2], std::ios::binary | std::ios::trunc);
+  if (!out) {
+    std::cerr << "ERROR: cannot write " << argv[2] << "\n";
+    return 1;
+  }
+  out.write((const char *)&header, sizeof(header));
+  WriteSection(out, displacement);
+  WriteSection(out, records);
+  WriteSection(out, names);
+  WriteSection(out, strings);
+  out.close();
+  if (!out) {
+    std::cerr << "ERROR: write to " << argv[2] << " failed\n";
+    return 1;
+  }
+
+  double ms = std::chrono::duration<double, std::milli>(
+                  std::chrono::steady_clock::now() - start)
+                  .count();
+  std::cout << "Wrote " << n << " items ("
+            << header.stringsOffset + header.stringsSize << " bytes) to "
+            << argv[2] << " in " << ms << " ms\n";
+  return 0;
+}
@@ -0,0 +1,447 @@
+// Cross-session analytics over session archives (see SessionArchive.h).
+// Builds on Linux and Windows.
+//
+//   SessionAnalyzer [options] <session.dms | directory>...
+//
+//   --by mob|item|quality|hour|date   group key (default mob)
+//   -j N                              worker threads (default: all cores)
+//   --top N                           rows to print (default 20)
+//   --min-quality Q                   quality counted as a "drop" (default 5)
+//
+// Files are spread over a pool of workers. Each worker maps its files and
+// aggregates into its own partial tables with no sharing; the partials are
+// merged once at the end. Events are attributed to the most recent kill's
+// mob, and each event "dwells" until the next one (capped), which is the
+// time base for the per-hour rates.
+#include "SessionArchive.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+enum GroupBy { BY_MOB, BY_ITEM, BY_QUALITY, BY_HOUR, BY_DATE };
+
+struct Options {
+  GroupBy by{BY_MOB};
+  int threads{0};
+  int top{20};
+  int minQuality{5};
+};
+
+struct Aggregate {
+  int64_t events{0};
+  int64_t kills{0};
+  int64_t loot{0};  // Items looted (stack sizes)
+  int64_t drops{0}; // Loot events at --min-quality or better
+  int64_t exp{0};
+  int64_t gold{0};
+  int64_t value{0};
+  int64_t spent{0};
+  int64_t dwellMs{0};
+
+  void merge(const Aggregate &other) {
+    events += other.events;
+    kills += other.kills;
+    loot += other.loot;
+    drops += other.drops;
+    exp += other.exp;
+    gold += other.gold;
+    value += other.value;
+    spent += other.spent;
+    dwellMs += other.dwellMs;
+  }
+};
+
+// One worker's results, or one file's while it is being scanned. Numeric
+// keys (item id, quality, hour) index a flat table; mob names and dates go
+// through a map, resolved once per file. `touched` lists the numeric keys a
+// file used, so its results merge and clear without walking the table.
+struct Partial {
+  std::vector<Aggregate> byNumber;
+  std::vector<uint32_t> touched;
+  std::unordered_map<std::string, Aggregate> byName;
+  Aggregate total;
+  uint64_t bytes{0};
+  uint32_t files{0};
+  uint32_t badFiles{0};
+};
+
+// Events further apart than this are idle time, not time spent farming
+constexpr int64_t MAX_DWELL_MS = 120000;
+
+// Timestamps past year 9999 either way can only come from a corrupt file;
+// they are skipped so local-time arithmetic can't overflow
+constexpr int64_t MAX_TIME_MS = 253402300800000;
+
+constexpr int64_t MS_PER_HOUR = 3600000;
+constexpr int64_t MS_PER_DAY = 86400000;
+
+// Floored division, so times before 1970 land in the right hour and day
+static int64_t FloorDiv(int64_t value, int64_t divisor) {
+  return value / divisor - (value % divisor < 0 ? 1 : 0);
+}
+
+static int NumberKeys(GroupBy by) {
+  switch (by) {
+  case BY_ITEM:
+    return 65536;
+  case BY_QUALITY:
+    return 6;
+  case BY_HOUR:
+    return 24;
+  default:
+    return 0;
+  }
+}
+
+// Local time offset at the session start; DST changes mid-session are
+// ignored, which only shifts hour buckets for that one session
+static int64_t LocalOffsetMs(int64_t epochMs) {
+  time_t sec = (time_t)(epochMs / 1000);
+  struct tm local, utc;
+#ifdef _WIN32
+  if (localtime_s(&local, &sec) != 0 || gmtime_s(&utc, &sec) != 0)
+    return 0;
+#else
+  if (!localtime_r(&sec, &local) || !gmtime_r(&sec, &utc))
+    return 0;
+#endif
+  local.tm_isdst = utc.tm_isdst = 0;
+  return (int64_t)difftime(mktime(&local), mktime(&utc)) * 1000;
+}
+
+static std::string DateKey(int64_t localMs) {
+  time_t sec = (time_t)(FloorDiv(localMs, MS_PER_DAY) * 86400);
+  struct tm day;
+#ifdef _WIN32
+  if (gmtime_s(&day, &sec) != 0)
+    return "(invalid date)";
+#else
+  if (!gmtime_r(&sec, &day))
+    return "(invalid date)";
+#endif
+  char buf[32];
+  snprintf(buf, sizeof(buf), "%04d-%02d-%02d", day.tm_year + 1900,
+           day.tm_mon + 1, day.tm_mday);
+  return buf;
+}
+
+// Aggregates one archive into `partial`, which must start out empty.
+// Returns false if a block turns out to be corrupt.
+static bool ScanFile(const SessionArchive &archive, const Options &options,
+                     Partial &partial) {
+  // Mob names are per file; look each up in the partial once
+  std::vector<Aggregate *> mobs;
+  Aggregate *noMob = nullptr;
+  if (options.by == BY_MOB) {
+    mobs.resize(archive.header().nameCount);
+    for (uint32_t n = 0; n < archive.header().nameCount; n++)
+      mobs[n] = &partial.byName[archive.name(n)];
+    noMob = &partial.byName["(before first kill)"];
+  }
+  Aggregate *currentMob = noMob;
+
+  int64_t offsetMs = LocalOffsetMs(archive.header().startMs);
+  int64_t dateStartMs = 0;
+  Aggregate *date = nullptr;
+
+  bool needId = options.by == BY_MOB || options.by == BY_ITEM;
+  std::vector<int64_t> columns[ARCHIVE_COLUMNS];
+  for (int c = 0; c < ARCHIVE_COLUMNS; c++)
+    if (c != ARCHIVE_COL_ID || needId)
+      columns[c].resize(ARCHIVE_BLOCK_EVENTS);
+
+  for (uint32_t b = 0; b < archive.blockCount(); b++) {
+    for (int c = 0; c < ARCHIVE_COLUMNS; c++) {
+      if (!columns[c].empty() && !archive.decode(b, c, columns[c].data()))
+        return false;
+    }
+    const int64_t *time = columns[ARCHIVE_COL_TIME].data();
+    const int64_t *type = columns[ARCHIVE_COL_TYPE].data();
+    const int64_t *id = needId ? columns[ARCHIVE_COL_ID].data() : nullptr;
+    const int64_t *amount = columns[ARCHIVE_COL_AMOUNT].data();
+    const int64_t *value = columns[ARCHIVE_COL_VALUE].data();
+    const int64_t *quality = columns[ARCHIVE_COL_QUALITY].data();
+
+    const ArchiveBlockInfo &block = archive.block(b);
+    for (uint32_t i = 0; i < block.eventCount; i++) {
+      if (time[i] < -MAX_TIME_MS || time[i] > MAX_TIME_MS)
+        continue;
+
+      // Dwell until the next event, which may start the next block
+      int64_t next = i + 1 < block.eventCount ? time[i + 1]
+                     : b + 1 < archive.blockCount()
+                         ? archive.block(b + 1).min[ARCHIVE_COL_TIME]
+                         : archive.header().endMs;
+      int64_t dwell =
+          next < -MAX_TIME_MS || next > MAX_TIME_MS
+              ? 0
+              : (std::min)((std::max<int64_t>)(next - time[i], 0),
+                           MAX_DWELL_MS);
+      int64_t localMs = time[i] + offsetMs;
+
+      if (type[i] == ARCHIVE_KILL && options.by == BY_MOB)
+        currentMob = id[i] >= 0 && (uint64_t)id[i] < mobs.size()
+                         ? mobs[id[i]]
+                         : noMob;
+
+      Aggregate *group = nullptr;
+      int64_t number = -1;
+      switch (options.by) {
+      case BY_MOB:
+        group = currentMob;
+        break;
+      case BY_ITEM:
+        if (type[i] == ARCHIVE_LOOT && id[i] >= 0 && id[i] < 65536)
+          number = id[i];
+        break;
+      case BY_QUALITY:
+        if (type[i] == ARCHIVE_LOOT && quality[i] >= 0 && quality[i] < 6)
+          number = quality[i];
+        break;
+      case BY_HOUR:
+        number = FloorDiv(localMs, MS_PER_HOUR) % 24;
+        if (number < 0)
+          number += 24;
+        break;
+      case BY_DATE:
+        if (!date || localMs < dateStartMs ||
+            localMs >= dateStartMs + MS_PER_DAY) {
+          dateStartMs = FloorDiv(localMs, MS_PER_DAY) * MS_PER_DAY;
+          date = &partial.byName[DateKey(localMs)];
+        }
+        group = date;
+        break;
+      }
+      if (number >= 0) {
+        group = &partial.byNumber[number];
+        if (group->events == 0)
+          partial.touched.push_back((uint32_t)number);
+      }
+
+      Aggregate *targets[2] = {&partial.total, group};
+      for (Aggregate *a : targets) {
+        if (!a)
+          continue;
+        a->events++;
+        a->dwellMs += dwell;
+        switch (type[i]) {
+        case ARCHIVE_KILL:
+          a->kills++;
+          break;
+        case ARCHIVE_LOOT:
+          a->loot += amount[i];
+          a->value += value[i];
+          if (quality[i] >= options.minQuality)
+            a->drops++;
+          break;
+        case ARCHIVE_GOLD:
+          a->gold += amount[i];
+          break;
+        case ARCHIVE_EXP:
+          a->exp += amount[i];
+          break;
+        case ARCHIVE_SPENT:
+          a->spent += amount[i];
+          break;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+// Empties one file's results for the next file
+static void ClearFile(Partial &file) {
+  for (uint32_t k : file.touched)
+    file.byNumber[k] = Aggregate();
+  file.touched.clear();
+  file.byName.clear();
+  file.total = Aggregate();
+}
+
+// Adds one file's results into a worker's
+static void MergeFile(Partial &into, const Partial &file) {
+  for (uint32_t k : file.touched)
+    into.byNumber[k].merge(file.byNumber[k]);
+  for (const auto &entry : file.byName)
+    into.byName[entry.first].merge(entry.second);
+  into.total.merge(file.total);
+}
+
+// Scans one file; a file that is unreadable or corrupt anywhere contributes
+// nothing but its bad-file count
+static void ScanPath(const std::string &path, const Options &options,
+                     Partial &partial, Partial &scratch) {
+  SessionArchiveFile file;
+  bool ok = file.open(path.c_str()) &&
+            ScanFile(file.archive(), options, scratch);
+  if (ok) {
+    MergeFile(partial, scratch);
+    partial.files++;
+    partial.bytes += file.size();
+  } else {
+    partial.badFiles++; // Blocks scanned before it broke are dropped
+  }
+  ClearFile(scratch);
+}
+
+static void CollectFiles(const char *arg, std::vector<std::string> &files) {
+  std::error_code error;
+  if (std::filesystem::is_directory(arg, error)) {
+    for (const auto &entry :
+         std::filesystem::recursive_directory_iterator(arg, error))
+      if (entry.is_regular_file() &&
+          entry.path().extension() == ARCHIVE_FILE_EXTENSION)
+        files.push_back(entry.path().string());
+  } else {
+    files.push_back(arg);
+  }
+}
+
+static bool ParseOptions(int argc, char *argv[], Options &options,
+                         std::vector<std::string> &files) {
+  static const char *const GROUP_NAMES[] = {"mob", "item", "quality", "hour",
+                                            "date"};
+  for (int i = 1; i < argc; i++) {
+    bool hasValue = i + 1 < argc;
+    if (strcmp(argv[i], "--by") == 0 && hasValue) {
+      int g = 0;
+      while (g < 5 && strcmp(GROUP_NAMES[g], argv[i + 1]) != 0)
+        g++;
+      if (g == 5) {
+        fprintf(stderr, "ERROR: unknown group %s\n", argv[i + 1]);
+        return false;
+      }
+      options.by = (GroupBy)g;
+      i++;
+    } else if (strcmp(argv[i], "-j") == 0 && hasValue) {
+      options.threads = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--top") == 0 && hasValue) {
+      options.top = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--min-quality") == 0 && hasValue) {
+      options.minQuality = atoi(argv[++i]);
+    } else if (argv[i][0] == '-') {
+      fprintf(stderr, "ERROR: unknown option %s\n", argv[i]);
+      return false;
+    } else {
+      CollectFiles(argv[i], files);
+    }
+  }
+  return true;
+}
+
+int main(int argc, char *argv[]) {
+  Options options;
+  std::vector<std::string> files;
+  if (!ParseOptions(argc, argv, options, files) || files.empty()) {
+    fprintf(stderr,
+            "usage: SessionAnalyzer [--by mob|item|quality|hour|date] [-j N] "
+            "[--top N] [--min-quality Q] <session%s | dir>...\n",
+            ARCHIVE_FILE_EXTENSION);
+    return 1;
+  }
+  if (options.threads <= 0)
+    options.threads = (int)(std::max)(1u, std::thread::hardware_concurrency());
+  options.threads = (std::min<int>)(options.threads, (int)files.size());
+
+  auto start = std::chrono::steady_clock::now();
+
+  // Workers take the next file from a shared index until none are left
+  std::vector<Partial> partials(options.threads);
+  std::atomic<size_t> nextFile{0};
+  std::vector<std::thread> workers;
+  for (int t = 0; t < options.threads; t++) {
+    workers.emplace_back([&, t] {
+      Partial &partial = partials[t];
+      Partial scratch;
+      partial.byNumber.resize(NumberKeys(options.by));
+      scratch.byNumber.resize(NumberKeys(options.by));
+      for (size_t f; (f = nextFile.fetch_add(1)) < files.size();)
+        ScanPath(files[f], options, partial, scratch);
+    });
+  }
+  for (std::thread &worker : workers)
+    worker.join();
+
+  // Merge the partials into the first one
+  Partial &merged = partials[0];
+  for (size_t t = 1; t < partials.size(); t++) {
+    const Partial &partial = partials[t];
+    for (size_t k = 0; k < partial.byNumber.size(); k++)
+      merged.byNumber[k].merge(partial.byNumber[k]);
+    for (const auto &entry : partial.byName)
+      merged.byName[entry.first].merge(entry.second);
+    merged.total.merge(partial.total);
+    merged.bytes += partial.bytes;
+    merged.files += partial.files;
+    merged.badFiles += partial.badFiles;
+  }
+
+  double seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+
+  std::vector<std::pair<std::string, const Aggregate *>> rows;
+  for (size_t k = 0; k < merged.byNumber.size(); k++)
+    if (merged.byNumber[k].events > 0)
+      rows.emplace_back(options.by == BY_HOUR ? (k < 10 ? "0" : "") +
+                                                    std::to_string(k) + ":00"
+                                              : std::to_string(k),
+                        &merged.byNumber[k]);
+  for (const auto &entry : merged.byName)
+    if (entry.second.events > 0)
+      rows.emplace_back(entry.first, &entry.second);
+
+  // Time buckets read best in order; everything else busiest first
+  if (options.by == BY_HOUR || options.by == BY_DATE ||
+      options.by == BY_QUALITY)
+    std::sort(rows.begin(), rows.end(), [&](const auto &a, const auto &b) {
+      return options.by == BY_DATE ? a.first < b.first
+                                   : atoi(a.first.c_str()) <
+                                         atoi(b.first.c_str());
+    });
+  else
+    std::sort(rows.begin(), rows.end(), [](const auto &a, const auto &b) {
+      return a.second->events > b.second->events;
+    });
+
+  // Item and quality rows have no kills or play time of their own; they are
+  // rated against the whole scan (per hour played, per 1000 kills)
+  int64_t allKills = merged.total.kills;
+  printf("%-24s %9s %8s %8s %6s %10s %10s %10s %11s\n", "group", "events",
+         "kills", "loot", "drops", "xp/hr", "gold/hr", "value/hr",
+         "drops/1k k");
+  int printed = 0;
+  for (const auto &row : rows) {
+    if (printed++ == options.top)
+      break;
+    const Aggregate &a = *row.second;
+    bool perDrop = options.by == BY_ITEM || options.by == BY_QUALITY;
+    double hours = (perDrop ? merged.total : a).dwellMs / 3600000.0;
+    int64_t kills = perDrop ? allKills : a.kills;
+    printf("%-24.24s %9lld %8lld %8lld %6lld %10.0f %10.0f %10.0f %11.2f\n",
+           row.first.c_str(), (long long)a.events, (long long)a.kills,
+           (long long)a.loot, (long long)a.drops,
+           hours > 0 ? a.exp / hours : 0.0, hours > 0 ? a.gold / hours : 0.0,
+           hours > 0 ? a.value / hours : 0.0,
+           kills > 0 ? (perDrop ? a.events : a.drops) * 1000.0 / kills
+                     : 0.0);
+  }
+
+  printf("\n%u files (%u unreadable), %.1f MB, %lld events in %.3f s on %d "
+         "threads: %.1f M events/s\n",
+         merged.files, merged.badFiles, merged.bytes / 1048576.0,
+         (long long)merged.total.events, seconds, options.threads,
+         seconds > 0 ? merged.total.events / seconds / 1e6 : 0.0);
+  return 0;
+}
@@ -0,0 +1,198 @@
+// Command-line reader for session archives (see SessionArchive.h). Builds on
+// Linux and Windows; the files are memory-mapped, so only the blocks and
+// columns a command needs are ever paged in and decoded.
+//
+//   SessionArchiveTool info <session.dms>
+//   SessionArchiveTool dump <session.dms> [filters]
+//   SessionArchiveTool sum  <session.dms> [filters]
+//
+// Filters: --type kill|loot|gold|exp|spent, --from <epoch ms>, --to <epoch ms>
+#include "SessionArchive.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+struct Filter {
+  int64_t typeLo{1}, typeHi{ARCHIVE_EVENT_TYPES - 1};
+  int64_t fromMs{INT64_MIN}, toMs{INT64_MAX};
+};
+
+static const char *const COLUMN_NAMES[ARCHIVE_COLUMNS] = {
+    "time", "type", "id", "amount", "value", "quality"};
+
+static bool ParseFilter(int argc, char *argv[], int first, Filter &filter) {
+  for (int i = first; i < argc; i += 2) {
+    if (i + 1 >= argc) {
+      fprintf(stderr, "ERROR: %s needs a value\n", argv[i]);
+      return false;
+    }
+    if (strcmp(argv[i], "--type") == 0) {
+      int type = 1;
+      while (type < ARCHIVE_EVENT_TYPES &&
+             strcmp(ArchiveEventTypeName(type), argv[i + 1]) != 0)
+        type++;
+      if (type == ARCHIVE_EVENT_TYPES) {
+        fprintf(stderr, "ERROR: unknown event type %s\n", argv[i + 1]);
+        return false;
+      }
+      filter.typeLo = filter.typeHi = type;
+    } else if (strcmp(argv[i], "--from") == 0) {
+      filter.fromMs = strtoll(argv[i + 1], nullptr, 10);
+    } else if (strcmp(argv[i], "--to") == 0) {
+      filter.toMs = strtoll(argv[i + 1], nullptr, 10);
+    } else {
+      fprintf(stderr, "ERROR: unknown option %s\n", argv[i]);
+      return false;
+    }
+  }
+  return true;
+}
+
+// Block statistics decide whether a block is worth decoding at all
+static bool BlockMayMatch(const SessionArchive &archive, uint32_t b,
+                          const Filter &filter) {
+  return archive.blockMayMatch(b, ARCHIVE_COL_TYPE, filter.typeLo,
+                               filter.typeHi) &&
+         archive.blockMayMatch(b, ARCHIVE_COL_TIME, filter.fromMs,
+                               filter.toMs);
+}
+
+static bool Matches(const int64_t *time, const int64_t *type, uint32_t i,
+                    const Filter &filter) {
+  return type[i] >= filter.typeLo && type[i] <= filter.typeHi &&
+         time[i] >= filter.fromMs && time[i] <= filter.toMs;
+}
+
+static int Info(const SessionArchiveFile &file) {
+  const SessionArchive &archive = file.archive();
+  const ArchiveHeader &header = archive.header();
+  printf("Session   %lld .. %lld ms (%.1f min)\n", (long long)header.startMs,
+         (long long)header.endMs, (header.endMs - header.startMs) / 60000.0);
+  printf("Events    %u in %u blocks, %zu bytes (%.2f bytes/event)\n",
+         header.eventCount, header.blockCount, file.size(),
+         header.eventCount ? (double)file.size() / header.eventCount : 0.0);
+  printf("Mob names %u\n\n", header.nameCount);
+
+  printf("%-8s %10s %12s %12s\n", "column", "bytes", "min", "max");
+  for (int c = 0; c < ARCHIVE_COLUMNS; c++) {
+    uint64_t bytes = 0;
+    int64_t lo = 0, hi = 0;
+    for (uint32_t b = 0; b < archive.blockCount(); b++) {
+      const ArchiveBlockInfo &block = archive.block(b);
+      bytes += block.size[c];
+      if (b == 0 || block.min[c] < lo)
+        lo = block.min[c];
+      if (b == 0 || block.max[c] > hi)
+        hi = block.max[c];
+    }
+    printf("%-8s %10llu %12lld %12lld\n", COLUMN_NAMES[c],
+           (unsigned long long)bytes, (long long)lo, (long long)hi);
+  }
+  return 0;
+}
+
+static int Dump(const SessionArchiveFile &file, const Filter &filter) {
+  const SessionArchive &archive = file.archive();
+  std::vector<int64_t> columns[ARCHIVE_COLUMNS];
+  for (auto &column : columns)
+    column.resize(ARCHIVE_BLOCK_EVENTS);
+
+  printf("time,type,id,amount,value,quality,name\n");
+  for (uint32_t b = 0; b < archive.blockCount(); b++) {
+    if (!BlockMayMatch(archive, b, filter))
+      continue;
+    for (int c = 0; c < ARCHIVE_COLUMNS; c++) {
+      if (!archive.decode(b, c, columns[c].data())) {
+        fprintf(stderr, "ERROR: block %u column %s is corrupt\n", b,
+                COLUMN_NAMES[c]);
+        return 1;
+      }
+    }
+    const int64_t *time = columns[ARCHIVE_COL_TIME].data();
+    const int64_t *type = columns[ARCHIVE_COL_TYPE].data();
+    const int64_t *id = columns[ARCHIVE_COL_ID].data();
+    for (uint32_t i = 0; i < archive.block(b).eventCount; i++) {
+      if (!Matches(time, type, i, filter))
+        continue;
+      printf("%lld,%s,%lld,%lld,%lld,%lld,%s\n", (long long)time[i],
+             ArchiveEventTypeName(type[i]), (long long)id[i],
+             (long long)columns[ARCHIVE_COL_AMOUNT][i],
+             (long long)columns[ARCHIVE_COL_VALUE][i],
+             (long long)columns[ARCHIVE_COL_QUALITY][i],
+             type[i] == ARCHIVE_KILL ? archive.name(id[i]) : "");
+    }
+  }
+  return 0;
+}
+
+// Totals of amount and value: decodes four of the six columns, and only in
+// blocks the statistics can't rule out
+static int Sum(const SessionArchiveFile &file, const Filter &filter) {
+  static const int USED[] = {ARCHIVE_COL_TIME, ARCHIVE_COL_TYPE,
+                             ARCHIVE_COL_AMOUNT, ARCHIVE_COL_VALUE};
+  const SessionArchive &archive = file.archive();
+  std::vector<int64_t> columns[ARCHIVE_COLUMNS];
+  for (int c : USED)
+    columns[c].resize(ARCHIVE_BLOCK_EVENTS);
+
+  uint64_t events = 0;
+  int64_t amount = 0, value = 0;
+  uint32_t decoded = 0;
+  for (uint32_t b = 0; b < archive.blockCount(); b++) {
+    if (!BlockMayMatch(archive, b, filter))
+      continue;
+    for (int c : USED) {
+      if (!archive.decode(b, c, columns[c].data())) {
+        fprintf(stderr, "ERROR: block %u column %s is corrupt\n", b,
+                COLUMN_NAMES[c]);
+        return 1;
+      }
+    }
+    decoded++;
+    const int64_t *time = columns[ARCHIVE_COL_TIME].data();
+    const int64_t *type = columns[ARCHIVE_COL_TYPE].data();
+    for (uint32_t i = 0; i < archive.block(b).eventCount; i++) {
+      if (!Matches(time, type, i, filter))
+        continue;
+      events++;
+      amount += columns[ARCHIVE_COL_AMOUNT][i];
+      value += columns[ARCHIVE_COL_VALUE][i];
+    }
+  }
+
+  printf("Events %llu  amount %lld  value %lld\n", (unsigned long long)events,
+         (long long)amount, (long long)value);
+  printf("Blocks decoded %u of %u\n", decoded, archive.blockCount());
+  return 0;
+}
+
+int main(int argc, char *argv[]) {
+  bool known = argc >= 3 && (strcmp(argv[1], "info") == 0 ||
+                             strcmp(argv[1], "dump") == 0 ||
+                             strcmp(argv[1], "sum") == 0);
+  if (!known) {
+    fprintf(stderr,
+            "usage: SessionArchiveTool info|dump|sum <session%s> "
+            "[--type T] [--from MS] [--to MS]\n",
+            ARCHIVE_FILE_EXTENSION);
+    return 1;
+  }
+
+  Filter filter;
+  if (!ParseFilter(argc, argv, 3, filter))
+    return 1;
+
+  SessionArchiveFile file;
+  if (!file.open(argv[2])) {
+    fprintf(stderr, "ERROR: %s is not a readable session archive\n", argv[2]);
+    return 1;
+  }
+
+  if (strcmp(argv[1], "info") == 0)
+    return Info(file);
+  if (strcmp(argv[1], "dump") == 0)
+    return Dump(file, filter);
+  return Sum(file, filter);
+}
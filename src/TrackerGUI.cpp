@@ -1,6 +1,10 @@
+#include "SharedTrackerData.h"
+#include "Sparkline.h"
+#include "UpdateNotifier.h"
 #include "resource.h"
 #include <Windows.h>
 #include <cstdint>
+#include <cstdlib>
 #include <cstring>
 #include <cwchar>
 
@@ -71,63 +75,41 @@ bool ExtractEmbeddedFiles() {
   return ok;
 }
 
-// Shared memory structure
-#define TRACKER_SHARED_MEMORY_NAME "DreadmystTrackerSharedMemory"
-#define TRACKER_MUTEX_NAME "DreadmystTrackerMutex"
-
-struct SharedTrackerData {
-  uint32_t magic;
-  int totalKills;
-  int totalLootItems;
-  int64_t totalGold;
-  int totalExp;
-  int64_t goldSpent;
-  int64_t totalDamage;
-  int partyKills;
-  int partyLootItems;
-  int64_t partyGold;
-  int partyExp;
-  int lootByQuality[6];
-  struct RecentLoot {
-    char itemName[64];
-    uint8_t quality;
-    int amount;
-    int64_t timestamp;
-  } recentLoot[10];
-  int recentLootIndex;
-  struct RecentKill {
-    char mobName[64];
-    int expGained;
-    int64_t timestamp;
-  } recentKills[10];
-  int recentKillIndex;
-  bool overlayVisible;
-  int64_t sessionStartTime;
-  char debugText[512];
-  // Chat filter settings
-  bool chatFilterEnabled;
-  char chatFilterTerms[512];
-  bool blockLinkedItems; // Block messages containing item links
-  bool useRegexFilter;   // Use regex matching instead of simple substring
-};
-
 // Tab IDs - Chat before Debug
-enum Tab { TAB_STATS = 0, TAB_LOOT = 1, TAB_FILTER = 2, TAB_DEBUG = 3 };
+enum Tab {
+  TAB_STATS = 0,
+  TAB_LOOT = 1,
+  TAB_FILTER = 2,
+  TAB_DEBUG = 3,
+  TAB_COMBAT = 4,
+  TAB_COUNT
+};
 static int g_activeTab = TAB_STATS;
 static int g_hoverTab = -1;
 
+// Right-click menu refresh rate choices
+const int REFRESH_RATES_MS[] = {100, 250, 1000};
+const int REFRESH_RATE_COUNT = 3;
+const int MENU_REFRESH_BASE = 100;
+
+// Right-click menu kill-to-loot join windows for the Drops view
+const int DROP_WINDOWS_MS[] = {5000, 10000, 30000, 60000};
+const int DROP_WINDOW_COUNT = 4;
+const int MENU_DROP_WINDOW_BASE = 110;
+
 // Tab button rectangles
-static RECT g_tabRects[4];
+static RECT g_tabRects[TAB_COUNT];
 
 // Global state
 HWND g_hwnd = nullptr;
 HANDLE g_sharedMem = nullptr;
 HANDLE g_mutex = nullptr;
+UpdateNotifier g_updateNotifier; // Signaled by the DLL after each publish
 SharedTrackerData *g_data = nullptr;
+uint32_t g_lastCommandSeq = 0; // Newest command sent to the DLL
 bool g_dragging = false;
 POINT g_dragStart = {0, 0};
 POINT g_windowStart = {0, 0};
-int64_t g_guiStartTime = 0; // Session start for DPS calculation
 
 // Quality colors
 const COLORREF QUALITY_COLORS[] = {
@@ -156,6 +138,8 @@ const COLORREF CLR_TEXT_DIM = RGB(140, 140, 140);
 // Forward declarations for filter state (definitions later in file)
 static char g_filterTerms[512];
 static HWND g_hFilterEdit;
+static HWND g_hRateLimitEdit;
+static bool g_rateLimitEditPending = false; // Typed, not yet sent
 
 // Connect to shared memory
 bool ConnectSharedMemory() {
@@ -172,19 +156,23 @@ bool ConnectSharedMemory() {
     return false;
   }
 
-  // Set default filter terms if empty
-  if (g_data->chatFilterTerms[0] == '\0') {
-    strcpy_s(g_data->chatFilterTerms, sizeof(g_data->chatFilterTerms),
-             "wts, wtb, wtt, sell, offer, cheap, obo, \\[.*\\]");
-  }
+  // A fresh DLL starts a fresh command ring
+  g_lastCommandSeq = 0;
 
   // Sync local filter terms from shared memory
   strcpy_s(g_filterTerms, sizeof(g_filterTerms), g_data->chatFilterTerms);
   if (g_hFilterEdit) {
     SetWindowTextA(g_hFilterEdit, g_filterTerms);
   }
+  if (g_hRateLimitEdit) {
+    char rate[16];
+    _itoa_s(g_data->chatRateLimitPerMinute, rate, 10);
+    SetWindowTextA(g_hRateLimitEdit, rate);
+    g_rateLimitEditPending = false; // Our own EN_CHANGE, nothing to send
+  }
 
   g_mutex = OpenMutexA(SYNCHRONIZE, FALSE, TRACKER_MUTEX_NAME);
+  g_updateNotifier.open(TRACKER_UPDATE_EVENT_NAME);
   return true;
 }
 
@@ -201,6 +189,7 @@ void DisconnectSharedMemory() {
     CloseHandle(g_mutex);
     g_mutex = nullptr;
   }
+  g_updateNotifier.close();
 }
 
 // Edit control ID for filter input
@@ -208,39 +197,168 @@ void DisconnectSharedMemory() {
 #define IDC_FILTER_APPLY 1002
 #define IDC_BLOCK_ITEMS_CHECK 1003
 #define IDC_USE_REGEX_CHECK 1004
+#define IDC_RATE_LIMIT_CHECK 1005
+#define IDC_RATE_LIMIT_EDIT 1006
+
+// Typing in the rate limit box sends one command once the typing pauses
+// (or the box loses focus), not one per keystroke
+#define IDT_RATE_LIMIT_DEBOUNCE 1
+const UINT RATE_LIMIT_DEBOUNCE_MS = 400;
 
 // Global edit HWND
 static HWND g_hApplyButton = nullptr;
 static HWND g_hBlockItemsCheck = nullptr;
 static HWND g_hUseRegexCheck = nullptr;
+static HWND g_hRateLimitCheck = nullptr;
+
+// GDI objects used by every paint, created once with the window
+struct GdiResources {
+  HFONT titleFont;
+  HFONT tabFont;
+  HFONT contentFont;
+  HFONT emojiFont;
+  HBRUSH bgBrush;
+  HBRUSH headerBrush;
+  HBRUSH tabNormalBrush;
+  HBRUSH tabHoverBrush;
+  HBRUSH tabActiveBrush;
+  HBRUSH toggleOnBrush;
+  HBRUSH toggleOffBrush;
+  HPEN borderPen;
+  HPEN goldPen;
+  HPEN toggleOnPen;
+  HPEN toggleOffPen;
+};
+static GdiResources g_gdi = {};
+
+// Persistent back buffer; only redrawn when g_backDirty is set
+static HDC g_backDC = nullptr;
+static HBITMAP g_backBitmap = nullptr;
+static HGDIOBJ g_backOldBitmap = nullptr;
+static SIZE g_backSize = {0, 0};
+static bool g_backDirty = true;
+
+// Shared data version last painted (repaint only when it moves)
+static uint32_t g_paintedVersion = 0;
+static bool g_paintedConnected = false;
+
+// Publish-to-display latency in microseconds, one sample per painted version
+static LogHistogram g_latencyHist;
+static uint32_t g_latencyVersion = 0;
+
+// How long to block waiting for the update event before polling anyway
+// (reconnects, and a safety net if a signal is ever missed)
+const DWORD UPDATE_FALLBACK_MS = 500;
+
+// Record how long ago the data now on screen was published
+void RecordDisplayLatency() {
+  if (!g_data || g_data->magic != 0xDEADBEEF || g_data->publishQpc == 0)
+    return;
+  uint32_t version = g_data->version;
+  if (version == g_latencyVersion)
+    return;
+  g_latencyVersion = version;
+
+  LARGE_INTEGER now, freq;
+  QueryPerformanceCounter(&now);
+  QueryPerformanceFrequency(&freq);
+  int64_t elapsed = now.QuadPart - g_data->publishQpc;
+  if (elapsed >= 0)
+    g_latencyHist.record((uint32_t)(elapsed * 1000000 / freq.QuadPart));
+}
 
-// Draw a filled rounded-ish rectangle
-void FillRoundRect(HDC hdc, RECT *r, COLORREF color) {
-  HBRUSH brush = CreateSolidBrush(color);
-  FillRect(hdc, r, brush);
-  DeleteObject(brush);
+void CreateGdiResources() {
+  g_gdi.titleFont =
+      CreateFontW(15, 0, 0, 0, FW_BOLD, FALSE, FALSE, FALSE, DEFAULT_CHARSET, 0,
+                  0, CLEARTYPE_QUALITY, 0, L"Segoe UI");
+  // Segoe UI Symbol for tab icon support
+  g_gdi.tabFont = CreateFontW(12, 0, 0, 0, FW_SEMIBOLD, FALSE, FALSE, FALSE,
+                              DEFAULT_CHARSET, 0, 0, CLEARTYPE_QUALITY, 0,
+                              L"Segoe UI Symbol");
+  g_gdi.contentFont =
+      CreateFontW(13, 0, 0, 0, FW_NORMAL, FALSE, FALSE, FALSE, DEFAULT_CHARSET,
+                  0, 0, CLEARTYPE_QUALITY, 0, L"Segoe UI");
+  g_gdi.emojiFont =
+      CreateFontW(14, 0, 0, 0, FW_NORMAL, FALSE, FALSE, FALSE, DEFAULT_CHARSET,
+                  0, 0, CLEARTYPE_QUALITY, 0, L"Segoe UI Emoji");
+  g_gdi.bgBrush = CreateSolidBrush(CLR_BG);
+  g_gdi.headerBrush = CreateSolidBrush(CLR_HEADER);
+  g_gdi.tabNormalBrush = CreateSolidBrush(CLR_TAB_NORMAL);
+  g_gdi.tabHoverBrush = CreateSolidBrush(CLR_TAB_HOVER);
+  g_gdi.tabActiveBrush = CreateSolidBrush(CLR_TAB_ACTIVE);
+  g_gdi.toggleOnBrush = CreateSolidBrush(RGB(50, 180, 50));
+  g_gdi.toggleOffBrush = CreateSolidBrush(RGB(100, 50, 50));
+  g_gdi.borderPen = CreatePen(PS_SOLID, 1, CLR_BORDER);
+  g_gdi.goldPen = CreatePen(PS_SOLID, 1, CLR_GOLD);
+  g_gdi.toggleOnPen = CreatePen(PS_SOLID, 1, RGB(80, 220, 80));
+  g_gdi.toggleOffPen = CreatePen(PS_SOLID, 1, RGB(150, 80, 80));
 }
 
+void DestroyBackBuffer() {
+  if (g_backDC) {
+    SelectObject(g_backDC, g_backOldBitmap);
+    DeleteObject(g_backBitmap);
+    DeleteDC(g_backDC);
+    g_backDC = nullptr;
+    g_backBitmap = nullptr;
+  }
+}
+
+void DestroyGdiResources() {
+  DestroyBackBuffer();
+  HGDIOBJ objects[] = {
+      g_gdi.titleFont,      g_gdi.tabFont,        g_gdi.contentFont,
+      g_gdi.emojiFont,      g_gdi.bgBrush,        g_gdi.headerBrush,
+      g_gdi.tabNormalBrush, g_gdi.tabHoverBrush,  g_gdi.tabActiveBrush,
+      g_gdi.toggleOnBrush,  g_gdi.toggleOffBrush, g_gdi.borderPen,
+      g_gdi.goldPen,        g_gdi.toggleOnPen,    g_gdi.toggleOffPen};
+  for (HGDIOBJ obj : objects) {
+    if (obj)
+      DeleteObject(obj);
+  }
+  g_gdi = {};
+}
+
+// (Re)create the back buffer when the client size changes
+HDC GetBackBuffer(HDC windowDC, int width, int height) {
+  if (g_backDC && g_backSize.cx == width && g_backSize.cy == height)
+    return g_backDC;
+  DestroyBackBuffer();
+  g_backDC = CreateCompatibleDC(windowDC);
+  g_backBitmap = CreateCompatibleBitmap(windowDC, width, height);
+  g_backOldBitmap = SelectObject(g_backDC, g_backBitmap);
+  g_backSize = {width, height};
+  g_backDirty = true;
+  return g_backDC;
+}
+
+// Mark the back buffer stale and schedule a paint
+void RequestRepaint(HWND hwnd) {
+  g_backDirty = true;
+  InvalidateRect(hwnd, nullptr, FALSE);
+}
+
+// Draw a filled rounded-ish rectangle
+void FillRoundRect(HDC hdc, RECT *r, HBRUSH brush) { FillRect(hdc, r, brush); }
+
 // Draw tab button
 void DrawTab(HDC hdc, int tabIdx, const wchar_t *text, int x, int y, int w,
              int h) {
-  COLORREF color = CLR_TAB_NORMAL;
+  HBRUSH brush = g_gdi.tabNormalBrush;
   if (tabIdx == g_activeTab)
-    color = CLR_TAB_ACTIVE;
+    brush = g_gdi.tabActiveBrush;
   else if (tabIdx == g_hoverTab)
-    color = CLR_TAB_HOVER;
+    brush = g_gdi.tabHoverBrush;
 
   RECT r = {x, y, x + w, y + h};
   g_tabRects[tabIdx] = r;
-  FillRoundRect(hdc, &r, color);
+  FillRoundRect(hdc, &r, brush);
 
   // Border for active tab
   if (tabIdx == g_activeTab) {
-    HPEN pen = CreatePen(PS_SOLID, 1, CLR_GOLD);
-    SelectObject(hdc, pen);
+    SelectObject(hdc, g_gdi.goldPen);
     MoveToEx(hdc, x, y + h - 1, nullptr);
     LineTo(hdc, x + w, y + h - 1);
-    DeleteObject(pen);
   }
 
   SetTextColor(hdc, tabIdx == g_activeTab ? CLR_GOLD : CLR_TEXT);
@@ -251,13 +369,8 @@ void DrawTab(HDC hdc, int tabIdx, const wchar_t *text, int x, int y, int w,
 // regular font
 void DrawEmojiText(HDC hdc, int x, int y, const wchar_t *emoji,
                    const wchar_t *text, HFONT regularFont) {
-  // Create emoji font
-  HFONT emojiFont =
-      CreateFontW(14, 0, 0, 0, FW_NORMAL, FALSE, FALSE, FALSE, DEFAULT_CHARSET,
-                  0, 0, CLEARTYPE_QUALITY, 0, L"Segoe UI Emoji");
-
   // Draw emoji
-  SelectObject(hdc, emojiFont);
+  SelectObject(hdc, g_gdi.emojiFont);
   TextOutW(hdc, x, y, emoji, (int)wcslen(emoji));
 
   // Get emoji width
@@ -267,8 +380,98 @@ void DrawEmojiText(HDC hdc, int x, int y, const wchar_t *emoji,
   // Draw text with regular font
   SelectObject(hdc, regularFont);
   TextOutW(hdc, x + emojiSize.cx + 2, y, text, (int)wcslen(text));
+}
 
-  DeleteObject(emojiFont);
+// Sparkline row on the Stats tab: three charts rendered into one pixel
+// buffer and blitted with a single call
+const int SPARK_W = 86;
+const int SPARK_H = 28;
+const int SPARK_GAP = 6;
+const int SPARK_ROW_W = SPARK_W * 3 + SPARK_GAP * 2;
+const int SPARK_DPS_SECONDS = 90; // DPS chart: per second, last 90s
+const int SPARK_BIN_SECONDS = 60; // XP/gold charts: per minute, last hour
+const int SPARK_HOUR_SECONDS = 3600;
+const int SPARK_MAX_BINS = SPARK_HOUR_SECONDS / SPARK_BIN_SECONDS;
+
+uint32_t g_sparkPixels[SPARK_ROW_W * SPARK_H];
+int64_t g_sparkScratch64[SPARK_HOUR_SECONDS];
+int32_t g_sparkScratch32[SPARK_HOUR_SECONDS];
+float g_sparkValues[SPARK_DPS_SECONDS];
+
+// Sum per-second samples into bins (newest bin last), scaled to per hour
+template <typename T>
+int BinPerHour(const T *samples, int count, float *out, int maxBins) {
+  int bins = count / SPARK_BIN_SECONDS;
+  if (bins > maxBins)
+    bins = maxBins;
+  const T *first = samples + count - bins * SPARK_BIN_SECONDS;
+  for (int b = 0; b < bins; b++) {
+    int64_t sum = 0;
+    for (int i = 0; i < SPARK_BIN_SECONDS; i++)
+      sum += first[b * SPARK_BIN_SECONDS + i];
+    out[b] = (float)sum * (3600.0f / SPARK_BIN_SECONDS);
+  }
+  return bins;
+}
+
+void DrawSparkline(int index, const float *values, int count, uint32_t line) {
+  SparklineCanvas canvas(g_sparkPixels + index * (SPARK_W + SPARK_GAP),
+                         SPARK_W, SPARK_H, SPARK_ROW_W);
+  canvas.clear(SparklineCanvas::argb(255, 30, 30, 50)); // CLR_TAB_NORMAL
+  canvas.drawArea(values, count, 0.0f, (line & 0x00FFFFFF) | 0x50000000);
+  canvas.drawLine(values, count, 0.0f, line);
+}
+
+void DrawSparklines(HDC hdc, int x, int y) {
+  const auto &seconds = g_data->history.perSecond;
+  SparklineCanvas row(g_sparkPixels, SPARK_ROW_W, SPARK_H, SPARK_ROW_W);
+  row.clear(SparklineCanvas::argb(255, 18, 18, 28)); // CLR_BG
+
+  // DPS: damage per second straight from the per-second ring
+  int n = seconds.copyWindow(seconds.damage, SPARK_DPS_SECONDS,
+                             g_sparkScratch64);
+  for (int i = 0; i < n; i++)
+    g_sparkValues[i] = (float)g_sparkScratch64[i];
+  DrawSparkline(0, g_sparkValues, n,
+                SparklineCanvas::argb(255, 255, 150, 50));
+
+  // XP/hr and gold/hr: the last hour in one-minute bins
+  n = seconds.copyWindow(seconds.xp, SPARK_HOUR_SECONDS, g_sparkScratch32);
+  int bins = BinPerHour(g_sparkScratch32, n, g_sparkValues, SPARK_MAX_BINS);
+  DrawSparkline(1, g_sparkValues, bins,
+                SparklineCanvas::argb(255, 138, 43, 226));
+
+  n = seconds.copyWindow(seconds.gold, SPARK_HOUR_SECONDS, g_sparkScratch64);
+  bins = BinPerHour(g_sparkScratch64, n, g_sparkValues, SPARK_MAX_BINS);
+  DrawSparkline(2, g_sparkValues, bins,
+                SparklineCanvas::argb(255, 255, 215, 0));
+
+  BITMAPINFO bmi = {};
+  bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+  bmi.bmiHeader.biWidth = SPARK_ROW_W;
+  bmi.bmiHeader.biHeight = -SPARK_H; // Top-down
+  bmi.bmiHeader.biPlanes = 1;
+  bmi.bmiHeader.biBitCount = 32;
+  bmi.bmiHeader.biCompression = BI_RGB;
+  SetDIBitsToDevice(hdc, x, y, SPARK_ROW_W, SPARK_H, 0, 0, 0, SPARK_H,
+                    g_sparkPixels, &bmi, DIB_RGB_COLORS);
+
+  // Labels over the top-left of each chart
+  SetTextColor(hdc, CLR_TEXT_DIM);
+  const wchar_t *labels[3] = {L"DPS", L"XP/hr", L"Gold/hr"};
+  for (int i = 0; i < 3; i++)
+    TextOutW(hdc, x + i * (SPARK_W + SPARK_GAP) + 3, y, labels[i],
+             (int)wcslen(labels[i]));
+}
+
+// Short gold amounts for tight columns: 950, 12.3k, 4.1M
+void FormatGoldShort(int64_t gold, wchar_t *out, int size) {
+  if (gold >= 1000000 || gold <= -1000000)
+    _snwprintf_s(out, size, _TRUNCATE, L"%.1fM", gold / 1000000.0);
+  else if (gold >= 10000 || gold <= -10000)
+    _snwprintf_s(out, size, _TRUNCATE, L"%.1fk", gold / 1000.0);
+  else
+    _snwprintf_s(out, size, _TRUNCATE, L"%I64d", gold);
 }
 
 // Draw Stats tab content
@@ -276,10 +479,8 @@ void DrawStatsTab(HDC hdc, int startY, RECT *rc) {
   wchar_t buf[256];
   int y = startY;
 
-  // Create regular content font
-  HFONT contentFont =
-      CreateFontW(13, 0, 0, 0, FW_NORMAL, FALSE, FALSE, FALSE, DEFAULT_CHARSET,
-                  0, 0, CLEARTYPE_QUALITY, 0, L"Segoe UI");
+  // Regular content font
+  HFONT contentFont = g_gdi.contentFont;
   SelectObject(hdc, contentFont);
 
   if (g_data && g_data->magic == 0xDEADBEEF) {
@@ -297,13 +498,22 @@ void DrawStatsTab(HDC hdc, int startY, RECT *rc) {
 
     // Gold
     SetTextColor(hdc, CLR_GOLD);
-    wsprintfW(buf, L"Gold: %I64d", g_data->totalGold);
+    if (g_data->itemValue > 0) {
+      // Looted items at vendor price, on top of the raw gold
+      wchar_t value[16];
+      FormatGoldShort(g_data->itemValue, value, 16);
+      _snwprintf_s(buf, 256, _TRUNCATE, L"Gold: %I64d  (+%s in items)",
+                   g_data->totalGold, value);
+    } else {
+      wsprintfW(buf, L"Gold: %I64d", g_data->totalGold);
+    }
     DrawEmojiText(hdc, 15, y, L"\U0001F4B0", buf, contentFont);
     y += 22;
 
-    // Spent (repair costs)
+    // Spent (repair costs), and net: gold plus item value less spending
     SetTextColor(hdc, RGB(255, 100, 100));
-    wsprintfW(buf, L"Spent: %I64d", g_data->goldSpent);
+    _snwprintf_s(buf, 256, _TRUNCATE, L"Spent: %I64d  |  Net: %I64d",
+                 g_data->goldSpent, g_data->netGold);
     DrawEmojiText(hdc, 15, y, L"\U0001F4B8", buf,
                   contentFont); // 💸 money with wings
     y += 22;
@@ -314,40 +524,64 @@ void DrawStatsTab(HDC hdc, int startY, RECT *rc) {
     DrawEmojiText(hdc, 15, y, L"\u2728", buf, contentFont);
     y += 22;
 
-    // Performance metrics (Kills/Min, XP/Hour, DPS)
-    // Use global start time tracked by GUI
-    if (g_guiStartTime == 0)
-      g_guiStartTime = GetTickCount64();
-    int64_t nowMs = GetTickCount64();
-    int64_t sessionMs = nowMs - g_guiStartTime;
-    if (sessionMs < 1000)
-      sessionMs = 1000; // Avoid divide by zero
-
-    double sessionSec = sessionMs / 1000.0;
-    double sessionMin = sessionMs / 60000.0;
-    double sessionHr = sessionMs / 3600000.0;
-    double killsPerMin =
-        g_data->totalKills / (sessionMin > 0.01 ? sessionMin : 0.01);
-    double xpPerHour =
-        g_data->totalExp / (sessionHr > 0.001 ? sessionHr : 0.001);
-
-    // DPS from actual damage only (no XP fallback)
-    double dps = g_data->totalDamage / sessionSec;
-    double dph = dps * 3600.0;
-
+    // Recent pace (10 minute EWMA rates computed by the DLL)
     SetTextColor(hdc, RGB(150, 200, 255));
     _snwprintf_s(buf, 256, _TRUNCATE, L"%.1f kills/min  |  %.0f xp/hr",
-                 killsPerMin, xpPerHour);
+                 g_data->killsPerHour[RATE_10M] / 60.0,
+                 g_data->xpPerHour[RATE_10M]);
+    TextOutW(hdc, 15, y, buf, (int)wcslen(buf));
+    y += 18;
+
+    _snwprintf_s(buf, 256, _TRUNCATE, L"%.0f gold/hr  |  %.0f loot/hr",
+                 g_data->goldPerHour[RATE_10M], g_data->lootPerHour[RATE_10M]);
     TextOutW(hdc, 15, y, buf, (int)wcslen(buf));
     y += 18;
 
-    // DPS display - always show DPS, with 0 if no damage tracked
+    _snwprintf_s(buf, 256, _TRUNCATE, L"%.0f net/hr  |  %.0f item value/hr",
+                 g_data->netGoldPerHour[RATE_10M],
+                 g_data->itemValuePerHour[RATE_10M]);
+    TextOutW(hdc, 15, y, buf, (int)wcslen(buf));
+    y += 18;
+
+    // Session clock, and time to next level (a dash until it can be estimated)
+    int64_t sessionSec = g_data->sessionElapsedMs / 1000;
+    if (g_data->secondsToLevel >= 0) {
+      int64_t eta = g_data->secondsToLevel;
+      _snwprintf_s(buf, 256, _TRUNCATE,
+                   L"Session %I64d:%02d:%02d  |  Lv%d in %I64dh %02dm",
+                   sessionSec / 3600, (int)(sessionSec / 60 % 60),
+                   (int)(sessionSec % 60), g_data->playerLevel + 1, eta / 3600,
+                   (int)(eta / 60 % 60));
+    } else {
+      _snwprintf_s(buf, 256, _TRUNCATE,
+                   L"Session %I64d:%02d:%02d  |  Next level \u2014",
+                   sessionSec / 3600, (int)(sessionSec / 60 % 60),
+                   (int)(sessionSec % 60));
+    }
+    TextOutW(hdc, 15, y, buf, (int)wcslen(buf));
+    y += 18;
+
+    // Rolling DPS windows computed by the DLL
     SetTextColor(hdc, RGB(255, 150, 50)); // Orange for DPS
-    _snwprintf_s(buf, 256, _TRUNCATE, L"DPS: %.1f  |  Dmg: %I64d", dps,
-                 g_data->totalDamage);
+    _snwprintf_s(buf, 256, _TRUNCATE, L"DPS 5s: %.0f  30s: %.0f  60s: %.0f",
+                 g_data->dps5s, g_data->dps30s, g_data->dps60s);
     TextOutW(hdc, 15, y, buf, (int)wcslen(buf));
     y += 18;
-    y += 6;
+
+    // Current fight while in combat, otherwise the last completed fight
+    if (g_data->inCombat) {
+      _snwprintf_s(buf, 256, _TRUNCATE, L"Fight: %.1f dps  |  Dmg: %I64d",
+                   g_data->combatDPS, g_data->totalDamage);
+    } else {
+      _snwprintf_s(buf, 256, _TRUNCATE, L"Last fight: %.1f dps  |  Dmg: %I64d",
+                   g_data->lastCombatDPS, g_data->totalDamage);
+    }
+    TextOutW(hdc, 15, y, buf, (int)wcslen(buf));
+    y += 18;
+    y += 4;
+
+    DrawSparklines(hdc, 15, y);
+    y += SPARK_H + 6;
 
     // Quality breakdown (compact)
     SetTextColor(hdc, CLR_TEXT_DIM);
@@ -358,7 +592,14 @@ void DrawStatsTab(HDC hdc, int startY, RECT *rc) {
     for (int i = 0; i < 6; i++) {
       if (g_data->lootByQuality[i] > 0) {
         SetTextColor(hdc, QUALITY_COLORS[i]);
-        wsprintfW(buf, L"%s:%d", QUALITY_NAMES[i], g_data->lootByQuality[i]);
+        if (g_data->lootValueByQuality[i] > 0) {
+          wchar_t value[16];
+          FormatGoldShort(g_data->lootValueByQuality[i], value, 16);
+          _snwprintf_s(buf, 256, _TRUNCATE, L"%s:%d %sg", QUALITY_NAMES[i],
+                       g_data->lootByQuality[i], value);
+        } else {
+          wsprintfW(buf, L"%s:%d", QUALITY_NAMES[i], g_data->lootByQuality[i]);
+        }
         TextOutW(hdc, 20 + (col % 2) * 110, y, buf, (int)wcslen(buf));
         if (col % 2 == 1)
           y += 16;
@@ -375,7 +616,140 @@ void DrawStatsTab(HDC hdc, int startY, RECT *rc) {
     SetTextColor(hdc, CLR_TEXT_DIM);
     TextOutW(hdc, 15, y, L"Inject DLL first!", 17);
   }
-  DeleteObject(contentFont);
+}
+
+// Draw a "p50 / p90 / p99 / max" line for one hit-size distribution
+void DrawHitSizes(HDC hdc, int x, int y, const wchar_t *label,
+                  const HitSizeSummary &hits) {
+  wchar_t buf[128];
+  if (hits.count == 0) {
+    _snwprintf_s(buf, 128, _TRUNCATE, L"%s  -", label);
+  } else {
+    _snwprintf_s(buf, 128, _TRUNCATE, L"%s  p50 %u  p90 %u  p99 %u  max %u",
+                 label, hits.p50, hits.p90, hits.p99, hits.max);
+  }
+  TextOutW(hdc, x, y, buf, (int)wcslen(buf));
+}
+
+// Draw one ranked damage table (targets or spells). If hit sizes are given
+// (one per source), each row gets a dim percentile line underneath.
+int DrawDamageSources(HDC hdc, int y, RECT *rc, const wchar_t *title,
+                      const wchar_t *label,
+                      const SharedTrackerData::DamageSource *sources, int count,
+                      const HitSizeSummary *hits = nullptr) {
+  wchar_t buf[128];
+
+  SetTextColor(hdc, CLR_TEXT_DIM);
+  TextOutW(hdc, 15, y, title, (int)wcslen(title));
+  y += 18;
+
+  if (sources[0].damage == 0) {
+    TextOutW(hdc, 20, y, L"No damage yet...", 16);
+    return y + 16;
+  }
+
+  int64_t total = g_data->breakdownDamage > 0 ? g_data->breakdownDamage : 1;
+  for (int i = 0; i < count && sources[i].damage > 0; i++) {
+    SetTextColor(hdc, i == 0 ? RGB(255, 150, 50) : CLR_TEXT);
+    _snwprintf_s(buf, 128, _TRUNCATE, L"%s #%d", label, sources[i].id);
+    TextOutW(hdc, 20, y, buf, (int)wcslen(buf));
+
+    _snwprintf_s(buf, 128, _TRUNCATE, L"%I64d  %.0f%%", sources[i].damage,
+                 100.0 * sources[i].damage / total);
+    RECT r = {120, y, rc->right - 15, y + 16};
+    DrawTextW(hdc, buf, -1, &r, DT_RIGHT | DT_SINGLELINE);
+    y += 16;
+
+    if (hits && hits[i].count > 0) {
+      SetTextColor(hdc, CLR_TEXT_DIM);
+      DrawHitSizes(hdc, 30, y, L"", hits[i]);
+      y += 15;
+    }
+
+    if (y > rc->bottom - 20)
+      break;
+  }
+  return y;
+}
+
+// Draw Combat (damage breakdown) tab content
+void DrawCombatTab(HDC hdc, int startY, RECT *rc) {
+  int y = startY;
+
+  if (g_data && g_data->magic == 0xDEADBEEF) {
+    // Hit-size distributions
+    SetTextColor(hdc, RGB(255, 150, 50));
+    DrawHitSizes(hdc, 15, y, L"Hits", g_data->hitDamage);
+    y += 16;
+    DrawHitSizes(hdc, 15, y, L"Fight", g_data->hitDamageFight);
+    y += 16;
+    SetTextColor(hdc, RGB(100, 255, 100));
+    DrawHitSizes(hdc, 15, y, L"Heals", g_data->hitHealing);
+    y += 22;
+
+    y = DrawDamageSources(hdc, y, rc, L"Top Targets:", L"Target",
+                          g_data->topTargets, 4);
+    y += 8;
+    DrawDamageSources(hdc, y, rc, L"Top Spells:", L"Spell", g_data->topSpells,
+                      8, g_data->hitBySpell);
+  } else {
+    SetTextColor(hdc, CLR_TEXT_DIM);
+    TextOutW(hdc, 15, y, L"Not connected", 13);
+  }
+}
+
+// Loot tab views, switched by clicking their headings
+enum LootView { LOOT_VIEW_RECENT, LOOT_VIEW_DROPS, LOOT_VIEWS };
+static int g_lootView = LOOT_VIEW_RECENT;
+static RECT g_lootViewRects[LOOT_VIEWS] = {};
+
+// Per-mob drop rates: each mob's share of kills that dropped anything, then
+// its most frequent items, all with 95% confidence bounds
+void DrawDropRates(HDC hdc, int startY, RECT *rc) {
+  wchar_t buf[128];
+  wchar_t wname[32];
+  int y = startY;
+
+  SetTextColor(hdc, CLR_TEXT_DIM);
+  _snwprintf_s(buf, 128, _TRUNCATE,
+               L"Loot within %d s of a kill, %I64d unmatched",
+               g_data->dropWindowMs / 1000, g_data->dropsUnattributed);
+  TextOutW(hdc, 15, y, buf, (int)wcslen(buf));
+  y += 20;
+
+  int count = g_data->dropMobCount;
+  if (count > 8)
+    count = 8;
+  if (count == 0) {
+    TextOutW(hdc, 15, y, L"No kills yet...", 15);
+    return;
+  }
+
+  for (int i = 0; i < count && y <= rc->bottom - 36; i++) {
+    const MobDrops &mob = g_data->dropMobs[i];
+    MultiByteToWideChar(CP_ACP, 0, mob.name, -1, wname, 32);
+    wname[31] = 0;
+    SetTextColor(hdc, CLR_TEXT);
+    _snwprintf_s(buf, 128, _TRUNCATE, L"%s  %d kills  %.1f%% (%.1f-%.1f)",
+                 wname, mob.kills, mob.dropRate * 100.0f, mob.low * 100.0f,
+                 mob.high * 100.0f);
+    TextOutW(hdc, 15, y, buf, (int)wcslen(buf));
+    y += 16;
+
+    for (int j = 0; j < 3 && mob.items[j].kills > 0; j++) {
+      if (y > rc->bottom - 20)
+        return;
+      const MobDropItem &item = mob.items[j];
+      MultiByteToWideChar(CP_ACP, 0, item.name, -1, wname, 32);
+      wname[31] = 0;
+      SetTextColor(hdc, QUALITY_COLORS[item.quality < 6 ? item.quality : 1]);
+      _snwprintf_s(buf, 128, _TRUNCATE, L"  %s  %.1f%% (%.1f-%.1f)", wname,
+                   item.rate * 100.0f, item.low * 100.0f, item.high * 100.0f);
+      TextOutW(hdc, 15, y, buf, (int)wcslen(buf));
+      y += 15;
+    }
+    y += 5;
+  }
 }
 
 // Draw Loot tab content
@@ -384,10 +758,25 @@ void DrawLootTab(HDC hdc, int startY, RECT *rc) {
   int y = startY;
 
   if (g_data && g_data->magic == 0xDEADBEEF) {
-    SetTextColor(hdc, CLR_TEXT_DIM);
-    TextOutW(hdc, 15, y, L"Recent Loot:", 12);
+    static const wchar_t *const VIEW_NAMES[LOOT_VIEWS] = {L"Recent Loot",
+                                                          L"Drops"};
+    int x = 15;
+    for (int v = 0; v < LOOT_VIEWS; v++) {
+      SIZE size;
+      int len = (int)wcslen(VIEW_NAMES[v]);
+      GetTextExtentPoint32W(hdc, VIEW_NAMES[v], len, &size);
+      SetTextColor(hdc, v == g_lootView ? CLR_GOLD : CLR_TEXT_DIM);
+      TextOutW(hdc, x, y, VIEW_NAMES[v], len);
+      SetRect(&g_lootViewRects[v], x, y, x + size.cx, y + size.cy);
+      x += size.cx + 16;
+    }
     y += 20;
 
+    if (g_lootView == LOOT_VIEW_DROPS) {
+      DrawDropRates(hdc, y, rc);
+      return;
+    }
+
     bool hasLoot = false;
     for (int i = 0; i < 10; i++) {
       int idx = (g_data->recentLootIndex - 1 - i + 10) % 10;
@@ -427,34 +816,136 @@ void DrawLootTab(HDC hdc, int startY, RECT *rc) {
   }
 }
 
+// Hook rows on the Debug tab; clicking one switches that hook on or off
+static RECT g_hookRowRects[HOOK_COUNT] = {};
+
 // Draw Debug tab content
 void DrawDebugTab(HDC hdc, int startY, RECT *rc) {
   int y = startY;
+  for (int i = 0; i < HOOK_COUNT; i++)
+    SetRectEmpty(&g_hookRowRects[i]);
 
   if (g_data && g_data->magic == 0xDEADBEEF) {
+    // Time from the DLL's publish to the frame reaching the screen
+    wchar_t buf[128];
+    SetTextColor(hdc, CLR_TEXT);
+    _snwprintf_s(buf, 128, _TRUNCATE,
+                 L"Update latency p50 %.1f  p99 %.1f  max %.1f ms",
+                 g_latencyHist.percentile(0.50) / 1000.0,
+                 g_latencyHist.percentile(0.99) / 1000.0,
+                 g_latencyHist.max / 1000.0);
+    TextOutW(hdc, 15, y, buf, (int)wcslen(buf));
+    y += 18;
+
+    // Overhead governor: current fidelity and hook time against the budget
+    static const wchar_t *const modeNames[OVERHEAD_MODES] = {
+        L"Full", L"Reduced", L"Minimal"};
+    int mode = g_data->overheadMode;
+    SetTextColor(hdc, mode == OVERHEAD_FULL ? CLR_TEXT : CLR_TEXT_DIM);
+    _snwprintf_s(buf, 128, _TRUNCATE,
+                 L"Mode %s  %.0f/%d \u00B5s/frame  %d switches",
+                 mode >= 0 && mode < OVERHEAD_MODES ? modeNames[mode] : L"?",
+                 g_data->overheadUsPerFrame, g_data->overheadBudgetUs,
+                 g_data->overheadModeSwitches);
+    TextOutW(hdc, 15, y, buf, (int)wcslen(buf));
+    y += 18;
+
+    // Hook-path allocations that missed the per-thread arena, and the size
+    // of the item table (0 = DreadmystItems.bin missing)
     SetTextColor(hdc, CLR_TEXT_DIM);
-    if (g_data->debugText[0] != 0) {
-      char *line = g_data->debugText;
-      for (int lineNum = 0; lineNum < 10 && *line; lineNum++) {
-        char *lineEnd = line;
-        while (*lineEnd && *lineEnd != '\n')
-          lineEnd++;
-
-        wchar_t wline[256];
-        int len = MultiByteToWideChar(CP_ACP, 0, line, (int)(lineEnd - line),
-                                      wline, 255);
-        wline[len] = 0;
-        TextOutW(hdc, 15, y, wline, len);
-        y += 16;
+    _snwprintf_s(buf, 128, _TRUNCATE, L"Arena heap fallbacks %u  Item DB %u",
+                 g_data->arenaHeapAllocations, g_data->itemDbItems);
+    TextOutW(hdc, 15, y, buf, (int)wcslen(buf));
+    y += 18;
 
-        if (*lineEnd == '\n')
-          lineEnd++;
-        line = lineEnd;
-        if (y > rc->bottom - 20)
-          break;
+    // Name cache hit rates over all lookups so far (- before the first)
+    wchar_t cacheText[NAME_CACHES][16];
+    for (int i = 0; i < NAME_CACHES; i++) {
+      int64_t lookups = g_data->nameCacheHits[i] + g_data->nameCacheMisses[i];
+      if (lookups > 0)
+        _snwprintf_s(cacheText[i], 16, _TRUNCATE, L"%.1f%%",
+                     100.0 * g_data->nameCacheHits[i] / lookups);
+      else
+        wcscpy_s(cacheText[i], L"-");
+    }
+    _snwprintf_s(buf, 128, _TRUNCATE, L"Name cache hits: NPC %s  Item %s",
+                 cacheText[NAME_CACHE_NPC], cacheText[NAME_CACHE_ITEM]);
+    TextOutW(hdc, 15, y, buf, (int)wcslen(buf));
+    y += 18;
+
+    // Events logged this session, and finished sessions written to disk
+    _snwprintf_s(buf, 128, _TRUNCATE, L"Session log %u events  %u archived",
+                 g_data->sessionLogEvents, g_data->sessionsArchived);
+    TextOutW(hdc, 15, y, buf, (int)wcslen(buf));
+    y += 20;
+
+    // Startup timeline, ms after injection (- pending, x skipped)
+    wchar_t stageText[INIT_STAGES][12];
+    for (int i = 0; i < INIT_STAGES; i++) {
+      if (g_data->initStageMs[i] >= 0)
+        _snwprintf_s(stageText[i], 12, _TRUNCATE, L"%d",
+                     g_data->initStageMs[i]);
+      else
+        wcscpy_s(stageText[i], g_data->initStageMs[i] == INIT_STAGE_SKIPPED
+                                   ? L"x"
+                                   : L"-");
+    }
+    SetTextColor(hdc, CLR_TEXT_DIM);
+    _snwprintf_s(buf, 128, _TRUNCATE,
+                 L"Init ms: shm %s  map %s  hooks %s  1st event %s",
+                 stageText[INIT_SHARED_MEMORY], stageText[INIT_MODULE_MAPPED],
+                 stageText[INIT_HOOKS], stageText[INIT_FIRST_EVENT]);
+    TextOutW(hdc, 15, y, buf, (int)wcslen(buf));
+    y += 18;
+    _snwprintf_s(buf, 128, _TRUNCATE,
+                 L"  signatures %s  singletons %s  overlay %s",
+                 stageText[INIT_SIGNATURES], stageText[INIT_SINGLETONS],
+                 stageText[INIT_OVERLAY]);
+    TextOutW(hdc, 15, y, buf, (int)wcslen(buf));
+    y += 18;
+
+    _snwprintf_s(buf, 128, _TRUNCATE,
+                 L"Hooks installed in %.1f ms (click to toggle)",
+                 g_data->hookInstallUs / 1000.0);
+    TextOutW(hdc, 15, y, buf, (int)wcslen(buf));
+    y += 20;
+
+    // Cost of each game hook in microseconds (our code only, the original
+    // call excluded)
+    const int colX[5] = {15, 90, 140, 190, 240};
+    const wchar_t *headers[5] = {L"Hook (\u00B5s)", L"p50", L"p99", L"max",
+                                 L"calls"};
+    SetTextColor(hdc, CLR_TEXT_DIM);
+    for (int c = 0; c < 5; c++)
+      TextOutW(hdc, colX[c], y, headers[c], (int)wcslen(headers[c]));
+    y += 18;
+
+    double perUs = g_data->tscTicksPerUs > 0.0 ? g_data->tscTicksPerUs : 1.0;
+    for (int i = 0; i < HOOK_COUNT && y < rc->bottom - 20; i++) {
+      const HookLatency &hook = g_data->hookLatency[i];
+      uint8_t state = g_data->hookState[i];
+      SetRect(&g_hookRowRects[i], colX[0], y, rc->right - 15, y + 16);
+      SetTextColor(hdc, state == HOOK_STATE_ON && hook.cycles.total > 0
+                            ? CLR_TEXT
+                            : CLR_TEXT_DIM);
+      MultiByteToWideChar(CP_ACP, 0, hook.name, -1, buf, 16);
+      TextOutW(hdc, colX[0], y, buf, (int)wcslen(buf));
+      if (state != HOOK_STATE_ON) {
+        const wchar_t *label = state == HOOK_STATE_OFF ? L"off" : L"n/a";
+        TextOutW(hdc, colX[1], y, label, (int)wcslen(label));
+        y += 16;
+        continue;
       }
-    } else {
-      TextOutW(hdc, 15, y, L"No debug output", 15);
+      double values[3] = {hook.cycles.percentile(0.50) / perUs,
+                          hook.cycles.percentile(0.99) / perUs,
+                          hook.cycles.max / perUs};
+      for (int c = 0; c < 3; c++) {
+        _snwprintf_s(buf, 128, _TRUNCATE, L"%.1f", values[c]);
+        TextOutW(hdc, colX[c + 1], y, buf, (int)wcslen(buf));
+      }
+      _snwprintf_s(buf, 128, _TRUNCATE, L"%I64u", hook.cycles.total);
+      TextOutW(hdc, colX[4], y, buf, (int)wcslen(buf));
+      y += 16;
     }
   } else {
     SetTextColor(hdc, CLR_TEXT_DIM);
@@ -497,12 +988,25 @@ void CreateFilterControls(HWND hwnd) {
       115, 115, 100, 20, hwnd, (HMENU)IDC_BLOCK_ITEMS_CHECK,
       GetModuleHandle(nullptr), nullptr);
 
+  // Create Rate Limit checkbox and msgs/min box - below the filter toggle
+  g_hRateLimitCheck = CreateWindowExA(
+      0, "BUTTON", "Rate limit senders", WS_CHILD | WS_VISIBLE | BS_AUTOCHECKBOX,
+      15, 232, 125, 20, hwnd, (HMENU)IDC_RATE_LIMIT_CHECK,
+      GetModuleHandle(nullptr), nullptr);
+
+  g_hRateLimitEdit = CreateWindowExA(
+      WS_EX_CLIENTEDGE, "EDIT", "20", WS_CHILD | WS_VISIBLE | ES_NUMBER, 145,
+      231, 40, 22, hwnd, (HMENU)IDC_RATE_LIMIT_EDIT, GetModuleHandle(nullptr),
+      nullptr);
+
   // Set font for controls
   HFONT hFont = (HFONT)GetStockObject(DEFAULT_GUI_FONT);
   SendMessage(g_hFilterEdit, WM_SETFONT, (WPARAM)hFont, TRUE);
   SendMessage(g_hApplyButton, WM_SETFONT, (WPARAM)hFont, TRUE);
   SendMessage(g_hUseRegexCheck, WM_SETFONT, (WPARAM)hFont, TRUE);
   SendMessage(g_hBlockItemsCheck, WM_SETFONT, (WPARAM)hFont, TRUE);
+  SendMessage(g_hRateLimitCheck, WM_SETFONT, (WPARAM)hFont, TRUE);
+  SendMessage(g_hRateLimitEdit, WM_SETFONT, (WPARAM)hFont, TRUE);
 
   // Set Use Regex checked by default
   SendMessage(g_hUseRegexCheck, BM_SETCHECK, BST_CHECKED, 0);
@@ -524,16 +1028,20 @@ void UpdateFilterControlsVisibility(int activeTab) {
   if (g_hUseRegexCheck) {
     ShowWindow(g_hUseRegexCheck, activeTab == TAB_FILTER ? SW_SHOW : SW_HIDE);
   }
+  if (g_hRateLimitCheck) {
+    ShowWindow(g_hRateLimitCheck, activeTab == TAB_FILTER ? SW_SHOW : SW_HIDE);
+  }
+  if (g_hRateLimitEdit) {
+    ShowWindow(g_hRateLimitEdit, activeTab == TAB_FILTER ? SW_SHOW : SW_HIDE);
+  }
 }
 
 // Draw Filter tab content
 void DrawFilterTab(HDC hdc, int startY, RECT *rc) {
   int y = startY;
 
-  // Create regular content font
-  HFONT contentFont =
-      CreateFontW(13, 0, 0, 0, FW_NORMAL, FALSE, FALSE, FALSE, DEFAULT_CHARSET,
-                  0, 0, CLEARTYPE_QUALITY, 0, L"Segoe UI");
+  // Regular content font
+  HFONT contentFont = g_gdi.contentFont;
   SelectObject(hdc, contentFont);
 
   SetTextColor(hdc, CLR_TEXT);
@@ -542,12 +1050,10 @@ void DrawFilterTab(HDC hdc, int startY, RECT *rc) {
 
   // Draw text input area background
   RECT editRect = {15, y, rc->right - 15, y + 50};
-  FillRoundRect(hdc, &editRect, RGB(30, 30, 50));
-  HPEN borderPen = CreatePen(PS_SOLID, 1, CLR_BORDER);
-  SelectObject(hdc, borderPen);
+  FillRoundRect(hdc, &editRect, g_gdi.tabNormalBrush);
+  SelectObject(hdc, g_gdi.borderPen);
   SelectObject(hdc, GetStockObject(NULL_BRUSH));
   Rectangle(hdc, editRect.left, editRect.top, editRect.right, editRect.bottom);
-  DeleteObject(borderPen);
 
   // Display current filter terms
   if (g_filterTerms[0]) {
@@ -568,19 +1074,16 @@ void DrawFilterTab(HDC hdc, int startY, RECT *rc) {
   y = startY + 90;
 
   // Draw ON/OFF toggle button
-  COLORREF toggleColor = g_filterEnabled ? RGB(50, 180, 50) : RGB(100, 50, 50);
   const wchar_t *toggleText =
       g_filterEnabled ? L"  FILTER ON" : L"  FILTER OFF";
   g_toggleButtonRect = {15, y, 120, y + 30};
-  FillRoundRect(hdc, &g_toggleButtonRect, toggleColor);
+  FillRoundRect(hdc, &g_toggleButtonRect,
+                g_filterEnabled ? g_gdi.toggleOnBrush : g_gdi.toggleOffBrush);
 
   // Button border
-  borderPen = CreatePen(PS_SOLID, 1,
-                        g_filterEnabled ? RGB(80, 220, 80) : RGB(150, 80, 80));
-  SelectObject(hdc, borderPen);
+  SelectObject(hdc, g_filterEnabled ? g_gdi.toggleOnPen : g_gdi.toggleOffPen);
   Rectangle(hdc, g_toggleButtonRect.left, g_toggleButtonRect.top,
             g_toggleButtonRect.right, g_toggleButtonRect.bottom);
-  DeleteObject(borderPen);
 
   // Button text
   SetTextColor(hdc, RGB(255, 255, 255));
@@ -595,14 +1098,203 @@ void DrawFilterTab(HDC hdc, int startY, RECT *rc) {
   } else {
     TextOutW(hdc, 15, y, L"Waiting for game...", 19);
   }
+  y += 30;
+
+  // Rate limit row (checkbox + edit are Win32 controls at y=232)
+  SetTextColor(hdc, CLR_TEXT_DIM);
+  TextOutW(hdc, 190, y + 3, L"msgs/min", 8);
+  y += 26;
+
+  // Throttle counters from the DLL
+  if (g_data && g_data->magic == 0xDEADBEEF) {
+    wchar_t buf[128];
+    SetTextColor(hdc, CLR_TEXT);
+    _snwprintf_s(buf, 128, _TRUNCATE, L"Throttled: %I64d",
+                 g_data->chatThrottledTotal);
+    TextOutW(hdc, 15, y, buf, (int)wcslen(buf));
+    y += 18;
+
+    SetTextColor(hdc, CLR_TEXT_DIM);
+    for (int i = 0; i < 8 && y < rc->bottom - 20; i++) {
+      const auto &sender = g_data->throttledSenders[i];
+      if (sender.name[0] == '\0')
+        break;
+      wchar_t wname[32];
+      MultiByteToWideChar(CP_ACP, 0, sender.name, -1, wname, 32);
+      _snwprintf_s(buf, 128, _TRUNCATE, L"  %s: %d", wname, sender.throttled);
+      TextOutW(hdc, 15, y, buf, (int)wcslen(buf));
+      y += 16;
+    }
+  }
+}
+
+// Queue a command for the DLL to apply on its next tick. Returns the
+// command's sequence number, or 0 if not connected or the queue is full.
+uint32_t SendTrackerCommand(uint32_t type, uint32_t flags = 0, int32_t arg0 = 0,
+                            int32_t arg1 = 0, const char *text = nullptr) {
+  if (!g_data || g_data->magic != 0xDEADBEEF)
+    return 0;
+  TrackerCommand cmd = {};
+  cmd.type = type;
+  cmd.flags = flags;
+  cmd.args[0] = arg0;
+  cmd.args[1] = arg1;
+  if (text)
+    strncpy_s(cmd.text, sizeof(cmd.text), text, _TRUNCATE);
+  uint32_t seq = g_data->commands.push(cmd);
+  if (seq)
+    g_lastCommandSeq = seq;
+  return seq;
+}
+
+// Send the whole filter state (toggle, checkboxes, terms) as one command
+void SendFilterSettings() {
+  uint32_t flags = 0;
+  if (g_filterEnabled)
+    flags |= CMD_FLAG_ENABLED;
+  if (g_hBlockItemsCheck &&
+      SendMessage(g_hBlockItemsCheck, BM_GETCHECK, 0, 0) == BST_CHECKED)
+    flags |= CMD_FLAG_BLOCK_ITEMS;
+  if (g_hUseRegexCheck &&
+      SendMessage(g_hUseRegexCheck, BM_GETCHECK, 0, 0) == BST_CHECKED)
+    flags |= CMD_FLAG_REGEX;
+  SendTrackerCommand(CMD_SET_FILTER, flags, 0, 0, g_filterTerms);
+}
+
+// Send the flood limiter toggle and msgs/min (burst is left unchanged)
+void SendRateLimitSettings() {
+  uint32_t flags = 0;
+  if (g_hRateLimitCheck &&
+      SendMessage(g_hRateLimitCheck, BM_GETCHECK, 0, 0) == BST_CHECKED)
+    flags |= CMD_FLAG_ENABLED;
+  int perMinute = 0;
+  if (g_hRateLimitEdit) {
+    char text[16];
+    GetWindowTextA(g_hRateLimitEdit, text, sizeof(text));
+    perMinute = atoi(text);
+  }
+  SendTrackerCommand(CMD_SET_RATE_LIMIT, flags, perMinute, 0);
+  g_rateLimitEditPending = false; // This command carries the edit's value
+}
+
+// Send an edit the debounce timer is still holding
+void FlushRateLimitEdit(HWND hwnd) {
+  KillTimer(hwnd, IDT_RATE_LIMIT_DEBOUNCE);
+  if (g_rateLimitEditPending)
+    SendRateLimitSettings();
+}
+
+// Pick up a publish from the DLL (or reconnect). Called when the update event
+// fires and on the fallback timeout.
+void SyncSharedMemory(HWND hwnd) {
+  if (!g_data || g_data->magic != 0xDEADBEEF) {
+    DisconnectSharedMemory();
+    ConnectSharedMemory();
+  }
+  // Sync local filter state from shared memory, unless the DLL hasn't
+  // applied our latest change yet (the controls already show it)
+  if (g_data && g_data->magic == 0xDEADBEEF &&
+      g_data->commands.isAcked(g_lastCommandSeq)) {
+    if (strcmp(g_filterTerms, g_data->chatFilterTerms) != 0) {
+      strcpy_s(g_filterTerms, sizeof(g_filterTerms), g_data->chatFilterTerms);
+      if (g_hFilterEdit) {
+        SetWindowTextA(g_hFilterEdit, g_filterTerms);
+      }
+    }
+    // Sync filter enabled state
+    g_filterEnabled = g_data->chatFilterEnabled;
+    // Sync block items checkbox
+    if (g_hBlockItemsCheck) {
+      SendMessage(g_hBlockItemsCheck, BM_SETCHECK,
+                  g_data->blockLinkedItems ? BST_CHECKED : BST_UNCHECKED, 0);
+    }
+    // Sync regex checkbox
+    if (g_hUseRegexCheck) {
+      SendMessage(g_hUseRegexCheck, BM_SETCHECK,
+                  g_data->useRegexFilter ? BST_CHECKED : BST_UNCHECKED, 0);
+    }
+    // Sync rate limit checkbox (edit box is only written by the user)
+    if (g_hRateLimitCheck) {
+      SendMessage(g_hRateLimitCheck, BM_SETCHECK,
+                  g_data->chatRateLimitEnabled ? BST_CHECKED : BST_UNCHECKED,
+                  0);
+    }
+  }
+
+  // Repaint only when the DLL published something or the connection
+  // state flipped
+  bool connected = g_data && g_data->magic == 0xDEADBEEF;
+  uint32_t version = connected ? g_data->version : 0;
+  if (connected != g_paintedConnected || version != g_paintedVersion) {
+    g_paintedConnected = connected;
+    g_paintedVersion = version;
+    RequestRepaint(hwnd);
+  }
+}
+
+// Draw the whole window into the back buffer
+void PaintBackBuffer(HDC hdc, RECT *rc) {
+  // Background
+  FillRect(hdc, rc, g_gdi.bgBrush);
+
+  // Header gradient-ish
+  RECT header = {0, 0, rc->right, 32};
+  FillRoundRect(hdc, &header, g_gdi.headerBrush);
+
+  // Border
+  SelectObject(hdc, g_gdi.borderPen);
+  SelectObject(hdc, GetStockObject(NULL_BRUSH));
+  Rectangle(hdc, 0, 0, rc->right, rc->bottom);
+
+  SetBkMode(hdc, TRANSPARENT);
+
+  // Title
+  SelectObject(hdc, g_gdi.titleFont);
+  SetTextColor(hdc, CLR_GOLD);
+  TextOutW(hdc, 12, 7, L"Dreadmyst Tracker", 17);
 
-  DeleteObject(contentFont);
+  // Tab buttons - use Segoe UI Symbol for icon support
+  SelectObject(hdc, g_gdi.tabFont);
+
+  int tabW = 54;
+  int tabH = 24;
+  int tabY = 38;
+  DrawTab(hdc, TAB_STATS, L"\x2694 Stats", 8, tabY, tabW,
+          tabH); // Crossed swords
+  DrawTab(hdc, TAB_COMBAT, L"\x2620 Dmg", 64, tabY, tabW, tabH); // Skull
+  DrawTab(hdc, TAB_LOOT, L"\x2666 Loot", 120, tabY, tabW, tabH); // Diamond
+  DrawTab(hdc, TAB_FILTER, L"\x2709 Chat", 176, tabY, tabW, tabH); // Envelope
+  DrawTab(hdc, TAB_DEBUG, L"\x2699 Debug", 232, tabY, tabW, tabH); // Gear
+
+  // Content area
+  SelectObject(hdc, g_gdi.contentFont);
+
+  int contentY = tabY + tabH + 10;
+
+  switch (g_activeTab) {
+  case TAB_STATS:
+    DrawStatsTab(hdc, contentY, rc);
+    break;
+  case TAB_COMBAT:
+    DrawCombatTab(hdc, contentY, rc);
+    break;
+  case TAB_LOOT:
+    DrawLootTab(hdc, contentY, rc);
+    break;
+  case TAB_DEBUG:
+    DrawDebugTab(hdc, contentY, rc);
+    break;
+  case TAB_FILTER:
+    DrawFilterTab(hdc, contentY, rc);
+    break;
+  }
 }
 
 // Window procedure
 LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
   switch (msg) {
   case WM_CREATE:
+    CreateGdiResources();
     CreateFilterControls(hwnd);
     UpdateFilterControlsVisibility(g_activeTab);
     return 0;
@@ -612,150 +1304,74 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
       // Get text from edit control
       if (g_hFilterEdit) {
         GetWindowTextA(g_hFilterEdit, g_filterTerms, sizeof(g_filterTerms));
-
-        // Update shared memory
-        if (g_data && g_data->magic == 0xDEADBEEF) {
-          strcpy_s(g_data->chatFilterTerms, g_filterTerms);
-        }
-
-        InvalidateRect(hwnd, nullptr, FALSE);
+        SendFilterSettings();
+        RequestRepaint(hwnd);
       }
       return 0;
     }
     if (LOWORD(wParam) == IDC_BLOCK_ITEMS_CHECK) {
       // Toggle block linked items
-      if (g_data && g_data->magic == 0xDEADBEEF) {
-        bool checked =
-            (SendMessage(g_hBlockItemsCheck, BM_GETCHECK, 0, 0) == BST_CHECKED);
-        g_data->blockLinkedItems = checked;
-      }
-      InvalidateRect(hwnd, nullptr, FALSE);
+      SendFilterSettings();
+      RequestRepaint(hwnd);
+      return 0;
+    }
+    if (LOWORD(wParam) == IDC_RATE_LIMIT_CHECK) {
+      // Toggle per-sender flood limiting
+      SendRateLimitSettings();
+      RequestRepaint(hwnd);
+      return 0;
+    }
+    if (LOWORD(wParam) == IDC_RATE_LIMIT_EDIT && HIWORD(wParam) == EN_CHANGE) {
+      // Messages per minute per sender: restart the debounce
+      g_rateLimitEditPending = true;
+      SetTimer(hwnd, IDT_RATE_LIMIT_DEBOUNCE, RATE_LIMIT_DEBOUNCE_MS, nullptr);
+      return 0;
+    }
+    if (LOWORD(wParam) == IDC_RATE_LIMIT_EDIT &&
+        HIWORD(wParam) == EN_KILLFOCUS) {
+      FlushRateLimitEdit(hwnd);
       return 0;
     }
     if (LOWORD(wParam) == IDC_USE_REGEX_CHECK) {
       // Toggle use regex filter
-      if (g_data && g_data->magic == 0xDEADBEEF) {
-        bool checked =
-            (SendMessage(g_hUseRegexCheck, BM_GETCHECK, 0, 0) == BST_CHECKED);
-        g_data->useRegexFilter = checked;
-      }
-      InvalidateRect(hwnd, nullptr, FALSE);
+      SendFilterSettings();
+      RequestRepaint(hwnd);
       return 0;
     }
     break;
 
   case WM_PAINT: {
     PAINTSTRUCT ps;
-    HDC hdc = BeginPaint(hwnd, &ps);
+    HDC windowDC = BeginPaint(hwnd, &ps);
     RECT rc;
     GetClientRect(hwnd, &rc);
 
-    // Background
-    HBRUSH bgBrush = CreateSolidBrush(CLR_BG);
-    FillRect(hdc, &rc, bgBrush);
-    DeleteObject(bgBrush);
-
-    // Header gradient-ish
-    RECT header = {0, 0, rc.right, 32};
-    FillRoundRect(hdc, &header, CLR_HEADER);
-
-    // Border
-    HPEN borderPen = CreatePen(PS_SOLID, 1, CLR_BORDER);
-    SelectObject(hdc, borderPen);
-    SelectObject(hdc, GetStockObject(NULL_BRUSH));
-    Rectangle(hdc, 0, 0, rc.right, rc.bottom);
-    DeleteObject(borderPen);
-
-    SetBkMode(hdc, TRANSPARENT);
-
-    // Title
-    HFONT titleFont =
-        CreateFontW(15, 0, 0, 0, FW_BOLD, FALSE, FALSE, FALSE, DEFAULT_CHARSET,
-                    0, 0, CLEARTYPE_QUALITY, 0, L"Segoe UI");
-    SelectObject(hdc, titleFont);
-    SetTextColor(hdc, CLR_GOLD);
-    TextOutW(hdc, 12, 7, L"Dreadmyst Tracker", 17);
-    DeleteObject(titleFont);
-
-    // Tab buttons - use Segoe UI Symbol for icon support
-    HFONT tabFont = CreateFontW(12, 0, 0, 0, FW_SEMIBOLD, FALSE, FALSE, FALSE,
-                                DEFAULT_CHARSET, 0, 0, CLEARTYPE_QUALITY, 0,
-                                L"Segoe UI Symbol");
-    SelectObject(hdc, tabFont);
-
-    int tabW = 65;
-    int tabH = 24;
-    int tabY = 38;
-    DrawTab(hdc, TAB_STATS, L"\x2694 Stats", 10, tabY, tabW,
-            tabH); // Crossed swords
-    DrawTab(hdc, TAB_LOOT, L"\x2666 Loot", 80, tabY, tabW, tabH);    // Diamond
-    DrawTab(hdc, TAB_FILTER, L"\x2709 Chat", 150, tabY, tabW, tabH); // Envelope
-    DrawTab(hdc, TAB_DEBUG, L"\x2699 Debug", 220, tabY, tabW, tabH); // Gear
-    DeleteObject(tabFont);
-
-    // Content area
-    HFONT contentFont =
-        CreateFontW(13, 0, 0, 0, FW_NORMAL, FALSE, FALSE, FALSE,
-                    DEFAULT_CHARSET, 0, 0, CLEARTYPE_QUALITY, 0, L"Segoe UI");
-    SelectObject(hdc, contentFont);
-
-    int contentY = tabY + tabH + 10;
-
-    switch (g_activeTab) {
-    case TAB_STATS:
-      DrawStatsTab(hdc, contentY, &rc);
-      break;
-    case TAB_LOOT:
-      DrawLootTab(hdc, contentY, &rc);
-      break;
-    case TAB_DEBUG:
-      DrawDebugTab(hdc, contentY, &rc);
-      break;
-    case TAB_FILTER:
-      DrawFilterTab(hdc, contentY, &rc);
-      break;
+    // Only redraw when something changed; otherwise (e.g. the window was
+    // uncovered) the last frame is blitted as-is
+    HDC backDC = GetBackBuffer(windowDC, rc.right, rc.bottom);
+    bool redrawn = g_backDirty;
+    if (g_backDirty) {
+      g_backDirty = false;
+      PaintBackBuffer(backDC, &rc);
     }
+    BitBlt(windowDC, 0, 0, rc.right, rc.bottom, backDC, 0, 0, SRCCOPY);
+    if (redrawn)
+      RecordDisplayLatency();
 
-    DeleteObject(contentFont);
     EndPaint(hwnd, &ps);
     return 0;
   }
 
-  case WM_TIMER:
-    if (!g_data || g_data->magic != 0xDEADBEEF) {
-      DisconnectSharedMemory();
-      ConnectSharedMemory();
-    }
-    // Sync local filter terms display with shared memory
-    if (g_data && g_data->magic == 0xDEADBEEF) {
-      if (strcmp(g_filterTerms, g_data->chatFilterTerms) != 0) {
-        strcpy_s(g_filterTerms, sizeof(g_filterTerms), g_data->chatFilterTerms);
-        if (g_hFilterEdit) {
-          SetWindowTextA(g_hFilterEdit, g_filterTerms);
-        }
-      }
-      // Sync filter enabled state
-      g_filterEnabled = g_data->chatFilterEnabled;
-      // Sync block items checkbox
-      if (g_hBlockItemsCheck) {
-        SendMessage(g_hBlockItemsCheck, BM_SETCHECK,
-                    g_data->blockLinkedItems ? BST_CHECKED : BST_UNCHECKED, 0);
-      }
-      // Sync regex checkbox
-      if (g_hUseRegexCheck) {
-        SendMessage(g_hUseRegexCheck, BM_SETCHECK,
-                    g_data->useRegexFilter ? BST_CHECKED : BST_UNCHECKED, 0);
-      }
-    }
-    InvalidateRect(hwnd, nullptr, FALSE);
-    return 0;
+  case WM_ERASEBKGND:
+    return 1; // Back buffer covers the whole client area
+
 
   case WM_MOUSEMOVE: {
     POINT pt = {LOWORD(lParam), HIWORD(lParam)};
 
     // Check tab hover
     int newHover = -1;
-    for (int i = 0; i < 4; i++) {
+    for (int i = 0; i < TAB_COUNT; i++) {
       if (PtInRect(&g_tabRects[i], pt)) {
         newHover = i;
         break;
@@ -763,7 +1379,7 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
     }
     if (newHover != g_hoverTab) {
       g_hoverTab = newHover;
-      InvalidateRect(hwnd, nullptr, FALSE);
+      RequestRepaint(hwnd);
     }
 
     // Dragging
@@ -781,11 +1397,11 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
     POINT pt = {LOWORD(lParam), HIWORD(lParam)};
 
     // Check tab click
-    for (int i = 0; i < 4; i++) {
+    for (int i = 0; i < TAB_COUNT; i++) {
       if (PtInRect(&g_tabRects[i], pt)) {
         g_activeTab = i;
         UpdateFilterControlsVisibility(g_activeTab);
-        InvalidateRect(hwnd, nullptr, FALSE);
+        RequestRepaint(hwnd);
         return 0;
       }
     }
@@ -795,11 +1411,8 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
       // Check toggle button click
       if (PtInRect(&g_toggleButtonRect, pt)) {
         g_filterEnabled = !g_filterEnabled;
-        // Update shared memory
-        if (g_data && g_data->magic == 0xDEADBEEF) {
-          g_data->chatFilterEnabled = g_filterEnabled;
-        }
-        InvalidateRect(hwnd, nullptr, FALSE);
+        SendFilterSettings();
+        RequestRepaint(hwnd);
         return 0;
       }
 
@@ -810,6 +1423,29 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
       }
     }
 
+    // Loot tab: click a heading to switch views
+    if (g_activeTab == TAB_LOOT) {
+      for (int v = 0; v < LOOT_VIEWS; v++) {
+        if (PtInRect(&g_lootViewRects[v], pt)) {
+          g_lootView = v;
+          RequestRepaint(hwnd);
+          return 0;
+        }
+      }
+    }
+
+    // Debug tab: click a hook row to switch it on or off
+    if (g_activeTab == TAB_DEBUG && g_data) {
+      for (int i = 0; i < HOOK_COUNT; i++) {
+        uint8_t state = g_data->hookState[i];
+        if (state != HOOK_STATE_MISSING && PtInRect(&g_hookRowRects[i], pt)) {
+          SendTrackerCommand(CMD_SET_HOOK_ENABLED,
+                             state == HOOK_STATE_ON ? 0 : CMD_FLAG_ENABLED, i);
+          return 0;
+        }
+      }
+    }
+
     // Start drag
     g_dragging = true;
     SetCapture(hwnd);
@@ -828,12 +1464,39 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
 
   case WM_MOUSELEAVE:
     g_hoverTab = -1;
-    InvalidateRect(hwnd, nullptr, FALSE);
+    RequestRepaint(hwnd);
     return 0;
 
   case WM_RBUTTONUP: {
     HMENU menu = CreatePopupMenu();
     AppendMenuW(menu, MF_STRING, 1, L"Reset Stats");
+    AppendMenuW(menu, MF_STRING, 4, L"Toggle Overlay");
+
+    // DLL publish rate; ids are MENU_REFRESH_BASE + index
+    HMENU refreshMenu = CreatePopupMenu();
+    int currentRate = g_data ? g_data->publishIntervalMs : 0;
+    for (int i = 0; i < REFRESH_RATE_COUNT; i++) {
+      wchar_t label[32];
+      _snwprintf_s(label, 32, _TRUNCATE, L"%d ms", REFRESH_RATES_MS[i]);
+      UINT flags = MF_STRING;
+      if (REFRESH_RATES_MS[i] == currentRate)
+        flags |= MF_CHECKED;
+      AppendMenuW(refreshMenu, flags, MENU_REFRESH_BASE + i, label);
+    }
+    AppendMenuW(menu, MF_POPUP, (UINT_PTR)refreshMenu, L"Refresh Rate");
+
+    // Kill-to-loot join window; ids are MENU_DROP_WINDOW_BASE + index
+    HMENU dropMenu = CreatePopupMenu();
+    int currentWindow = g_data ? g_data->dropWindowMs : 0;
+    for (int i = 0; i < DROP_WINDOW_COUNT; i++) {
+      wchar_t label[32];
+      _snwprintf_s(label, 32, _TRUNCATE, L"%d s", DROP_WINDOWS_MS[i] / 1000);
+      UINT flags = MF_STRING;
+      if (DROP_WINDOWS_MS[i] == currentWindow)
+        flags |= MF_CHECKED;
+      AppendMenuW(dropMenu, flags, MENU_DROP_WINDOW_BASE + i, label);
+    }
+    AppendMenuW(menu, MF_POPUP, (UINT_PTR)dropMenu, L"Drop Window");
     AppendMenuW(menu, MF_SEPARATOR, 0, nullptr);
     AppendMenuW(menu, MF_STRING, 3, L"Unload DLL");
     AppendMenuW(menu, MF_SEPARATOR, 0, nullptr);
@@ -846,24 +1509,18 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
     DestroyMenu(menu);
 
     if (cmd == 1) {
-      // Reset Stats - reset session time and all counters
-      g_guiStartTime = GetTickCount64(); // Reset GUI timer
-      if (g_data && g_data->magic == 0xDEADBEEF) {
-        g_data->totalKills = 0;
-        g_data->totalLootItems = 0;
-        g_data->totalGold = 0;
-        g_data->totalExp = 0;
-        g_data->goldSpent = 0;
-        g_data->totalDamage = 0;
-        g_data->partyKills = 0;
-        g_data->partyLootItems = 0;
-        g_data->partyGold = 0;
-        g_data->partyExp = 0;
-        for (int i = 0; i < 6; i++)
-          g_data->lootByQuality[i] = 0;
-        g_data->sessionStartTime = GetTickCount64();
-      }
-      InvalidateRect(hwnd, nullptr, FALSE);
+      // Reset Stats - the DLL resets its own totals and republishes
+      SendTrackerCommand(CMD_RESET_STATS);
+    } else if (cmd == 4) {
+      SendTrackerCommand(CMD_TOGGLE_OVERLAY);
+    } else if (cmd >= MENU_REFRESH_BASE &&
+               cmd < MENU_REFRESH_BASE + REFRESH_RATE_COUNT) {
+      SendTrackerCommand(CMD_SET_REFRESH_RATE, 0,
+                         REFRESH_RATES_MS[cmd - MENU_REFRESH_BASE]);
+    } else if (cmd >= MENU_DROP_WINDOW_BASE &&
+               cmd < MENU_DROP_WINDOW_BASE + DROP_WINDOW_COUNT) {
+      SendTrackerCommand(CMD_SET_DROP_WINDOW, 0,
+                         DROP_WINDOWS_MS[cmd - MENU_DROP_WINDOW_BASE]);
     } else if (cmd == 2 || cmd == 3) {
       // Run extracted Unloader.exe
       STARTUPINFOW si = {sizeof(si)};
@@ -880,8 +1537,17 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
     return 0;
   }
 
+  case WM_TIMER:
+    if (wParam == IDT_RATE_LIMIT_DEBOUNCE) {
+      FlushRateLimitEdit(hwnd);
+      return 0;
+    }
+    break;
+
   case WM_DESTROY:
+    FlushRateLimitEdit(hwnd);
     DisconnectSharedMemory();
+    DestroyGdiResources();
     PostQuitMessage(0);
     return 0;
 
@@ -934,7 +1600,7 @@ int WINAPI wWinMain(HINSTANCE hInstance, HINSTANCE, LPWSTR, int) {
   g_hwnd =
       CreateWindowExW(WS_EX_TOPMOST | WS_EX_TOOLWINDOW | WS_EX_LAYERED,
                       L"DreadmystTrackerGUI", L"Dreadmyst Tracker", WS_POPUP,
-                      100, 100, 300, 380, nullptr, nullptr, hInstance, nullptr);
+                      100, 100, 300, 410, nullptr, nullptr, hInstance, nullptr);
 
   if (!g_hwnd)
     return 1;
@@ -944,13 +1610,44 @@ int WINAPI wWinMain(HINSTANCE hInstance, HINSTANCE, LPWSTR, int) {
   UpdateWindow(g_hwnd);
 
   ConnectSharedMemory();
-  SetTimer(g_hwnd, 1, 100, nullptr);
 
-  MSG msg;
-  while (GetMessageW(&msg, nullptr, 0, 0)) {
-    TranslateMessage(&msg);
-    DispatchMessageW(&msg);
-  }
+  // Sleep until the DLL signals a publish, a window message arrives, or the
+  // fallback timeout passes
+  MSG msg = {};
+  bool eventReopened = false; // The event handle was reopened after a failure
+  for (;;) {
+    HANDLE event = g_updateNotifier.handle();
+    DWORD handleCount = event ? 1 : 0;
+    DWORD wait = MsgWaitForMultipleObjects(handleCount, &event, FALSE,
+                                           UPDATE_FALLBACK_MS, QS_ALLINPUT);
+    if (wait == WAIT_FAILED) {
+      // A bad event handle fails every wait at once, which would spin this
+      // loop. Reopen the event once; if that fails too, drop it and poll on
+      // the fallback timeout until the next reconnect opens a fresh one.
+      if (event && !eventReopened) {
+        g_updateNotifier.open(TRACKER_UPDATE_EVENT_NAME);
+        eventReopened = true;
+      } else if (event) {
+        g_updateNotifier.close();
+      } else {
+        Sleep(UPDATE_FALLBACK_MS); // Waiting on messages alone failed
+      }
+      SyncSharedMemory(g_hwnd);
+    } else if (wait != WAIT_OBJECT_0 + handleCount) {
+      if (wait == WAIT_OBJECT_0)
+        eventReopened = false; // The handle works
+      SyncSharedMemory(g_hwnd);
+    }
 
-  return (int)msg.wParam;
+    // Pump on every wakeup, not only when input woke us: the event sits at
+    // index 0 and is reported first, so publishes arriving faster than the
+    // loop (a hit per publish in combat) would otherwise starve input and
+    // the WM_PAINT SyncSharedMemory asked for
+    while (PeekMessageW(&msg, nullptr, 0, 0, PM_REMOVE)) {
+      if (msg.message == WM_QUIT)
+        return (int)msg.wParam;
+      TranslateMessage(&msg);
+      DispatchMessageW(&msg);
+    }
+  }
 }
@@ -5,6 +5,8 @@
 #include <string>
 #include <vector>
 
+#include "SharedTrackerData.h"
+
 DWORD FindProcess(const wchar_t *name) {
   HANDLE snap = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
   if (snap == INVALID_HANDLE_VALUE)
@@ -48,6 +50,33 @@ HMODULE FindModule(DWORD pid, const wchar_t *moduleName) {
   return result;
 }
 
+// Ask the tracker to write its session archive from its own tick thread and
+// stop any startup work, then wait for the acknowledgement. DllMain can't
+// do this safely during unload.
+bool PrepareUnload() {
+  HANDLE mapping =
+      OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, TRACKER_SHARED_MEMORY_NAME);
+  if (!mapping)
+    return false;
+  auto *data = (SharedTrackerData *)MapViewOfFile(
+      mapping, FILE_MAP_ALL_ACCESS, 0, 0, sizeof(SharedTrackerData));
+  bool saved = false;
+  if (data && data->magic == 0xDEADBEEF) {
+    TrackerCommand cmd = {};
+    cmd.type = CMD_PREPARE_UNLOAD;
+    uint32_t seq = data->commands.push(cmd);
+    for (int waited = 0; seq && waited < 5000 && !saved; waited += 20) {
+      saved = data->commands.isAcked(seq);
+      if (!saved)
+        Sleep(20);
+    }
+  }
+  if (data)
+    UnmapViewOfFile(data);
+  CloseHandle(mapping);
+  return saved;
+}
+
 bool Unload(DWORD pid, HMODULE hModule) {
   HANDLE proc = OpenProcess(PROCESS_ALL_ACCESS, FALSE, pid);
   if (!proc) {
@@ -96,7 +125,10 @@ int wmain(int argc, wchar_t *argv[]) {
   HMODULE hModule = FindModule(pid, dllName);
 
   if (hModule) {
-    std::wcout << L"Found " << dllName << L". Unloading...\n";
+    std::wcout << L"Found " << dllName << L". Saving session...\n";
+    if (!PrepareUnload())
+      std::wcout << L"Session not saved (tracker not running?)\n";
+    std::wcout << L"Unloading...\n";
     if (Unload(pid, hModule)) {
       std::wcout << L"SUCCESS! " << dllName << L" unloaded!\n";
     } else {
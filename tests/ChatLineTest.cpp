@@ -0,0 +1,389 @@
+// ParseChatEvents and ParseAddLine on the chat lines the tracker reads,
+// checked against the std::regex and strstr parses they replaced, and the
+// heap allocations per line on both hook paths: counted with a global
+// operator new.
+//
+//   g++ -std=c++17 -O2 -Iinclude tests/ChatLineTest.cpp
+
+#include "ChatLine.h"
+#include "HookArena.h"
+#include "TestCheck.h"
+
+#include <chrono>
+#include <new>
+#include <random>
+#include <regex>
+#include <string>
+
+// Counts every heap allocation in the process. The replacements pair
+// malloc with free, which GCC can't see through once they're inlined.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+static long g_heapAllocations = 0;
+
+void *operator new(size_t size) {
+  g_heapAllocations++;
+  if (void *p = malloc(size ? size : 1))
+    return p;
+  throw std::bad_alloc();
+}
+void *operator new(size_t size, std::align_val_t align) {
+  g_heapAllocations++;
+  if (void *p = aligned_alloc((size_t)align, (size + (size_t)align - 1) /
+                                                 (size_t)align * (size_t)align))
+    return p;
+  throw std::bad_alloc();
+}
+void operator delete(void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+void operator delete(void *p, std::align_val_t) noexcept { free(p); }
+void operator delete(void *p, size_t, std::align_val_t) noexcept { free(p); }
+
+namespace {
+
+ChatLineEvents Parse(const char *line) { return ParseChatEvents(line); }
+
+void TestLoot() {
+  ChatLineEvents e =
+      Parse("You receive: [Ancient Sword of the Moonlit Night] x3");
+  CHECK(e.loot && !e.exp && !e.kill && !e.gold);
+  CHECK(e.lootName == "Ancient Sword of the Moonlit Night");
+  CHECK_EQ(e.lootAmount, 3);
+
+  e = Parse("you receive:[Pelt]");
+  CHECK(e.loot && e.lootName == "Pelt");
+  CHECK_EQ(e.lootAmount, 1);
+
+  e = Parse("You receive: [Gold] x25");
+  CHECK(e.loot && e.lootName == "Gold" && !e.gold);
+  CHECK_EQ(e.lootAmount, 25);
+
+  // An absurd stack clamps instead of overflowing inside the hook
+  e = Parse("You receive: [Pelt] x99999999999999999999");
+  CHECK(e.loot && e.lootAmount > 0);
+}
+
+void TestExpKillGold() {
+  ChatLineEvents e = Parse("You gained 340 experience");
+  CHECK(e.exp && !e.loot && !e.kill);
+  CHECK_EQ(e.expAmount, 340);
+  CHECK_EQ(Parse("+75 XP").expAmount, 75);
+
+  e = Parse("You killed [Forest Wolf Alpha]");
+  CHECK(e.kill && e.killName == "Forest Wolf Alpha");
+  e = Parse("Skeleton has been defeated Skeleton");
+  CHECK(e.kill && e.killName == "Skeleton");
+  e = Parse("You have slain nothing");
+  CHECK(!e.kill);
+
+  e = Parse("You looted 12 gold");
+  CHECK(e.gold && !e.loot);
+  CHECK_EQ(e.goldAmount, 12);
+
+  e = Parse("Welcome to Dreadmyst");
+  CHECK(!e.loot && !e.exp && !e.kill && !e.gold);
+}
+
+// One line can report several events; names point into the line
+void TestViewsIntoLine() {
+  const char *line = "You killed [Bandit Lord] You gained 90 experience";
+  ChatLineEvents e = Parse(line);
+  CHECK(e.kill && e.exp);
+  CHECK(e.killName.data() == line + 12);
+  CHECK_EQ(e.expAmount, 90);
+}
+
+// The parse as it was: a std::cmatch per pattern, names as views
+ChatLineEvents ParseWithRegex(const char *line) {
+  static const std::regex lootRegex(
+      R"(You receive:\s*\[([^\]]+)\](?:\s*x(\d+))?)", std::regex::icase);
+  static const std::regex expRegex(
+      R"((?:You (?:gained?|received?)|got|\+)\s*(\d+)\s*(?:experience|exp|xp))",
+      std::regex::icase);
+  static const std::regex killRegex(
+      R"((?:You (?:killed?|slain|defeated)|has been defeated)\s*(?:\[([^\]]+)\]|(\w+)))",
+      std::regex::icase);
+  static const std::regex goldRegex(
+      R"((?:You (?:received?|got|looted))\s*(\d+)\s*(?:Gold|gold|coins?))",
+      std::regex::icase);
+  auto number = [](const std::csub_match &digits) {
+    long long value = strtoll(digits.first, nullptr, 10);
+    return value > INT_MAX ? INT_MAX : (int)value;
+  };
+  auto view = [](const std::csub_match &text) {
+    return std::string_view(text.first, (size_t)text.length());
+  };
+
+  ChatLineEvents events;
+  std::cmatch match;
+  if (std::regex_search(line, match, lootRegex)) {
+    events.loot = true;
+    events.lootName = view(match[1]);
+    if (match[2].matched)
+      events.lootAmount = number(match[2]);
+  }
+  if (std::regex_search(line, match, expRegex)) {
+    events.exp = true;
+    events.expAmount = number(match[1]);
+  }
+  if (std::regex_search(line, match, killRegex)) {
+    events.kill = true;
+    events.killName = view(match[1].matched ? match[1] : match[2]);
+  }
+  if (std::regex_search(line, match, goldRegex)) {
+    events.gold = true;
+    events.goldAmount = number(match[1]);
+  }
+  return events;
+}
+
+bool SameEvents(const ChatLineEvents &a, const ChatLineEvents &b) {
+  return a.loot == b.loot && a.lootName == b.lootName &&
+         a.lootAmount == b.lootAmount && a.exp == b.exp &&
+         a.expAmount == b.expAmount && a.kill == b.kill &&
+         a.killName == b.killName && a.gold == b.gold &&
+         a.goldAmount == b.goldAmount;
+}
+
+// Lines near the patterns' edges, then random lines built from their
+// pieces: the matcher finds what the regexes found, at the same place
+void TestMatchesRegex() {
+  const char *edges[] = {
+      "YOU RECEIVE:[Pelt]X7",
+      "You receive: [] You receive: [Fang] x",
+      "You receive: nothing, then You receive:\t[Fang]x 4",
+      "You receive: [Unclosed",
+      "You gaine 4 exp",
+      "you received 12 xp and you received 30 gold",
+      "got 5 experience",
+      "+ 3 xp",
+      "++7xp",
+      "You gained experience",
+      "You killed []",
+      "You kille d",
+      "You killed",
+      "You killed  [Orc] [Troll]",
+      "Troll has been defeated\t[Troll King]",
+      "You defeated Orc_2!",
+      "You slain [",
+      "You got 9 coins",
+      "You looted 3 Coin",
+      "You received 10 silver",
+      "You receive 10 gold",
+      "",
+  };
+  for (const char *line : edges)
+    CHECK(SameEvents(Parse(line), ParseWithRegex(line)));
+
+  const char *pieces[] = {
+      "You ",   "you ",     "receive", "received", ":",        " ",
+      "\t",     "[",        "]",       "Pelt",     "x",        "X",
+      "12",     "0",        "gained",  "gaine",    "got",      "+",
+      "xp",     "XP",       "exp",     "killed",   "kille",    "slain",
+      "has been defeated",  "defeated", "Gold",    "coins",    "looted",
+      "d",      "_",        "Orc",     "-",        "experience"};
+  constexpr int PIECES = sizeof(pieces) / sizeof(pieces[0]);
+  std::mt19937 rng(11);
+  int mismatches = 0, matched = 0;
+  for (int i = 0; i < 20000; i++) {
+    std::string line;
+    int count = 1 + (int)(rng() % 10);
+    for (int p = 0; p < count; p++)
+      line += pieces[rng() % PIECES];
+    ChatLineEvents e = Parse(line.c_str());
+    if (!SameEvents(e, ParseWithRegex(line.c_str())))
+      mismatches++;
+    matched += e.loot || e.exp || e.kill || e.gold;
+  }
+  CHECK_EQ(mismatches, 0);
+  CHECK(matched > 2000); // The pieces do form events
+}
+
+// ParseChatLine as it was, with strstr and a fixed name buffer
+struct OldAddLine {
+  int expAmount = 0;
+  bool loot = false;
+  std::string lootName;
+  int lootAmount = 1;
+  bool lootIsGold = false;
+  int goldSpent = 0;
+};
+
+OldAddLine ParseAddLineWithStrstr(const char *strPtr) {
+  OldAddLine old;
+  if (strstr(strPtr, "You gained") && strstr(strPtr, "experience")) {
+    int expAmount = 0;
+    const char *numStart = strPtr + 11;
+    while (*numStart && (*numStart < '0' || *numStart > '9'))
+      numStart++;
+    while (*numStart >= '0' && *numStart <= '9') {
+      expAmount = expAmount * 10 + (*numStart - '0');
+      numStart++;
+    }
+    old.expAmount = expAmount;
+  }
+  const char *receivePos = strstr(strPtr, "receive: [");
+  if (receivePos) {
+    const char *nameStart = strstr(receivePos, "["); // Never null here
+    const char *nameEnd = strstr(nameStart + 1, "]");
+    if (nameEnd) {
+      nameStart++;
+      char itemName[64] = {0};
+      int len = (int)(nameEnd - nameStart);
+      if (len > 63)
+        len = 63;
+      strncpy(itemName, nameStart, len);
+      int amount = 1;
+      const char *amtPos = strstr(nameEnd, " x");
+      if (amtPos) {
+        amount = atoi(amtPos + 2);
+        if (amount < 1)
+          amount = 1;
+      }
+      old.loot = true;
+      old.lootName = itemName;
+      old.lootAmount = amount;
+      old.lootIsGold = strstr(itemName, "Gold") || strstr(itemName, "gold");
+    }
+  }
+  const char *spentPos = strstr(strPtr, "You spent ");
+  if (spentPos && strstr(spentPos, " Gold")) {
+    int goldSpent = atoi(spentPos + 10);
+    old.goldSpent = goldSpent > 0 ? goldSpent : 0;
+  }
+  return old;
+}
+
+// The installed addLine hook's parse gives what the strstr version did
+void TestAddLine() {
+  const char *lines[] = {
+      "You gained 340 experience",
+      "You gained experience: 12",
+      "You receive: [Tattered Pelt] x3",
+      "You receive: [Gold] x25",
+      "You receive: [Gold Ring]",
+      "You receive: [Pelt] x0",
+      "You receive: [Pelt] x -2",
+      "You receive: [] x2",
+      "You receive: [Unclosed x2",
+      "You receive: [A] then x 7",
+      "You receive: [Sword of the Moonlit Night of the Deep Woods and the "
+      "Ancient Forgotten Kings] x2",
+      "You spent 120 Gold",
+      "You spent -5 Gold",
+      "You spent 40 silver",
+      "You gained 90 experience. You receive: [Fang] x2. You spent 3 Gold",
+      "Grimlock says: anyone selling pelts?",
+  };
+  for (const char *line : lines) {
+    AddLineEvents e = ParseAddLine(line);
+    OldAddLine old = ParseAddLineWithStrstr(line);
+    CHECK(e.expAmount == old.expAmount && e.loot == old.loot &&
+          e.lootName == old.lootName && e.lootAmount == old.lootAmount &&
+          e.lootIsGold == old.lootIsGold && e.goldSpent == old.goldSpent);
+  }
+
+  AddLineEvents e = ParseAddLine("You receive: [Tattered Pelt] x3");
+  CHECK(e.loot && e.lootName == "Tattered Pelt" && !e.lootIsGold);
+  CHECK_EQ(e.lootAmount, 3);
+  CHECK_EQ(ParseAddLine("You receive: [Pelt] x99999999999").lootAmount,
+           INT_MAX);
+}
+
+const char *LINES[] = {
+    "You receive: [Ancient Sword of the Moonlit Night] x3",
+    "You killed [Forest Wolf Alpha of the Deep Woods]",
+    "You gained 340 experience",
+    "You receive: [Tattered Pelt]",
+    "Grimlock says: anyone selling pelts?",
+    "You looted 12 gold",
+    "You spent 120 Gold",
+};
+constexpr int LINE_COUNT = sizeof(LINES) / sizeof(LINES[0]);
+
+// The chat parse as it was: a std::string per capture, numbers through
+// std::stoi
+int ParseWithStrings(const char *line) {
+  ChatLineEvents e = ParseWithRegex(line);
+  int total = e.lootAmount + e.expAmount + e.goldAmount;
+  if (e.loot)
+    total += (int)std::string(e.lootName).size();
+  if (e.kill)
+    total += (int)std::string(e.killName).size();
+  return total;
+}
+
+// ChatParser now: the entry's copy of the name in the arena, views in
+// between
+int ParseWithArena(const char *line) {
+  HookArenaScope scope;
+  ChatLineEvents e = ParseChatEvents(line);
+  std::pmr::string entryName(HookArena::resource());
+  if (e.loot)
+    entryName.assign(e.lootName.data(), e.lootName.size());
+  if (e.kill)
+    entryName.assign(e.killName.data(), e.killName.size());
+  return (int)entryName.size() + e.lootAmount + e.expAmount + e.goldAmount;
+}
+
+// The installed addLine hook: HookedAddLine's arena scope, ParseChatLine's
+// parse and the LootEntry name it hands notifyLootReceived. The tracker's
+// side of the notify (counters, history slots, archive log, drop table)
+// writes fixed or reserved storage and isn't portable, so it isn't here.
+int AddLineHook(const char *line) {
+  HookArenaScope scope;
+  AddLineEvents e = ParseAddLine(line);
+  std::pmr::string itemName(HookArena::resource());
+  if (e.loot && !e.lootIsGold)
+    itemName.assign(e.lootName.data(), e.lootName.size());
+  return (int)itemName.size() + e.lootAmount + e.expAmount + e.goldSpent;
+}
+
+template <typename Parse>
+double AllocationsPerLine(Parse parse, double &nsPerLine) {
+  constexpr int ROUNDS = 20000;
+  int sink = 0;
+  for (const char *line : LINES) // Warm up the regex statics
+    sink += parse(line);
+  long before = g_heapAllocations;
+  auto start = std::chrono::steady_clock::now();
+  for (int r = 0; r < ROUNDS; r++)
+    sink += parse(LINES[r % LINE_COUNT]);
+  auto end = std::chrono::steady_clock::now();
+  nsPerLine =
+      std::chrono::duration<double, std::nano>(end - start).count() / ROUNDS;
+  CHECK(sink != 0);
+  return (double)(g_heapAllocations - before) / ROUNDS;
+}
+
+void BenchmarkAllocations() {
+  double stringsNs = 0, arenaNs = 0, addLineNs = 0;
+  double strings = AllocationsPerLine(ParseWithStrings, stringsNs);
+  uint32_t spillsBefore = HookArena::heapAllocations();
+  double arena = AllocationsPerLine(ParseWithArena, arenaNs);
+  double addLine = AllocationsPerLine(AddLineHook, addLineNs);
+  printf("ChatLine: regex+strings %.2f allocations/line (%.0f ns), "
+         "matcher+arena %.2f (%.0f ns), addLine hook %.2f (%.0f ns)\n",
+         strings, stringsNs, arena, arenaNs, addLine, addLineNs);
+
+  // Steady state on both hook paths: nothing reaches the heap, and the
+  // arena never spills
+  CHECK(strings > 0);
+  CHECK_EQ(arena, 0.0);
+  CHECK_EQ(addLine, 0.0);
+  CHECK_EQ(HookArena::heapAllocations(), spillsBefore);
+}
+
+} // namespace
+
+int main() {
+  TestLoot();
+  TestExpKillGold();
+  TestViewsIntoLine();
+  TestMatchesRegex();
+  TestAddLine();
+  BenchmarkAllocations();
+  return TestResult("ChatLineTest");
+}
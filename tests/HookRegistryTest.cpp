@@ -0,0 +1,259 @@
+// HookRegistry over a fake backend and a fake game image.
+//
+//   g++ -std=c++17 -O2 -Iinclude tests/HookRegistryTest.cpp
+
+#include "HookRegistry.h"
+#include "TestCheck.h"
+
+#include <cstring>
+#include <set>
+#include <vector>
+
+namespace {
+
+constexpr uint32_t PREFERRED_BASE = 0x00400000;
+
+// Records what the registry asks for; each call can be made to fail
+class FakeBackend : public HookBackend {
+public:
+  bool failInitialize = false;
+  bool failApply = false;
+  std::set<void *> refuseCreate;
+
+  std::set<void *> created;
+  std::set<void *> enabled;
+  std::vector<std::pair<void *, bool>> queued;
+  int applies = 0;
+  int removes = 0;
+
+  bool initialize() override { return !failInitialize; }
+
+  bool create(void *target, void *detour, void **original) override {
+    if (refuseCreate.count(target) || created.count(target))
+      return false;
+    created.insert(target);
+    *original = target; // Stands in for the trampoline
+    (void)detour;
+    return true;
+  }
+
+  bool queue(void *target, bool enable) override {
+    if (!created.count(target))
+      return false;
+    queued.push_back({target, enable});
+    return true;
+  }
+
+  bool applyQueued() override {
+    applies++;
+    if (failApply) {
+      queued.clear();
+      return false;
+    }
+    for (auto &q : queued) {
+      if (q.second)
+        enabled.insert(q.first);
+      else
+        enabled.erase(q.first);
+    }
+    queued.clear();
+    return true;
+  }
+
+  void removeAll() override {
+    removes++;
+    created.clear();
+    enabled.clear();
+  }
+};
+
+// 64 KB of int3 padding with "functions" written at chosen offsets
+struct FakeImage {
+  std::vector<uint8_t> bytes = std::vector<uint8_t>(0x10000, 0xCC);
+
+  void write(uint32_t va, const std::vector<uint8_t> &code) {
+    memcpy(&bytes[va - PREFERRED_BASE], code.data(), code.size());
+  }
+  HookImage image() const {
+    return {bytes.data(), bytes.size(), PREFERRED_BASE};
+  }
+  const uint8_t *at(uint32_t va) const {
+    return bytes.data() + (va - PREFERRED_BASE);
+  }
+};
+
+const std::vector<uint8_t> PROLOGUE_A = {0x55, 0x8B, 0xEC, 0x83, 0xEC, 0x10,
+                                         0x56, 0x8B, 0xF1};
+const char *SIGNATURE_A = "55 8B EC 83 EC ?? 56 8B F1";
+const std::vector<uint8_t> PROLOGUE_B = {0x55, 0x8B, 0xEC, 0x81, 0xEC, 0x00,
+                                         0x01, 0x00, 0x00, 0x53, 0x56};
+const char *SIGNATURE_B = "55 8B EC 81 EC ?? ?? ?? ?? 53 56";
+
+void *g_trampolines[4];
+int g_detours[4];
+
+enum { HOOK_VA_ONLY, HOOK_CHECKED, HOOK_MOVED, HOOK_DISABLED, HOOKS };
+
+// Three hooks by VA (one checked against its signature, one whose function
+// has moved), plus one installed disabled
+const HookSpec SPECS[HOOKS] = {
+    {"vaOnly", 0x00401000, nullptr, &g_detours[0], &g_trampolines[0], true},
+    {"checked", 0x00402000, SIGNATURE_A, &g_detours[1], &g_trampolines[1],
+     true},
+    {"moved", 0x00403000, SIGNATURE_B, &g_detours[2], &g_trampolines[2],
+     true},
+    {"disabled", 0x00404000, nullptr, &g_detours[3], &g_trampolines[3],
+     false},
+};
+
+FakeImage MakeImage() {
+  FakeImage image;
+  image.write(0x00402000, PROLOGUE_A);
+  image.write(0x00405800, PROLOGUE_B); // Patch moved it from 0x00403000
+  return image;
+}
+
+void TestPatterns() {
+  FakeImage image = MakeImage();
+  CHECK(MatchPattern(image.at(0x00402000), 16, SIGNATURE_A));
+  CHECK(!MatchPattern(image.at(0x00402000), 4, SIGNATURE_A)); // Too short
+  CHECK(!MatchPattern(image.at(0x00403000), 16, SIGNATURE_B));
+  CHECK(FindPattern(image.bytes.data(), image.bytes.size(), SIGNATURE_B) ==
+        image.at(0x00405800));
+  CHECK(FindPattern(image.bytes.data(), image.bytes.size(), "DE AD BE EF") ==
+        nullptr);
+
+  uint8_t bytes[MAX_PATTERN_BYTES];
+  bool wild[MAX_PATTERN_BYTES];
+  CHECK_EQ(ParsePattern("8b ? EC", bytes, wild), 3);
+  CHECK(wild[1] && !wild[0] && bytes[0] == 0x8B);
+  CHECK_EQ(ParsePattern("8G", bytes, wild), 0); // Malformed
+  CHECK_EQ(ParsePattern("8", bytes, wild), 0);
+}
+
+void TestInstall() {
+  FakeImage image = MakeImage();
+  FakeBackend backend;
+  HookRegistry<HOOKS> registry(backend);
+  CHECK(registry.install(SPECS, image.image()));
+
+  CHECK_EQ(registry.source(HOOK_VA_ONLY), HOOK_SOURCE_VA);
+  CHECK_EQ(registry.source(HOOK_CHECKED), HOOK_SOURCE_VA);
+  CHECK_EQ(registry.source(HOOK_MOVED), HOOK_SOURCE_SIGNATURE);
+  CHECK(g_trampolines[HOOK_MOVED] == image.at(0x00405800));
+  CHECK(g_trampolines[HOOK_CHECKED] == image.at(0x00402000));
+
+  // One batch for everything enabled at install
+  CHECK_EQ(backend.applies, 1);
+  CHECK_EQ((int)backend.created.size(), 4);
+  CHECK_EQ((int)backend.enabled.size(), 3);
+  CHECK(registry.installed(HOOK_DISABLED) && !registry.enabled(HOOK_DISABLED));
+  CHECK(registry.enabled(HOOK_VA_ONLY) && registry.enabled(HOOK_MOVED));
+
+  // Installing again is a no-op
+  CHECK(registry.install(SPECS, image.image()));
+  CHECK_EQ(backend.applies, 1);
+}
+
+// A signature that matches neither at the VA nor anywhere: not hooked. A VA
+// outside the image with no signature: not hooked either.
+void TestUnresolved() {
+  FakeImage image; // Nothing written
+  HookSpec specs[2] = {
+      {"gone", 0x00402000, SIGNATURE_A, &g_detours[0], &g_trampolines[0],
+       true},
+      {"outside", 0x00800000, nullptr, &g_detours[1], &g_trampolines[1],
+       true},
+  };
+  FakeBackend backend;
+  HookRegistry<2> registry(backend);
+  CHECK(registry.install(specs, image.image()));
+  CHECK(!registry.installed(0) && !registry.installed(1));
+  CHECK_EQ(registry.source(0), HOOK_SOURCE_NONE);
+  CHECK(backend.created.empty());
+  CHECK(!registry.setEnabled(0, true));
+}
+
+void TestBackendFailures() {
+  FakeImage image = MakeImage();
+  {
+    FakeBackend backend;
+    backend.failInitialize = true;
+    HookRegistry<HOOKS> registry(backend);
+    CHECK(!registry.install(SPECS, image.image()));
+    CHECK(!registry.installed(HOOK_VA_ONLY));
+  }
+  {
+    FakeBackend backend;
+    backend.refuseCreate.insert((void *)image.at(0x00402000));
+    HookRegistry<HOOKS> registry(backend);
+    CHECK(registry.install(SPECS, image.image()));
+    CHECK(!registry.installed(HOOK_CHECKED));
+    CHECK_EQ(registry.source(HOOK_CHECKED), HOOK_SOURCE_NONE);
+    CHECK(registry.enabled(HOOK_VA_ONLY));
+  }
+  {
+    // A failed batch leaves every hook created but disabled
+    FakeBackend backend;
+    backend.failApply = true;
+    HookRegistry<HOOKS> registry(backend);
+    CHECK(registry.install(SPECS, image.image()));
+    for (int i = 0; i < HOOKS; i++) {
+      CHECK(registry.installed(i));
+      CHECK(!registry.enabled(i));
+    }
+  }
+}
+
+void TestToggle() {
+  FakeImage image = MakeImage();
+  FakeBackend backend;
+  HookRegistry<HOOKS> registry(backend);
+  registry.install(SPECS, image.image());
+
+  CHECK(registry.setEnabled(HOOK_DISABLED, true));
+  CHECK(backend.enabled.count((void *)image.at(0x00404000)));
+  CHECK_EQ(backend.applies, 2);
+  CHECK(registry.setEnabled(HOOK_DISABLED, true)); // Already on: no batch
+  CHECK_EQ(backend.applies, 2);
+
+  CHECK(registry.setEnabled(HOOK_VA_ONLY, false));
+  CHECK(!registry.enabled(HOOK_VA_ONLY));
+  CHECK(!backend.enabled.count((void *)image.at(0x00401000)));
+
+  backend.failApply = true;
+  CHECK(!registry.setEnabled(HOOK_VA_ONLY, true));
+  CHECK(!registry.enabled(HOOK_VA_ONLY)); // State follows the backend
+
+  CHECK(!registry.setEnabled(-1, true));
+  CHECK(!registry.setEnabled(HOOKS, true));
+}
+
+void TestUninstall() {
+  FakeImage image = MakeImage();
+  FakeBackend backend;
+  HookRegistry<HOOKS> registry(backend);
+  registry.install(SPECS, image.image());
+  registry.uninstall();
+  CHECK_EQ(backend.removes, 1);
+  for (int i = 0; i < HOOKS; i++)
+    CHECK(!registry.installed(i) && !registry.enabled(i));
+  registry.uninstall(); // Twice is harmless
+  CHECK_EQ(backend.removes, 1);
+
+  // And it can be installed again
+  CHECK(registry.install(SPECS, image.image()));
+  CHECK(registry.enabled(HOOK_MOVED));
+}
+
+} // namespace
+
+int main() {
+  TestPatterns();
+  TestInstall();
+  TestUnresolved();
+  TestBackendFailures();
+  TestToggle();
+  TestUninstall();
+  return TestResult("HookRegistryTest");
+}
@@ -0,0 +1,121 @@
+// ItemDatabase lookups over a small table built in memory, and records whose
+// names point outside the string table. Run it under ASan: the buffer is
+// sized exactly, so any read past it shows up.
+//
+//   g++ -std=c++17 -O2 -Iinclude tests/ItemDatabaseTest.cpp
+
+#include "ItemDatabase.h"
+#include "TestCheck.h"
+
+#include <string>
+#include <vector>
+
+namespace {
+
+// A one-item table laid out as ItemDbBuilder writes it. With one item every
+// id hashes to bucket 0, whose displacement names slot 0 directly.
+struct OneItemFile {
+  std::vector<uint8_t> bytes;
+
+  ItemDbHeader &header() { return *(ItemDbHeader *)bytes.data(); }
+  ItemDbRecord &record() {
+    return *(ItemDbRecord *)(bytes.data() + header().recordsOffset);
+  }
+
+  OneItemFile(uint16_t id, const std::string &name) {
+    uint32_t stringsSize = (uint32_t)name.size() + 1;
+    ItemDbHeader h = {};
+    h.magic = ITEM_DB_MAGIC;
+    h.version = ITEM_DB_VERSION;
+    h.count = 1;
+    h.hashSeed = 7;
+    h.displacementOffset = sizeof(ItemDbHeader);
+    h.recordsOffset = h.displacementOffset + sizeof(int32_t);
+    h.namesOffset = h.recordsOffset + sizeof(ItemDbRecord);
+    h.stringsOffset = h.namesOffset + sizeof(ItemDbName);
+    h.stringsSize = stringsSize;
+    bytes.resize(h.stringsOffset + stringsSize);
+    memcpy(bytes.data(), &h, sizeof(h));
+
+    int32_t displacement = -1; // Slot 0
+    memcpy(bytes.data() + h.displacementOffset, &displacement,
+           sizeof(displacement));
+    ItemDbRecord r = {};
+    r.id = id;
+    r.quality = 3;
+    r.nameOffset = 0;
+    r.nameLength = (uint16_t)name.size();
+    r.vendorValue = 120;
+    memcpy(bytes.data() + h.recordsOffset, &r, sizeof(r));
+    ItemDbName n = {ItemDbNameHash(name.data(), name.size()), 0};
+    memcpy(bytes.data() + h.namesOffset, &n, sizeof(n));
+    memcpy(bytes.data() + h.stringsOffset, name.c_str(), stringsSize);
+  }
+};
+
+void TestLookups() {
+  OneItemFile file(417, "Tattered Pelt");
+  ItemDatabase db;
+  CHECK(db.attach(file.bytes.data(), file.bytes.size()));
+  CHECK_EQ(db.count(), 1u);
+
+  const ItemDbRecord *byId = db.findById(417);
+  CHECK(byId && byId->vendorValue == 120);
+  CHECK(db.findById(418) == nullptr);
+
+  const ItemDbRecord *byName = db.findByName("Tattered Pelt", 13);
+  CHECK(byName == byId);
+  CHECK(db.findByName("Tattered Pel", 12) == nullptr);
+  CHECK(db.findByName(nullptr, 0) == nullptr);
+  CHECK(strcmp(db.nameOf(*byId), "Tattered Pelt") == 0);
+}
+
+// A record whose offset plus length runs past the string table: the name
+// hash still matches, but the compare must not read past the file
+void TestNameOutsideStrings() {
+  const std::string name = "Tattered Pelt";
+  for (uint32_t offset : {1u, 13u, 14u, 0xFFFFFFF0u}) {
+    OneItemFile file(417, name);
+    file.record().nameOffset = offset;
+    ItemDatabase db;
+    CHECK(db.attach(file.bytes.data(), file.bytes.size()));
+    CHECK(db.findByName(name.data(), name.size()) == nullptr);
+    CHECK(db.findById(417) != nullptr); // The id lookup doesn't read names
+  }
+
+  // A length past the end, with a name hash made to match it
+  OneItemFile file(417, name);
+  std::string longer = name + std::string(40, 'x');
+  file.record().nameLength = (uint16_t)longer.size();
+  ItemDbName &index =
+      *(ItemDbName *)(file.bytes.data() + file.header().namesOffset);
+  index.hash = ItemDbNameHash(longer.data(), longer.size());
+  ItemDatabase db;
+  CHECK(db.attach(file.bytes.data(), file.bytes.size()));
+  CHECK(db.findByName(longer.data(), longer.size()) == nullptr);
+}
+
+void TestRejectedFiles() {
+  OneItemFile good(1, "Gold");
+  ItemDatabase db;
+  CHECK(!db.attach(good.bytes.data(), sizeof(ItemDbHeader) - 1));
+  CHECK(!db.attach(good.bytes.data(), good.bytes.size() - 1));
+
+  OneItemFile badMagic(1, "Gold");
+  badMagic.header().magic = 0;
+  CHECK(!db.attach(badMagic.bytes.data(), badMagic.bytes.size()));
+  CHECK(!db.loaded());
+
+  OneItemFile unterminated(1, "Gold");
+  unterminated.bytes.back() = 'x';
+  CHECK(!db.attach(unterminated.bytes.data(), unterminated.bytes.size()));
+}
+
+} // namespace
+
+int main() {
+  TestLookups();
+  TestNameOutsideStrings();
+  TestRejectedFiles();
+  return TestResult("ItemDatabaseTest");
+}
@@ -0,0 +1,90 @@
+// ProjectLevel: unknown until the game reads and the exp table give it
+// something to work from, then exp left over the recent XP pace.
+//
+//   g++ -std=c++17 -O2 -Iinclude tests/LevelProjectionTest.cpp
+
+#include "LevelProjection.h"
+#include "TestCheck.h"
+
+namespace {
+
+// Total exp to reach each level: 1000 for level 2, rising 10% a level
+void FillTable(LevelExpTable &table) {
+  double exp = 1000.0;
+  for (int level = 2; level < LEVEL_TABLE_SIZE; level++) {
+    table.set(level, (uint32_t)exp);
+    exp = exp * 1.1 < 4e9 ? exp * 1.1 : 4e9;
+  }
+}
+
+// What the DLL publishes today: the player getters and exp_table are stubs
+void TestUnknownFromStubs() {
+  LevelExpTable empty;
+  LevelProjection p = ProjectLevel(0, 0, empty, 5000.0);
+  CHECK_EQ(p.level, 0);
+  CHECK_EQ(p.expToLevel, 0);
+  CHECK_EQ(p.secondsToLevel, -1);
+
+  LevelExpTable table;
+  FillTable(table);
+  CHECK_EQ(ProjectLevel(0, 0, table, 5000.0).secondsToLevel, -1);
+  CHECK_EQ(ProjectLevel(0, 600, table, 5000.0).secondsToLevel, -1);
+  CHECK_EQ(ProjectLevel(1, 0, table, 5000.0).secondsToLevel, -1);
+
+  // Level and exp known, table not loaded
+  p = ProjectLevel(1, 600, empty, 5000.0);
+  CHECK_EQ(p.level, 1);
+  CHECK_EQ(p.expToLevel, 0);
+  CHECK_EQ(p.secondsToLevel, -1);
+}
+
+void TestProjection() {
+  LevelExpTable table;
+  FillTable(table);
+
+  // 400 exp left at 1200 exp/hour: 20 minutes
+  LevelProjection p = ProjectLevel(1, 600, table, 1200.0);
+  CHECK_EQ(p.level, 1);
+  CHECK_EQ(p.expToLevel, 400);
+  CHECK_EQ(p.secondsToLevel, 1200);
+
+  // No pace yet: exp left is known, the time isn't
+  p = ProjectLevel(1, 600, table, 0.0);
+  CHECK_EQ(p.expToLevel, 400);
+  CHECK_EQ(p.secondsToLevel, -1);
+
+  // Exp at or past the table's next level (a stale table) is unknown
+  // rather than a zero or negative ETA
+  CHECK_EQ(ProjectLevel(1, 1000, table, 1200.0).secondsToLevel, -1);
+  CHECK_EQ(ProjectLevel(1, 5000, table, 1200.0).secondsToLevel, -1);
+
+  // The top level has no next level
+  CHECK_EQ(ProjectLevel(LEVEL_TABLE_SIZE - 1, 1, table, 1200.0).secondsToLevel,
+           -1);
+  CHECK_EQ(ProjectLevel(LEVEL_TABLE_SIZE + 5, 1, table, 1200.0).secondsToLevel,
+           -1);
+}
+
+// A reload clears the table; out-of-range levels are ignored
+void TestTable() {
+  LevelExpTable table;
+  FillTable(table);
+  CHECK_EQ(table.expForLevel(2), 1000u);
+  CHECK_EQ(table.expForLevel(0), 0u);
+  CHECK_EQ(table.expForLevel(-3), 0u);
+  table.set(LEVEL_TABLE_SIZE, 7);
+  table.set(-1, 7);
+  CHECK_EQ(table.expForLevel(LEVEL_TABLE_SIZE), 0u);
+  table.clear();
+  CHECK_EQ(table.expForLevel(2), 0u);
+  CHECK_EQ(ProjectLevel(1, 600, table, 1200.0).secondsToLevel, -1);
+}
+
+} // namespace
+
+int main() {
+  TestUnknownFromStubs();
+  TestProjection();
+  TestTable();
+  return TestResult("LevelProjectionTest");
+}
@@ -0,0 +1,187 @@
+// LogHistogram bucket mapping, percentile accuracy against exact sorted
+// samples, merging, and the cost of record().
+//
+//   g++ -std=c++17 -O2 -Iinclude tests/LogHistogramTest.cpp
+
+#include "SharedTrackerData.h"
+#include "TestCheck.h"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+namespace {
+
+// Every value lands in a bucket that contains it, buckets never go
+// backwards, and the whole uint32 range fits
+void TestBucketMapping() {
+  int lastBucket = 0;
+  bool contained = true;
+  bool ordered = true;
+  for (uint64_t v = 0; v <= 0xFFFFFFFFull;
+       v = v < 100000 ? v + 1 : v + v / 1000 + 1) {
+    int bucket = LogHistogram::bucketOf((uint32_t)v);
+    uint64_t low = LogHistogram::bucketLow(bucket);
+    uint64_t width = LogHistogram::bucketWidth(bucket);
+    if (v < low || v >= low + width)
+      contained = false;
+    if (bucket < lastBucket)
+      ordered = false;
+    lastBucket = bucket;
+  }
+  CHECK(contained);
+  CHECK(ordered);
+  CHECK(LogHistogram::bucketOf(0xFFFFFFFFu) < LogHistogram::BUCKETS);
+  CHECK_EQ(LogHistogram::bucketOf(0xFFFFFFFFu), LogHistogram::BUCKETS - 1);
+
+  // Relative bucket width is at most 1/8 above the exact range
+  for (int b = LogHistogram::SUB_BUCKETS; b < LogHistogram::BUCKETS; b++)
+    CHECK(LogHistogram::bucketWidth(b) * 8 <= LogHistogram::bucketLow(b));
+}
+
+void TestSmallValuesExact() {
+  static LogHistogram h;
+  h.clear();
+  for (uint32_t v = 0; v < 8; v++)
+    for (int i = 0; i < 10; i++)
+      h.record(v);
+  CHECK_EQ(h.percentile(0.05), 0u);
+  CHECK_EQ(h.percentile(0.5), 3u);
+  CHECK_EQ(h.percentile(0.8), 6u);
+  CHECK_EQ(h.percentile(1.0), 7u);
+  CHECK_EQ(h.total, 80u);
+  CHECK_EQ(h.sum, 280u);
+}
+
+void TestEmptyAndSingle() {
+  static LogHistogram h;
+  h.clear();
+  CHECK_EQ(h.percentile(0.5), 0u);
+  h.record(123456);
+  CHECK_EQ(h.percentile(0.0), 123456u);
+  CHECK_EQ(h.percentile(0.5), 123456u); // Clamped to the exact max
+  CHECK_EQ(h.percentile(1.0), 123456u);
+  h.record(0xFFFFFFFFu);
+  CHECK_EQ(h.max, 0xFFFFFFFFu);
+  CHECK_EQ(h.percentile(1.0), 0xFFFFFFFFu);
+}
+
+// Percentiles are within half a bucket (1/16) of the exact sample at the
+// same rank, never above the max, for several hit-size shapes
+void CheckAccuracy(const char *name, std::vector<uint32_t> values) {
+  static LogHistogram h;
+  h.clear();
+  for (uint32_t v : values)
+    h.record(v);
+  std::sort(values.begin(), values.end());
+
+  double worst = 0.0;
+  for (double q : {0.01, 0.1, 0.25, 0.5, 0.75, 0.9, 0.99, 0.999}) {
+    uint64_t rank = (uint64_t)(q * values.size() + 0.5);
+    if (rank < 1)
+      rank = 1;
+    uint32_t exact = values[rank - 1];
+    uint32_t estimate = h.percentile(q);
+    double error = exact ? (double)estimate / exact - 1.0 : estimate;
+    if (error < 0)
+      error = -error;
+    worst = error > worst ? error : worst;
+    CHECK(estimate <= h.max);
+  }
+  CHECK_EQ(h.percentile(1.0), values.back());
+  CHECK_EQ(h.max, values.back());
+  CHECK(worst <= 1.0 / 16 + 1e-9);
+  printf("LogHistogram %-10s worst percentile error %.2f%%\n", name,
+         worst * 100.0);
+}
+
+void TestAccuracy() {
+  std::mt19937 rng(7);
+  constexpr int N = 500000;
+  std::vector<uint32_t> values(N);
+
+  std::lognormal_distribution<double> lognormal(7.0, 1.0); // Typical hits
+  for (auto &v : values)
+    v = (uint32_t)lognormal(rng);
+  CheckAccuracy("lognormal", values);
+
+  std::uniform_int_distribution<uint32_t> uniform(1, 5000);
+  for (auto &v : values)
+    v = uniform(rng);
+  CheckAccuracy("uniform", values);
+
+  // Mostly normal hits with rare big crits
+  std::uniform_real_distribution<double> chance(0.0, 1.0);
+  for (auto &v : values)
+    v = chance(rng) < 0.02 ? uniform(rng) * 40 : uniform(rng) / 10 + 50;
+  CheckAccuracy("crits", values);
+}
+
+// Merging two halves gives the same histogram as recording everything
+void TestMerge() {
+  static LogHistogram all, a, b;
+  all.clear();
+  a.clear();
+  b.clear();
+  std::mt19937 rng(3);
+  for (int i = 0; i < 100000; i++) {
+    uint32_t v = rng() >> (rng() % 32);
+    all.record(v);
+    (i % 3 ? a : b).record(v);
+  }
+  a.merge(b);
+  CHECK(memcmp(&a, &all, sizeof(all)) == 0);
+}
+
+// A weighted sample is the same as recording it that many times, so sampled
+// hits keep their counts and percentiles
+void TestWeighted() {
+  static LogHistogram weighted, repeated;
+  weighted.clear();
+  repeated.clear();
+  std::mt19937 rng(5);
+  for (int i = 0; i < 10000; i++) {
+    uint32_t v = rng() >> (rng() % 32);
+    uint32_t weight = i % 2 ? 4 : 16;
+    weighted.record(v, weight);
+    for (uint32_t w = 0; w < weight; w++)
+      repeated.record(v);
+  }
+  CHECK(memcmp(&weighted, &repeated, sizeof(repeated)) == 0);
+  CHECK_EQ(weighted.total, 100000u);
+}
+
+void BenchmarkRecord() {
+  static LogHistogram h;
+  h.clear();
+  std::mt19937 rng(1);
+  std::lognormal_distribution<double> lognormal(7.0, 1.0);
+  std::vector<uint32_t> values(1 << 20);
+  for (auto &v : values)
+    v = (uint32_t)lognormal(rng);
+
+  constexpr int ROUNDS = 8;
+  auto start = std::chrono::steady_clock::now();
+  for (int r = 0; r < ROUNDS; r++)
+    for (uint32_t v : values)
+      h.record(v);
+  auto end = std::chrono::steady_clock::now();
+  double ns = std::chrono::duration<double, std::nano>(end - start).count() /
+              ((double)ROUNDS * values.size());
+  printf("LogHistogram: %.2f ns/record, %zu bytes\n", ns, sizeof(LogHistogram));
+  CHECK_EQ(h.total, (uint64_t)ROUNDS * values.size());
+}
+
+} // namespace
+
+int main() {
+  TestBucketMapping();
+  TestSmallValuesExact();
+  TestEmptyAndSingle();
+  TestAccuracy();
+  TestMerge();
+  TestWeighted();
+  BenchmarkRecord();
+  return TestResult("LogHistogramTest");
+}
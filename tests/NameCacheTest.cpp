@@ -0,0 +1,191 @@
+// NameCache against a fake ContentMgr, plus a lookup benchmark.
+//
+//   g++ -std=c++17 -O2 -pthread -Iinclude tests/NameCacheTest.cpp
+
+#include "NameCache.h"
+#include "TestCheck.h"
+
+#include <chrono>
+#include <map>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Stands in for the game's sContentMgr->db(table).data(key, "name"): a
+// string-keyed table lookup, then the row, then the column, returning a
+// fresh std::string each time
+class FakeContentMgr {
+public:
+  void addRow(const std::string &table, int key, const std::string &name) {
+    m_tables[table][key]["name"] = name;
+  }
+
+  std::string query(const char *table, int key) {
+    m_queries++;
+    auto t = m_tables.find(table);
+    if (t == m_tables.end())
+      return std::string();
+    auto row = t->second.find(key);
+    if (row == t->second.end())
+      return std::string();
+    auto name = row->second.find("name");
+    return name == row->second.end() ? std::string() : name->second;
+  }
+
+  int64_t queries() const { return m_queries; }
+
+private:
+  using Row = std::map<std::string, std::string>;
+  std::map<std::string, std::map<int, Row>> m_tables;
+  std::atomic<int64_t> m_queries{0};
+};
+
+std::string NpcName(int key) { return "Npc " + std::to_string(key); }
+
+FakeContentMgr &Content() {
+  static FakeContentMgr content;
+  static bool filled = [] {
+    for (int i = 1; i <= 4000; i++)
+      content.addRow("npc_template", i, NpcName(i));
+    return true;
+  }();
+  (void)filled;
+  return content;
+}
+
+auto LoadNpc = [](uint32_t key) {
+  return Content().query("npc_template", (int)key);
+};
+
+void TestHitsAndMisses() {
+  NameCache<10> cache;
+  int64_t before = Content().queries();
+  const char *first = cache.get(7, LoadNpc);
+  const char *second = cache.get(7, LoadNpc);
+  CHECK(first && std::string(first) == NpcName(7));
+  CHECK(first == second);
+  CHECK_EQ(Content().queries() - before, 1);
+  CHECK_EQ(cache.misses(), 1);
+  CHECK_EQ(cache.hits(), 1);
+}
+
+// Missing rows return nullptr and are asked again next time
+void TestEmptyNotCached() {
+  NameCache<10> cache;
+  int64_t before = Content().queries();
+  CHECK(cache.get(99999, LoadNpc) == nullptr);
+  CHECK(cache.get(99999, LoadNpc) == nullptr);
+  CHECK_EQ(Content().queries() - before, 2);
+}
+
+// Invalidate reloads every key, but interned pointers stay the same
+void TestInvalidate() {
+  NameCache<10> cache;
+  const char *before = cache.get(5, LoadNpc);
+  cache.invalidate();
+  const char *after = cache.get(5, LoadNpc);
+  CHECK(before == after);
+  CHECK_EQ(cache.misses(), 2);
+}
+
+// Keys that share a slot evict each other and still return the right name
+void TestCollisions() {
+  NameCache<4> cache;
+  for (int round = 0; round < 3; round++)
+    for (int key = 1; key <= 200; key++) {
+      const char *name = cache.get(key, LoadNpc);
+      CHECK(name && std::string(name) == NpcName(key));
+    }
+}
+
+// Past the intern table's capacity names are still returned, uncached
+void TestInternTableFull() {
+  NameCache<10, 8> cache;
+  for (int key = 1; key <= 8; key++)
+    cache.get(key, LoadNpc);
+  CHECK_EQ(cache.uncached(), 0);
+
+  const char *name = cache.get(9, LoadNpc);
+  CHECK(name && std::string(name) == NpcName(9));
+  CHECK_EQ(cache.uncached(), 1);
+  name = cache.get(9, LoadNpc); // Still not cached: loads again
+  CHECK(name && std::string(name) == NpcName(9));
+  CHECK_EQ(cache.uncached(), 2);
+
+  // Interned names keep hitting
+  const char *cached = cache.get(3, LoadNpc);
+  CHECK(cached && std::string(cached) == NpcName(3));
+}
+
+// Readers on several threads while another keeps invalidating
+void TestConcurrentReaders() {
+  NameCache<10> cache;
+  std::atomic<bool> done{false};
+  std::atomic<int> bad{0};
+  std::thread invalidator([&] {
+    while (!done.load()) {
+      cache.invalidate();
+      std::this_thread::yield();
+    }
+  });
+  std::vector<std::thread> readers;
+  for (int t = 0; t < 4; t++)
+    readers.emplace_back([&, t] {
+      for (int i = 0; i < 200000; i++) {
+        int key = (i * 7 + t) % 4000 + 1;
+        const char *name = cache.get(key, LoadNpc);
+        if (!name || NpcName(key) != name)
+          bad++;
+      }
+    });
+  for (auto &reader : readers)
+    reader.join();
+  done = true;
+  invalidator.join();
+  CHECK_EQ(bad.load(), 0);
+}
+
+// The kill and loot hooks look up a few hundred distinct ids over and over
+void Benchmark() {
+  constexpr int LOOKUPS = 5000000;
+  std::mt19937 rng(1);
+  std::vector<uint32_t> keys(4096);
+  for (auto &key : keys)
+    key = rng() % 300 + 1;
+
+  NameCache<10> cache;
+  volatile size_t sink = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < LOOKUPS; i++)
+    sink += (size_t)cache.get(keys[i & 4095], LoadNpc);
+  auto cached = std::chrono::steady_clock::now();
+  for (int i = 0; i < LOOKUPS / 20; i++)
+    sink += Content().query("npc_template", keys[i & 4095]).size();
+  auto direct = std::chrono::steady_clock::now();
+
+  double cachedNs =
+      std::chrono::duration<double, std::nano>(cached - start).count() /
+      LOOKUPS;
+  double directNs =
+      std::chrono::duration<double, std::nano>(direct - cached).count() /
+      (LOOKUPS / 20);
+  printf("NameCache: %.1f ns/lookup cached, %.1f ns direct, %.1f%% hits\n",
+         cachedNs, directNs,
+         100.0 * cache.hits() / (cache.hits() + cache.misses()));
+  CHECK(cachedNs < directNs);
+}
+
+} // namespace
+
+int main() {
+  TestHitsAndMisses();
+  TestEmptyNotCached();
+  TestInvalidate();
+  TestCollisions();
+  TestInternTableFull();
+  TestConcurrentReaders();
+  Benchmark();
+  return TestResult("NameCacheTest");
+}
@@ -0,0 +1,186 @@
+// OverheadGovernor under bursty hook load, driven by a simulated clock.
+//
+//   g++ -std=c++17 -O2 -pthread -Iinclude tests/OverheadGovernorTest.cpp
+
+#include "OverheadGovernor.h"
+#include "TestCheck.h"
+
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr double TSC_PER_US = 3000.0; // 3 GHz
+constexpr int BUDGET_US = OverheadGovernor::DEFAULT_BUDGET_US;
+constexpr uint64_t TICK_MS = 250;
+
+// Drives one governor tick by tick, feeding it hook time per frame
+struct Sim {
+  OverheadGovernor governor;
+  uint64_t nowMs = 1000;
+
+  Sim() { governor.update(nowMs, TSC_PER_US, BUDGET_US); } // Opens a window
+
+  void tick(double usPerFrame, uint64_t elapsedMs = TICK_MS) {
+    double frames = elapsedMs / OverheadGovernor::FRAME_MS;
+    governor.addCycles((uint64_t)(usPerFrame * TSC_PER_US * frames));
+    nowMs += elapsedMs;
+    governor.update(nowMs, TSC_PER_US, BUDGET_US);
+  }
+
+  void run(double usPerFrame, uint64_t durationMs) {
+    for (uint64_t t = 0; t < durationMs; t += TICK_MS)
+      tick(usPerFrame);
+  }
+};
+
+void TestMeasuresHookTime() {
+  Sim sim;
+  sim.tick(100.0);
+  double usPerFrame = sim.governor.usPerFrame();
+  CHECK(usPerFrame > 99.0 && usPerFrame < 101.0);
+  CHECK_EQ(sim.governor.mode(), OVERHEAD_FULL);
+}
+
+// Each over-budget tick steps one mode cheaper, never past minimal
+void TestStepsDownImmediately() {
+  Sim sim;
+  sim.tick(BUDGET_US * 2.0);
+  CHECK_EQ(sim.governor.mode(), OVERHEAD_REDUCED);
+  sim.tick(BUDGET_US * 2.0);
+  CHECK_EQ(sim.governor.mode(), OVERHEAD_MINIMAL);
+  sim.run(BUDGET_US * 10.0, 5000);
+  CHECK_EQ(sim.governor.mode(), OVERHEAD_MINIMAL);
+  CHECK_EQ(sim.governor.switches(), 2);
+}
+
+// Stepping back up needs RELAX_AFTER_MS under half the budget, per mode
+void TestRelaxesOnlyAfterCalm() {
+  Sim sim;
+  sim.run(BUDGET_US * 2.0, 2 * TICK_MS);
+  CHECK_EQ(sim.governor.mode(), OVERHEAD_MINIMAL);
+
+  sim.run(BUDGET_US * 0.1, OverheadGovernor::RELAX_AFTER_MS);
+  CHECK_EQ(sim.governor.mode(), OVERHEAD_MINIMAL);
+  sim.tick(BUDGET_US * 0.1);
+  CHECK_EQ(sim.governor.mode(), OVERHEAD_REDUCED);
+
+  sim.run(BUDGET_US * 0.1, OverheadGovernor::RELAX_AFTER_MS + TICK_MS * 2);
+  CHECK_EQ(sim.governor.mode(), OVERHEAD_FULL);
+  CHECK_EQ(sim.governor.switches(), 4);
+}
+
+// Load between half the budget and the budget holds the current mode
+void TestHoldsInHysteresisBand() {
+  Sim sim;
+  sim.tick(BUDGET_US * 2.0);
+  CHECK_EQ(sim.governor.mode(), OVERHEAD_REDUCED);
+  sim.run(BUDGET_US * 0.75, 60000);
+  CHECK_EQ(sim.governor.mode(), OVERHEAD_REDUCED);
+  CHECK_EQ(sim.governor.switches(), 1);
+}
+
+// Short bursts (a pull every few seconds) go to minimal and stay there:
+// the calm between bursts is shorter than RELAX_AFTER_MS, so the mode
+// doesn't flap with every pull
+void TestBurstsDoNotFlap() {
+  Sim sim;
+  for (int pull = 0; pull < 40; pull++) {
+    sim.run(BUDGET_US * 4.0, 2 * TICK_MS);
+    sim.run(BUDGET_US * 0.1, 1500);
+  }
+  CHECK_EQ(sim.governor.mode(), OVERHEAD_MINIMAL);
+  CHECK_EQ(sim.governor.switches(), 2);
+}
+
+// A burst inside the calm period restarts it
+void TestBurstResetsCalm() {
+  Sim sim;
+  sim.run(BUDGET_US * 2.0, TICK_MS);
+  CHECK_EQ(sim.governor.mode(), OVERHEAD_REDUCED);
+  sim.run(BUDGET_US * 0.1, 1500);
+  sim.tick(BUDGET_US * 0.8); // In the band: neither calm nor over
+  sim.run(BUDGET_US * 0.1, 1500);
+  CHECK_EQ(sim.governor.mode(), OVERHEAD_REDUCED);
+  sim.run(BUDGET_US * 0.1, 1000);
+  CHECK_EQ(sim.governor.mode(), OVERHEAD_FULL);
+}
+
+// A stalled tick (debugger, suspended game) reports nothing, and the
+// cycles it saw don't carry into the next window
+void TestStallIsIgnored() {
+  Sim sim;
+  sim.tick(BUDGET_US * 50.0, OverheadGovernor::MAX_WINDOW_MS + 1);
+  CHECK_EQ(sim.governor.mode(), OVERHEAD_FULL);
+  sim.tick(10.0);
+  CHECK_EQ(sim.governor.mode(), OVERHEAD_FULL);
+  CHECK(sim.governor.usPerFrame() < 11.0);
+}
+
+// Detours on several threads adding while the tick drains: nothing is lost
+void TestConcurrentAdds() {
+  OverheadGovernor governor;
+  constexpr int THREADS = 4;
+  constexpr int ADDS = 200000;
+  std::atomic<bool> done{false};
+  uint64_t nowMs = 1000;
+  governor.update(nowMs, TSC_PER_US, 1 << 30);
+
+  // One-millisecond windows, so the cycles drained are usPerFrame scaled back
+  uint64_t drained = 0;
+  auto drain = [&] {
+    governor.update(++nowMs, TSC_PER_US, 1 << 30);
+    drained += (uint64_t)(governor.usPerFrame() * TSC_PER_US /
+                              OverheadGovernor::FRAME_MS +
+                          0.5);
+  };
+  std::thread tick([&] {
+    while (!done.load())
+      drain();
+  });
+  std::vector<std::thread> detours;
+  for (int t = 0; t < THREADS; t++)
+    detours.emplace_back([&] {
+      for (int i = 0; i < ADDS; i++)
+        governor.addCycles(3);
+    });
+  for (auto &thread : detours)
+    thread.join();
+  done = true;
+  tick.join();
+  drain();
+  CHECK_EQ(drained, (uint64_t)THREADS * ADDS * 3);
+}
+
+// Sampled damage scaled by its weight stays unbiased in every mode
+void TestSamplingWeights() {
+  Sim sim;
+  const OverheadMode modes[] = {OVERHEAD_FULL, OVERHEAD_REDUCED,
+                                OVERHEAD_MINIMAL};
+  for (OverheadMode expected : modes) {
+    CHECK_EQ(sim.governor.mode(), expected);
+    int64_t scaled = 0;
+    for (int i = 0; i < 16000; i++) {
+      int weight = 0;
+      if (sim.governor.sampleDamage(weight))
+        scaled += weight;
+    }
+    CHECK_EQ(scaled, 16000);
+    sim.tick(BUDGET_US * 2.0);
+  }
+}
+
+} // namespace
+
+int main() {
+  TestMeasuresHookTime();
+  TestStepsDownImmediately();
+  TestRelaxesOnlyAfterCalm();
+  TestHoldsInHysteresisBand();
+  TestBurstsDoNotFlap();
+  TestBurstResetsCalm();
+  TestStallIsIgnored();
+  TestConcurrentAdds();
+  TestSamplingWeights();
+  return TestResult("OverheadGovernorTest");
+}
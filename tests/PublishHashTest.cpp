@@ -0,0 +1,106 @@
+// PublishedContentHash: what moves it, what doesn't, and what it costs per
+// publish.
+//
+//   g++ -std=c++17 -O2 -Iinclude tests/PublishHashTest.cpp
+
+#include "SharedTrackerData.h"
+#include "TestCheck.h"
+
+#include <chrono>
+#include <memory>
+
+namespace {
+
+struct Published {
+  std::unique_ptr<SharedTrackerData> data{new SharedTrackerData()};
+  uint64_t hash = PublishedContentHash(*data);
+
+  // Whether the content hash moved since the last call
+  bool moved() {
+    uint64_t now = PublishedContentHash(*data);
+    bool changed = now != hash;
+    hash = now;
+    return changed;
+  }
+};
+
+// Republishing the same content, and the fields that aren't content
+void TestStillContent() {
+  Published p;
+  CHECK(!p.moved());
+
+  p.data->version = p.data->version + 1;
+  p.data->publishQpc = 123456789;
+  CHECK(!p.moved());
+
+  TrackerCommand cmd = {};
+  CHECK(p.data->commands.push(cmd) != 0);
+  CHECK(!p.moved());
+
+  p.data->hookLatency[0].cycles.record(4000);
+  p.data->tscTicksPerUs = 2893.4;
+  CHECK(!p.moved());
+
+  // The session clock as displayed: whole seconds
+  p.data->sessionElapsedMs = 250;
+  CHECK(!p.moved());
+  p.data->sessionElapsedMs = 999;
+  CHECK(!p.moved());
+}
+
+// Every part the GUI shows moves it: first field, last field, and fields
+// on both sides of the excluded blocks
+void TestContentMoves() {
+  Published p;
+  p.data->magic = 0xDEADBEEF;
+  CHECK(p.moved());
+  p.data->totalKills = 1;
+  CHECK(p.moved());
+  p.data->recentLoot[9].itemName[63] = 'x';
+  CHECK(p.moved());
+  p.data->netGoldPerHour[0] = 1.5;
+  CHECK(p.moved());
+  p.data->secondsToLevel = 4380;
+  CHECK(p.moved());
+  p.data->sessionElapsedMs = 1000;
+  CHECK(p.moved());
+  p.data->publishIntervalMs = 250;
+  CHECK(p.moved());
+  p.data->overheadMode = OVERHEAD_MINIMAL;
+  CHECK(p.moved());
+  p.data->dropsUnattributed = 3;
+  CHECK(p.moved());
+
+  // A new history second, even an idle one, moves it; so does a clear
+  p.data->history.clear();
+  p.moved();
+  p.data->history.pushSecond(SeriesSample(), 1735740001000);
+  CHECK(p.moved());
+  p.data->history.clear();
+  CHECK(p.moved());
+}
+
+void BenchmarkHash() {
+  Published p;
+  constexpr int ROUNDS = 20000;
+  uint64_t sink = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int r = 0; r < ROUNDS; r++) {
+    p.data->totalKills = r;
+    sink += PublishedContentHash(*p.data);
+  }
+  auto end = std::chrono::steady_clock::now();
+  double ns =
+      std::chrono::duration<double, std::nano>(end - start).count() / ROUNDS;
+  printf("PublishedContentHash: %.0f ns per publish\n", ns);
+  CHECK(sink != 0);
+}
+
+} // namespace
+
+int main() {
+  TestStillContent();
+  TestContentMoves();
+  BenchmarkHash();
+  return TestResult("PublishHashTest");
+}
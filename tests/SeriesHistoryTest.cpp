@@ -0,0 +1,219 @@
+// SeriesHistory rollups over simulated days: every tier and every range sum
+// against a brute-force total of the raw seconds.
+//
+//   g++ -std=c++17 -O2 -Iinclude tests/SeriesHistoryTest.cpp
+
+#include "SharedTrackerData.h"
+#include "TestCheck.h"
+
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr uint32_t MINUTE = SeriesHistory::SECONDS_PER_MINUTE;
+constexpr uint32_t HOUR = SeriesHistory::SECONDS_PER_HOUR;
+constexpr uint32_t DAY = 24 * HOUR;
+constexpr int64_t EPOCH_MS = 1735740000000; // Simulated wall clock start
+
+// Feeds a history one second at a time the way the tracker's recorder does,
+// keeping every raw second for the brute-force checks
+struct Simulation {
+  std::unique_ptr<SeriesHistory> history{new SeriesHistory()};
+  std::vector<SeriesSample> seconds;
+  std::mt19937 rng{11};
+
+  Simulation() { history->clear(); }
+
+  int64_t nowMs() const { return EPOCH_MS + (int64_t)seconds.size() * 1000; }
+
+  // A fight, a loot pickup, or an idle second (the recorder pushes zeros
+  // for seconds with no events)
+  SeriesSample nextSecond() {
+    SeriesSample s;
+    uint32_t second = (uint32_t)seconds.size();
+    bool idle = second % (2 * HOUR) > 100 * MINUTE; // 20 idle minutes
+    if (!idle && rng() % 4 != 0) {
+      s.damage = rng() % 5000;
+      s.gold = rng() % 50;
+      s.xp = rng() % 300;
+      s.kills = rng() % 8 == 0;
+      s.loot = rng() % 20 == 0 ? rng() % 3 + 1 : 0;
+    }
+    return s;
+  }
+
+  void advance(uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+      SeriesSample s = nextSecond();
+      seconds.push_back(s);
+      history->pushSecond(s, nowMs());
+    }
+  }
+
+  SeriesSample bruteForce(uint32_t last) const {
+    SeriesSample total;
+    for (uint32_t i = 0; i < last && i < seconds.size(); i++)
+      total += seconds[seconds.size() - 1 - i];
+    return total;
+  }
+};
+
+bool Same(const SeriesSample &a, const SeriesSample &b) {
+  return a.damage == b.damage && a.gold == b.gold && a.xp == b.xp &&
+         a.kills == b.kills && a.loot == b.loot;
+}
+
+// Seconds, minutes, hours and days, each just under, on and over a boundary
+const uint32_t QUERIES[] = {1,        30,       59,       60,
+                            61,       600,      HOUR - 1, HOUR,
+                            HOUR + 1, 6 * HOUR + 17,     DAY - 1,
+                            DAY,      DAY + 59, 25 * HOUR + 59,
+                            3 * DAY,  7 * DAY};
+
+// sumLast over many ranges, checked at irregular points in the run so the
+// minute and hour boundaries fall at every offset
+int CheckRanges(Simulation &sim) {
+  int checked = 0;
+  uint32_t written = (uint32_t)sim.seconds.size();
+  for (uint32_t query : QUERIES) {
+    uint32_t covered = 0;
+    SeriesSample sum = sim.history->sumLast(query, &covered);
+    uint32_t expected = query < written ? query : written;
+    // Seconds older than the per-second tier are only kept per minute, and
+    // older than the per-minute tier only per hour, so a longer range may
+    // stop short by less than one of those
+    uint32_t slack = expected <= HOUR  ? 0
+                     : expected <= DAY ? MINUTE - 1
+                                       : HOUR - 1;
+    uint32_t minimum = expected - slack;
+    if (!Same(sum, sim.bruteForce(covered)) || covered > expected ||
+        covered < minimum) {
+      fprintf(stderr, "sumLast(%u) at second %u: covered %u\n", query,
+              written, covered);
+      g_testFailures++;
+    }
+    checked++;
+  }
+  return checked;
+}
+
+// A day and a bit, checking ranges as it goes
+void TestDayLongRanges() {
+  Simulation sim;
+  int checked = 0;
+  uint32_t step = 997; // Prime, so checks drift across boundaries
+  while (sim.seconds.size() < DAY + 2 * HOUR) {
+    sim.advance(step);
+    checked += CheckRanges(sim);
+    step = step == 997 ? 61 : step == 61 ? 3599 : 997;
+  }
+  // Exactly on boundaries too
+  sim.advance(HOUR - sim.seconds.size() % HOUR);
+  checked += CheckRanges(sim);
+  sim.advance(MINUTE);
+  checked += CheckRanges(sim);
+  CHECK(checked > 1000);
+}
+
+// The coarse tiers hold exactly the sums of the seconds they replace
+void TestTiersRollUp() {
+  Simulation sim;
+  sim.advance(DAY + 3 * HOUR + 5 * MINUTE + 7);
+  const SeriesHistory &h = *sim.history;
+  uint32_t written = (uint32_t)sim.seconds.size();
+
+  CHECK_EQ(h.perSecond.head, written);
+  CHECK_EQ(h.perMinute.head, written / MINUTE);
+  CHECK_EQ(h.perHour.head, written / HOUR);
+  CHECK_EQ(h.perMinute.available(), 1440);
+  CHECK_EQ(h.perHour.available(), (int)(written / HOUR));
+
+  // Newest minute and hour against their seconds
+  uint32_t minuteEnd = written / MINUTE * MINUTE;
+  SeriesSample minute;
+  for (uint32_t s = minuteEnd - MINUTE; s < minuteEnd; s++)
+    minute += sim.seconds[s];
+  CHECK(Same(h.perMinute.sum(0, 1), minute));
+
+  uint32_t hourEnd = written / HOUR * HOUR;
+  SeriesSample hour;
+  for (uint32_t s = hourEnd - HOUR; s < hourEnd; s++)
+    hour += sim.seconds[s];
+  CHECK(Same(h.perHour.sum(0, 1), hour));
+
+  // The partial minute and hour since the last boundaries
+  SeriesSample partialMinute, partialHour;
+  for (uint32_t s = minuteEnd; s < written; s++)
+    partialMinute += sim.seconds[s];
+  for (uint32_t s = hourEnd; s < written; s++)
+    partialHour += sim.seconds[s];
+  CHECK(Same(h.minuteSoFar, partialMinute));
+  CHECK(Same(h.hourSoFar, partialHour));
+
+  // Every hour in the ring is the sum of its 60 minutes (for the minutes
+  // the minute tier still holds)
+  for (int hourAgo = 0; hourAgo < 23; hourAgo++) {
+    SeriesSample minutes =
+        h.perMinute.sum((int)(written / MINUTE % 60) + hourAgo * 60, 60);
+    CHECK(Same(minutes, h.perHour.sum(hourAgo, 1)));
+  }
+
+  // Timestamps: the newest sample of each tier ends on its boundary
+  CHECK_EQ(h.perSecond.headTime, EPOCH_MS + (int64_t)written * 1000);
+  CHECK_EQ(h.perMinute.headTime, EPOCH_MS + (int64_t)minuteEnd * 1000);
+  CHECK_EQ(h.perHour.headTime, EPOCH_MS + (int64_t)hourEnd * 1000);
+}
+
+// Windows copied out of a wrapped ring, oldest first
+void TestCopyWindow() {
+  Simulation sim;
+  sim.advance(HOUR + 1234);
+  const auto &ring = sim.history->perSecond;
+  std::vector<int64_t> gold(HOUR);
+  CHECK_EQ(ring.copyWindow(ring.gold, HOUR, gold.data()), (int)HOUR);
+  bool ordered = true;
+  for (uint32_t i = 0; i < HOUR; i++)
+    if (gold[i] != sim.seconds[sim.seconds.size() - HOUR + i].gold)
+      ordered = false;
+  CHECK(ordered);
+  CHECK_EQ(ring.copyWindow(ring.gold, HOUR + 10, gold.data()), (int)HOUR);
+}
+
+// A week and a day: the hour tier wraps and the longest range is a week
+void TestWeekWraps() {
+  Simulation sim;
+  sim.advance(8 * DAY + 30 * MINUTE);
+  const SeriesHistory &h = *sim.history;
+  CHECK_EQ(h.perHour.available(), 168);
+  CHECK_EQ(h.perHour.head, 8u * 24);
+
+  uint32_t covered = 0;
+  SeriesSample week = h.sumLast(8 * DAY, &covered);
+  CHECK_EQ(covered, 30 * MINUTE + 168 * HOUR);
+  CHECK(Same(week, sim.bruteForce(covered)));
+  CheckRanges(sim);
+}
+
+void TestClear() {
+  Simulation sim;
+  sim.advance(2 * HOUR);
+  sim.history->clear();
+  uint32_t covered = 1;
+  SeriesSample sum = sim.history->sumLast(DAY, &covered);
+  CHECK_EQ(covered, 0u);
+  CHECK(Same(sum, SeriesSample()));
+  CHECK_EQ(sim.history->perMinute.intervalMs, MINUTE * 1000);
+}
+
+} // namespace
+
+int main() {
+  TestDayLongRanges();
+  TestTiersRollUp();
+  TestCopyWindow();
+  TestWeekWraps();
+  TestClear();
+  return TestResult("SeriesHistoryTest");
+}
@@ -0,0 +1,281 @@
+// SessionArchive encode and decode round trips, the per-column RLE/delta
+// choice, block skipping by column stats, and corrupt input that attach()
+// and decodeColumn() must reject.
+//
+//   g++ -std=c++17 -O2 -Iinclude tests/SessionArchiveTest.cpp
+
+#include "SessionArchive.h"
+#include "TestCheck.h"
+
+#include <climits>
+#include <cstdlib>
+#include <unistd.h>
+
+namespace {
+
+// A session spanning three blocks: kills and loot every 250-1000 ms, ids
+// and qualities that repeat, one huge gold pickup
+std::vector<ArchiveEvent> MakeSession(int64_t startMs, size_t count) {
+  std::vector<ArchiveEvent> events(count);
+  int64_t t = startMs;
+  for (size_t i = 0; i < count; i++) {
+    ArchiveEvent &e = events[i];
+    t += 250 + (int64_t)(i * 7919 % 751);
+    e.timestampMs = t;
+    e.type = i % 3 == 0 ? ARCHIVE_KILL : ARCHIVE_LOOT;
+    e.id = e.type == ARCHIVE_KILL ? (uint32_t)(i / 3 % 4) : 417;
+    e.amount = e.type == ARCHIVE_LOOT ? 1 + (int64_t)(i % 5) : 0;
+    e.value = e.amount * 120;
+    e.quality = e.type == ARCHIVE_LOOT ? 2 : 0;
+  }
+  events[count / 2].type = ARCHIVE_GOLD;
+  events[count / 2].amount = INT64_MAX;
+  return events;
+}
+
+const std::vector<std::string> NAMES = {"Forest Wolf", "Skeleton",
+                                        "Bandit Lord", ""};
+
+int64_t ColumnOf(const ArchiveEvent &e, int c) {
+  int64_t values[ARCHIVE_COLUMNS] = {e.timestampMs, e.type,  e.id,
+                                     e.amount,      e.value, e.quality};
+  return values[c];
+}
+
+// Every column of every block decodes back to the events, stats included
+bool MatchesEvents(const SessionArchive &archive,
+                   const std::vector<ArchiveEvent> &events) {
+  std::vector<int64_t> column(ARCHIVE_BLOCK_EVENTS);
+  uint32_t seen = 0;
+  for (uint32_t b = 0; b < archive.blockCount(); b++) {
+    const ArchiveBlockInfo &block = archive.block(b);
+    if (block.firstEvent != seen)
+      return false;
+    for (int c = 0; c < ARCHIVE_COLUMNS; c++) {
+      if (!archive.decode(b, c, column.data()))
+        return false;
+      for (uint32_t i = 0; i < block.eventCount; i++) {
+        int64_t expected = ColumnOf(events[block.firstEvent + i], c);
+        if (column[i] != expected || expected < block.min[c] ||
+            expected > block.max[c])
+          return false;
+      }
+    }
+    seen += block.eventCount;
+  }
+  return seen == events.size();
+}
+
+void TestRoundTrip() {
+  const int64_t startMs = 1735740000000;
+  std::vector<ArchiveEvent> events = MakeSession(startMs, 10000);
+  std::vector<uint8_t> bytes =
+      EncodeSessionArchive(events, NAMES, startMs, startMs + 3600000);
+
+  SessionArchive archive;
+  CHECK(archive.attach(bytes.data(), bytes.size()));
+  CHECK_EQ(archive.header().eventCount, 10000u);
+  CHECK_EQ(archive.blockCount(), 3u);
+  CHECK_EQ(archive.block(2).eventCount, 10000u - 2 * ARCHIVE_BLOCK_EVENTS);
+  CHECK_EQ(archive.header().endMs, startMs + 3600000);
+  CHECK(MatchesEvents(archive, events));
+
+  CHECK(strcmp(archive.name(2), "Bandit Lord") == 0);
+  CHECK(strcmp(archive.name(3), "") == 0);
+  CHECK(strcmp(archive.name(4), "") == 0);
+  CHECK(strcmp(archive.name(-1), "") == 0);
+
+  // Columnar and varint-coded: under a third of the 40 bytes an event
+  // takes raw, even with these jittery timestamps and alternating types
+  printf("SessionArchive: %.2f bytes/event\n",
+         (double)bytes.size() / events.size());
+  CHECK(bytes.size() < events.size() * 12);
+
+  // An empty session is still a valid archive
+  std::vector<uint8_t> empty = EncodeSessionArchive({}, {}, startMs, startMs);
+  CHECK(archive.attach(empty.data(), empty.size()));
+  CHECK_EQ(archive.blockCount(), 0u);
+}
+
+// Through a real file and the mapped reader
+void TestMappedFile() {
+  std::vector<ArchiveEvent> events = MakeSession(0, 5000);
+  std::vector<uint8_t> bytes = EncodeSessionArchive(events, NAMES, 0, 1);
+  char path[] = "/tmp/SessionArchiveTestXXXXXX";
+  int fd = mkstemp(path);
+  CHECK(fd >= 0);
+  CHECK(write(fd, bytes.data(), bytes.size()) == (ssize_t)bytes.size());
+  ::close(fd);
+
+  SessionArchiveFile file;
+  CHECK(file.open(path));
+  CHECK_EQ(file.size(), bytes.size());
+  CHECK(MatchesEvents(file.archive(), events));
+  file.close();
+  CHECK(!file.archive().loaded());
+
+  // Truncated on disk: attach rejects it and open fails
+  CHECK(truncate(path, (off_t)bytes.size() / 2) == 0);
+  CHECK(!file.open(path));
+  unlink(path);
+}
+
+// Each column keeps whichever encoding is smaller
+void TestEncodingChoice() {
+  std::vector<int64_t> runs(ARCHIVE_BLOCK_EVENTS, 417);
+  for (size_t i = 2000; i < runs.size(); i++)
+    runs[i] = 418;
+  std::vector<uint8_t> out;
+  ArchiveCodec::encodeColumn(runs.data(), (uint32_t)runs.size(), out);
+  CHECK_EQ(out[0], ARCHIVE_ENC_RLE);
+  CHECK(out.size() <= 9); // Tag, then two (delta, run) pairs
+
+  // Timestamps never repeat: RLE would add a run length to every value
+  std::vector<int64_t> times(ARCHIVE_BLOCK_EVENTS);
+  for (size_t i = 0; i < times.size(); i++)
+    times[i] = 1735740000000 + (int64_t)(i * 300 + i % 7);
+  out.clear();
+  ArchiveCodec::encodeColumn(times.data(), (uint32_t)times.size(), out);
+  CHECK_EQ(out[0], ARCHIVE_ENC_DELTA);
+
+  // Both decode back exactly, extremes included
+  const int64_t extremes[] = {INT64_MIN, INT64_MAX, 0, -1, INT64_MIN, 5, 5};
+  for (const std::vector<int64_t> &values :
+       {runs, times, std::vector<int64_t>(extremes, extremes + 7)}) {
+    out.clear();
+    ArchiveCodec::encodeColumn(values.data(), (uint32_t)values.size(), out);
+    std::vector<int64_t> back(values.size());
+    CHECK(ArchiveCodec::decodeColumn(out.data(), out.data() + out.size(),
+                                     (uint32_t)values.size(), back.data()));
+    CHECK(back == values);
+  }
+}
+
+// Block stats let a query skip blocks it can't match
+void TestBlockSkipping() {
+  const int64_t startMs = 1735740000000;
+  std::vector<ArchiveEvent> events = MakeSession(startMs, 10000);
+  events[9000].quality = 5; // One legendary, in the last block
+  std::vector<uint8_t> bytes = EncodeSessionArchive(events, NAMES, 0, 0);
+  SessionArchive archive;
+  CHECK(archive.attach(bytes.data(), bytes.size()));
+
+  // A time range inside block 1 touches only block 1
+  int64_t lo = events[5000].timestampMs, hi = events[6000].timestampMs;
+  CHECK(!archive.blockMayMatch(0, ARCHIVE_COL_TIME, lo, hi));
+  CHECK(archive.blockMayMatch(1, ARCHIVE_COL_TIME, lo, hi));
+  CHECK(!archive.blockMayMatch(2, ARCHIVE_COL_TIME, lo, hi));
+
+  CHECK(!archive.blockMayMatch(0, ARCHIVE_COL_QUALITY, 5, 5));
+  CHECK(!archive.blockMayMatch(1, ARCHIVE_COL_QUALITY, 5, 5));
+  CHECK(archive.blockMayMatch(2, ARCHIVE_COL_QUALITY, 5, 5));
+
+  // The gold pickup's amount is only in block 1's range
+  CHECK(archive.blockMayMatch(1, ARCHIVE_COL_AMOUNT, INT64_MAX, INT64_MAX));
+  CHECK(!archive.blockMayMatch(2, ARCHIVE_COL_AMOUNT, INT64_MAX, INT64_MAX));
+}
+
+ArchiveHeader &HeaderOf(std::vector<uint8_t> &bytes) {
+  return *(ArchiveHeader *)bytes.data();
+}
+ArchiveBlockInfo &FirstBlockOf(std::vector<uint8_t> &bytes) {
+  return *(ArchiveBlockInfo *)(bytes.data() + HeaderOf(bytes).blocksOffset);
+}
+
+// Headers and tables that point outside the file, or lie about it
+void TestCorruptArchive() {
+  std::vector<uint8_t> good =
+      EncodeSessionArchive(MakeSession(0, 5000), NAMES, 0, 1);
+  SessionArchive archive;
+  CHECK(!archive.attach(nullptr, 0));
+  CHECK(!archive.attach(good.data(), sizeof(ArchiveHeader) - 1));
+  CHECK(!archive.attach(good.data(), good.size() - 1)); // Names cut short
+  CHECK(archive.attach(good.data(), good.size()));
+
+  auto rejected = [&](void (*corrupt)(std::vector<uint8_t> &)) {
+    std::vector<uint8_t> bytes = good;
+    corrupt(bytes);
+    SessionArchive a;
+    return !a.attach(bytes.data(), bytes.size()) && !a.loaded();
+  };
+
+  CHECK(rejected([](std::vector<uint8_t> &b) { HeaderOf(b).magic = 0; }));
+  CHECK(rejected([](std::vector<uint8_t> &b) {
+    HeaderOf(b).version = ARCHIVE_VERSION + 1;
+  }));
+  CHECK(rejected([](std::vector<uint8_t> &b) { HeaderOf(b).blockCount++; }));
+  CHECK(rejected([](std::vector<uint8_t> &b) { HeaderOf(b).blocksOffset++; }));
+  CHECK(rejected([](std::vector<uint8_t> &b) {
+    HeaderOf(b).blocksOffset = 0xFFFFFFF8;
+  }));
+  CHECK(rejected([](std::vector<uint8_t> &b) { HeaderOf(b).nameCount = ~0u; }));
+  CHECK(rejected([](std::vector<uint8_t> &b) { HeaderOf(b).namesSize++; }));
+  CHECK(rejected([](std::vector<uint8_t> &b) {
+    b.back() = 'x'; // Last name unterminated
+  }));
+  CHECK(rejected([](std::vector<uint8_t> &b) {
+    FirstBlockOf(b).eventCount = ARCHIVE_BLOCK_EVENTS + 1;
+  }));
+  CHECK(rejected([](std::vector<uint8_t> &b) {
+    FirstBlockOf(b).offset[ARCHIVE_COL_VALUE] = (uint32_t)b.size();
+    FirstBlockOf(b).size[ARCHIVE_COL_VALUE] = 1;
+  }));
+  CHECK(rejected([](std::vector<uint8_t> &b) {
+    FirstBlockOf(b).size[ARCHIVE_COL_TIME] = 0xFFFFFFF0;
+  }));
+
+  // A name offset past the chars reads as no name rather than past the end
+  std::vector<uint8_t> bytes = good;
+  uint32_t bad = HeaderOf(bytes).namesSize;
+  memcpy(bytes.data() + HeaderOf(bytes).namesOffset, &bad, sizeof(bad));
+  CHECK(archive.attach(bytes.data(), bytes.size()));
+  CHECK(strcmp(archive.name(0), "") == 0);
+  CHECK(strcmp(archive.name(1), "Skeleton") == 0);
+}
+
+// Column runs that attach() can't see into: decode reports them
+void TestCorruptColumn() {
+  auto decodes = [](std::vector<uint8_t> run, uint32_t count) {
+    std::vector<int64_t> out(count + 1);
+    return ArchiveCodec::decodeColumn(run.data(), run.data() + run.size(),
+                                      count, out.data());
+  };
+  CHECK(decodes({ARCHIVE_ENC_DELTA, 2, 2, 0}, 3));
+  CHECK(decodes({ARCHIVE_ENC_RLE, 2, 3}, 3));
+
+  CHECK(!decodes({}, 1));                        // No encoding byte
+  CHECK(!decodes({7, 2, 2}, 2));                 // Unknown encoding
+  CHECK(!decodes({ARCHIVE_ENC_DELTA, 2, 2}, 3)); // Too few values
+  CHECK(!decodes({ARCHIVE_ENC_DELTA, 0x80}, 1)); // Varint cut off
+  CHECK(!decodes({ARCHIVE_ENC_RLE, 2}, 1));      // Run length missing
+  CHECK(!decodes({ARCHIVE_ENC_RLE, 2, 0}, 1));   // Empty run
+  CHECK(!decodes({ARCHIVE_ENC_RLE, 2, 4}, 3));   // Run past the block
+  CHECK(!decodes({ARCHIVE_ENC_RLE, 2, 2}, 3));   // Runs stop short
+
+  // A varint that never ends stops after 64 bits instead of reading on
+  std::vector<uint8_t> endless(1 + 16, 0xFF);
+  endless[0] = ARCHIVE_ENC_DELTA;
+  endless.push_back(0x01);
+  CHECK(!decodes(endless, 1));
+
+  // Deltas that overflow wrap instead of being undefined
+  std::vector<uint8_t> wraps = {ARCHIVE_ENC_DELTA};
+  ArchiveCodec::putVarint(wraps, ArchiveCodec::zigzag(INT64_MAX));
+  ArchiveCodec::putVarint(wraps, ArchiveCodec::zigzag(INT64_MAX));
+  std::vector<int64_t> out(2);
+  CHECK(ArchiveCodec::decodeColumn(wraps.data(), wraps.data() + wraps.size(),
+                                   2, out.data()));
+  CHECK_EQ(out[1], -2);
+}
+
+} // namespace
+
+int main() {
+  TestRoundTrip();
+  TestMappedFile();
+  TestEncodingChoice();
+  TestBlockSkipping();
+  TestCorruptArchive();
+  TestCorruptColumn();
+  return TestResult("SessionArchiveTest");
+}
@@ -0,0 +1,144 @@
+// ShardedCounters under many producers: exact totals, reads and resets
+// while adds are in flight.
+//
+//   g++ -std=c++17 -O2 -pthread -Iinclude tests/ShardedCountersTest.cpp
+
+#include "ShardedCounters.h"
+#include "TestCheck.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr int ADDS = 200000;
+
+enum { COUNT, WEIGHTED, NEGATIVE, COUNTERS };
+
+template <typename Fn> void RunThreads(int threads, Fn &&body) {
+  std::vector<std::thread> pool;
+  for (int t = 0; t < threads; t++)
+    pool.emplace_back(body, t);
+  for (auto &thread : pool)
+    thread.join();
+}
+
+// More producers than shards, so some share one; add stays exact
+void TestExactTotals() {
+  ShardedCounters<COUNTERS, 8> counters;
+  constexpr int THREADS = 12;
+  RunThreads(THREADS, [&](int t) {
+    for (int i = 0; i < ADDS; i++) {
+      counters.add(COUNT, 1);
+      counters.add(WEIGHTED, t);
+      counters.add(NEGATIVE, -3);
+    }
+  });
+  int64_t weighted = 0;
+  for (int t = 0; t < THREADS; t++)
+    weighted += (int64_t)ADDS * t;
+  CHECK_EQ(counters.read(COUNT), (int64_t)THREADS * ADDS);
+  CHECK_EQ(counters.read(WEIGHTED), weighted);
+  CHECK_EQ(counters.read(NEGATIVE), -3LL * THREADS * ADDS);
+}
+
+// A reader during the adds only ever sees the total grow
+void TestReadsWhileAdding() {
+  ShardedCounters<COUNTERS, 8> counters;
+  constexpr int THREADS = 6;
+  std::atomic<bool> done{false};
+  bool monotonic = true;
+  std::thread reader([&] {
+    int64_t last = 0;
+    while (!done.load()) {
+      int64_t now = counters.read(COUNT);
+      if (now < last)
+        monotonic = false;
+      last = now;
+    }
+  });
+  RunThreads(THREADS, [&](int) {
+    for (int i = 0; i < ADDS; i++)
+      counters.add(COUNT, 1);
+  });
+  done = true;
+  reader.join();
+  CHECK(monotonic);
+  CHECK_EQ(counters.read(COUNT), (int64_t)THREADS * ADDS);
+}
+
+// Reset between phases counts only what came after it
+void TestResetBetweenPhases() {
+  ShardedCounters<COUNTERS, 8> counters;
+  constexpr int THREADS = 10;
+  auto phase = [&](int64_t amount) {
+    RunThreads(THREADS, [&](int) {
+      for (int i = 0; i < ADDS; i++)
+        counters.add(WEIGHTED, amount);
+    });
+  };
+  phase(5);
+  CHECK_EQ(counters.read(WEIGHTED), 5LL * THREADS * ADDS);
+  counters.reset();
+  CHECK_EQ(counters.read(WEIGHTED), 0);
+  phase(2);
+  CHECK_EQ(counters.read(WEIGHTED), 2LL * THREADS * ADDS);
+  CHECK_EQ(counters.read(COUNT), 0); // Untouched counters stay at zero
+  counters.reset();
+  counters.reset();
+  CHECK_EQ(counters.read(WEIGHTED), 0);
+}
+
+// Resets racing with adds: nothing is lost or invented, so after the last
+// reset the reading is exactly what was added since
+void TestResetWhileAdding() {
+  ShardedCounters<COUNTERS, 8> counters;
+  constexpr int THREADS = 8;
+  std::atomic<bool> done{false};
+  std::thread resetter([&] {
+    while (!done.load()) {
+      counters.reset();
+      int64_t value = counters.read(COUNT);
+      CHECK(value >= 0 && value <= (int64_t)THREADS * ADDS);
+    }
+  });
+  RunThreads(THREADS, [&](int) {
+    for (int i = 0; i < ADDS; i++)
+      counters.add(COUNT, 1);
+  });
+  done = true;
+  resetter.join();
+  int64_t value = counters.read(COUNT);
+  CHECK(value >= 0 && value <= (int64_t)THREADS * ADDS);
+
+  counters.reset();
+  RunThreads(THREADS, [&](int) {
+    for (int i = 0; i < 1000; i++)
+      counters.add(COUNT, 1);
+  });
+  CHECK_EQ(counters.read(COUNT), (int64_t)THREADS * 1000);
+}
+
+// addApprox is exact while every thread has a shard of its own. This
+// instantiation's shard assignment is used by these threads only.
+void TestApproxOwnShards() {
+  ShardedCounters<COUNTERS, 64> counters;
+  constexpr int THREADS = 8;
+  RunThreads(THREADS, [&](int) {
+    for (int i = 0; i < ADDS; i++)
+      counters.addApprox(COUNT, 1);
+  });
+  CHECK_EQ(counters.read(COUNT), (int64_t)THREADS * ADDS);
+}
+
+} // namespace
+
+int main() {
+  TestExactTotals();
+  TestReadsWhileAdding();
+  TestResetBetweenPhases();
+  TestResetWhileAdding();
+  TestApproxOwnShards();
+  return TestResult("ShardedCountersTest");
+}
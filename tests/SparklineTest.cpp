@@ -0,0 +1,248 @@
+// SparklineCanvas against golden images, its edge cases, and the cost of
+// rendering the Stats tab's sparkline row.
+//
+//   g++ -std=c++17 -O2 -Iinclude tests/SparklineTest.cpp
+
+#include "Sparkline.h"
+#include "TestCheck.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+constexpr uint32_t BLACK = 0xFF000000;
+constexpr uint32_t RED = 0xFFFF0000;
+
+// A small canvas over black; red is drawn on it, so each pixel's red
+// channel is the coverage it got
+struct Image {
+  static constexpr int W = 16;
+  static constexpr int H = 8;
+  uint32_t pixels[W * H];
+  SparklineCanvas canvas{pixels, W, H, W};
+
+  Image() { canvas.clear(BLACK); }
+
+  // Golden rows are the red channel as two hex digits per pixel; green and
+  // blue stay zero and every pixel stays opaque
+  void expect(const char *name, const char *const (&golden)[H]) const {
+    int wrong = 0;
+    for (int y = 0; y < H; y++) {
+      for (int x = 0; x < W; x++) {
+        unsigned red = 0;
+        sscanf(golden[y] + x * 2, "%2x", &red);
+        if (pixels[y * W + x] != (BLACK | red << 16))
+          wrong++;
+      }
+    }
+    if (wrong) {
+      fprintf(stderr, "%s: %d pixels differ, got:\n", name, wrong);
+      for (int y = 0; y < H; y++) {
+        fprintf(stderr, "    \"");
+        for (int x = 0; x < W; x++)
+          fprintf(stderr, "%02X", pixels[y * W + x] >> 16 & 0xFF);
+        fprintf(stderr, "\",\n");
+      }
+      g_testFailures++;
+    }
+  }
+};
+
+// Points at x = 0, 3, 6, 9, 12, 15 with heights 0, 3, 7, 2, 5, 5
+const float SERIES[] = {0, 3, 7, 2, 5, 5};
+
+void TestLineGolden() {
+  Image image;
+  image.canvas.drawLine(SERIES, 6, 0.0f, RED);
+  image.expect("line", {
+                           "000000000000FF000000000000000000",
+                           "0000000000BF8C990000000000000000",
+                           "00000000808000CC33000000FFFFFFFF",
+                           "00000040BF000033CC0000FF00000000",
+                           "000000FF000000009966FF0000000000",
+                           "0000FF000000000000FF000000000000",
+                           "00FF0000000000000000000000000000",
+                           "FF000000000000000000000000000000",
+                       });
+}
+
+void TestAreaGolden() {
+  Image image;
+  image.canvas.drawArea(SERIES, 6, 0.0f, RED);
+  image.expect("area", {
+                           "000000000000FF000000000000000000",
+                           "0000000000AAFF550000000000000000",
+                           "0000000055FFFFFF00000000FFFFFFFF",
+                           "00000000FFFFFFFFAA0000FFFFFFFFFF",
+                           "000000FFFFFFFFFFFF00FFFFFFFFFFFF",
+                           "0000FFFFFFFFFFFFFFFFFFFFFFFFFFFF",
+                           "00FFFFFFFFFFFFFFFFFFFFFFFFFFFFFF",
+                           "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF",
+                       });
+}
+
+// The GUI's layering: a half-transparent area under an opaque line, with
+// a fixed scale above the series' max
+void TestAreaUnderLineGolden() {
+  Image image;
+  const float values[] = {1, 2, 4, 3};
+  image.canvas.drawArea(values, 4, 8.0f, 0x80FF0000);
+  image.canvas.drawLine(values, 4, 8.0f, RED);
+  image.expect("area under line", {
+                                      "00000000000000000000000000000000",
+                                      "00000000000000000000000000000000",
+                                      "00000000000000000000000000000000",
+                                      "00000000000000000036CF6F36000000",
+                                      "0000000000002592E1ECE0D6ECFCE1BD",
+                                      "00134F84B3F5F3C699808080808399B0",
+                                      "EDF9E3CCB6B880808080808080808080",
+                                      "90808080808080808080808080808080",
+                                  });
+}
+
+// Blending: opaque replaces exactly, transparent changes nothing, half
+// lands halfway, on any background
+void TestBlend() {
+  uint32_t pixels[4 * 2];
+  SparklineCanvas canvas(pixels, 4, 2, 4);
+  const float full[] = {1, 1};
+  for (uint32_t background : {0xFF000000u, 0xFFFFFFFFu, 0xFF123456u}) {
+    canvas.clear(background);
+    canvas.drawArea(full, 2, 1.0f, 0xFF80C0E0);
+    CHECK_EQ(pixels[5], 0xFF80C0E0u);
+    canvas.clear(background);
+    canvas.drawArea(full, 2, 1.0f, 0x0080C0E0);
+    CHECK_EQ(pixels[5], background);
+  }
+  canvas.clear(BLACK);
+  canvas.drawArea(full, 2, 1.0f, 0x80FFFFFF);
+  CHECK_EQ(pixels[5], 0xFF808080u);
+  canvas.clear(0xFFFFFFFF);
+  canvas.drawArea(full, 2, 1.0f, 0x80000000);
+  CHECK_EQ(pixels[5], 0xFF7F7F7Fu); // The two halves add up to white
+}
+
+// Wu's lines put one pixel's worth of coverage in every column a shallow
+// segment crosses
+void TestLineCoverage() {
+  constexpr int W = 200, H = 40;
+  std::vector<uint32_t> pixels(W * H);
+  SparklineCanvas canvas(pixels.data(), W, H, W);
+  float values[50];
+  for (int i = 0; i < 50; i++)
+    values[i] = 10.0f + 8.0f * sinf(i * 0.3f);
+  canvas.clear(BLACK);
+  canvas.drawLine(values, 50, 20.0f, RED);
+  bool even = true;
+  for (int x = 1; x < W - 1; x++) {
+    int total = 0;
+    for (int y = 0; y < H; y++)
+      total += pixels[y * W + x] >> 16 & 0xFF;
+    // Shallow everywhere, so one column never sees two segments' worth
+    if (total < 250 || total > 2 * 255)
+      even = false;
+  }
+  CHECK(even);
+}
+
+void TestDegenerate() {
+  Image image;
+  const float one[] = {5};
+  image.canvas.drawLine(one, 1, 0.0f, RED);
+  image.canvas.drawArea(one, 1, 0.0f, RED);
+  image.canvas.drawLine(one, 0, 0.0f, RED);
+  bool untouched = true;
+  for (uint32_t p : image.pixels)
+    untouched = untouched && p == BLACK;
+  CHECK(untouched);
+
+  // All zero (or negative) sits on the bottom row; over max clamps to the
+  // top row
+  const float flat[] = {0, -4, 0};
+  image.canvas.drawLine(flat, 3, 0.0f, RED);
+  for (int x = 0; x < Image::W; x++) {
+    CHECK_EQ(image.pixels[(Image::H - 1) * Image::W + x], RED);
+    CHECK_EQ(image.pixels[(Image::H - 2) * Image::W + x], BLACK);
+  }
+  image.canvas.clear(BLACK);
+  const float high[] = {100, 100};
+  image.canvas.drawLine(high, 2, 10.0f, RED);
+  CHECK_EQ(image.pixels[3], RED);
+  CHECK_EQ(image.pixels[Image::W + 3], BLACK);
+
+  // A one-pixel canvas is too small to draw into
+  uint32_t pixel = BLACK;
+  SparklineCanvas tiny(&pixel, 1, 1, 1);
+  tiny.drawLine(SERIES, 6, 0.0f, RED);
+  tiny.drawArea(SERIES, 6, 0.0f, RED);
+  CHECK_EQ(pixel, BLACK);
+}
+
+// Canvases sharing one buffer side by side only touch their own columns
+void TestStride() {
+  constexpr int W = 10, H = 6, GAP = 3, ROW = W * 2 + GAP;
+  uint32_t pixels[ROW * H];
+  SparklineCanvas row(pixels, ROW, H, ROW);
+  row.clear(0xFF0000FF);
+  SparklineCanvas left(pixels, W, H, ROW);
+  SparklineCanvas right(pixels + W + GAP, W, H, ROW);
+  left.drawArea(SERIES, 6, 0.0f, RED);
+  right.drawArea(SERIES, 6, 0.0f, RED);
+  left.drawLine(SERIES, 6, 0.0f, 0xFF00FF00);
+  right.drawLine(SERIES, 6, 0.0f, 0xFF00FF00);
+  for (int y = 0; y < H; y++)
+    for (int x = W; x < W + GAP; x++)
+      CHECK_EQ(pixels[y * ROW + x], 0xFF0000FFu);
+  CHECK(memcmp(pixels, pixels + W + GAP, W * sizeof(uint32_t)) == 0);
+  CHECK(pixels[(H - 1) * ROW] != 0xFF0000FFu);
+}
+
+// The Stats tab's row: three 86x28 charts in one buffer, 90 seconds of DPS
+// and an hour of XP and gold in minute bins
+void BenchmarkStatsRow() {
+  constexpr int W = 86, H = 28, GAP = 6, ROW = W * 3 + GAP * 2;
+  static uint32_t pixels[ROW * H];
+  float dps[90], xp[60], gold[60];
+  for (int i = 0; i < 90; i++)
+    dps[i] = (float)(i * 7919 % 5000);
+  for (int i = 0; i < 60; i++) {
+    xp[i] = 20000.0f + (float)(i * 104729 % 9000);
+    gold[i] = (float)(i * 1299709 % 3000);
+  }
+  const float *series[3] = {dps, xp, gold};
+  const int counts[3] = {90, 60, 60};
+
+  constexpr int ROUNDS = 20000;
+  auto start = std::chrono::steady_clock::now();
+  for (int r = 0; r < ROUNDS; r++) {
+    SparklineCanvas(pixels, ROW, H, ROW).clear(0xFF12121C);
+    for (int c = 0; c < 3; c++) {
+      SparklineCanvas canvas(pixels + c * (W + GAP), W, H, ROW);
+      canvas.clear(0xFF1E1E32);
+      canvas.drawArea(series[c], counts[c], 0.0f, 0x50FF9632);
+      canvas.drawLine(series[c], counts[c], 0.0f, 0xFFFF9632);
+    }
+  }
+  auto end = std::chrono::steady_clock::now();
+  double us =
+      std::chrono::duration<double, std::micro>(end - start).count() / ROUNDS;
+  printf("Sparkline: %.1f us per Stats row (%dx%d)\n", us, ROW, H);
+  CHECK(pixels[(H - 1) * ROW] != 0xFF1E1E32u);
+}
+
+} // namespace
+
+int main() {
+  TestLineGolden();
+  TestAreaGolden();
+  TestAreaUnderLineGolden();
+  TestBlend();
+  TestLineCoverage();
+  TestDegenerate();
+  TestStride();
+  BenchmarkStatsRow();
+  return TestResult("SparklineTest");
+}
@@ -0,0 +1,228 @@
+// Startup stage 3 against a simulated game whose singletons (and code) show
+// up late: the signature cache, the backoff, the deadline and stop.
+//
+//   g++ -std=c++17 -O2 -Iinclude tests/StartupPollTest.cpp
+
+#include "StartupPoll.h"
+#include "TestCheck.h"
+
+#include <vector>
+
+namespace {
+
+// The DLL's patterns for the instructions that load the two singletons
+const char *PATTERN_APPLICATION = "A1 ?? ?? ?? ?? 85 C0 74 ?? 8B 40";
+const char *PATTERN_CONTENTMGR = "A1 ?? ?? ?? ?? 8B ?? ?? 85 C0";
+
+constexpr uint32_t APPLICATION_GLOBAL = 0x00A0B0C0;
+constexpr uint32_t CONTENTMGR_GLOBAL = 0x00A0B0D0;
+constexpr uint64_t TIMEOUT_MS = 10000; // Tracker::READY_TIMEOUT_MS
+constexpr uint64_t NEVER = ~0ull;
+
+// Sleeps advance simulated time; each wait is recorded. It can also set the
+// stop flag at a given time, like an unload arriving mid-startup.
+struct SimClock {
+  uint64_t now = 0;
+  std::vector<uint32_t> waits;
+  std::atomic<bool> *stop = nullptr;
+  uint64_t stopAtMs = NEVER;
+
+  uint64_t nowMs() const { return now; }
+  void sleepMs(uint32_t ms) {
+    waits.push_back(ms);
+    now += ms;
+    if (stop && now >= stopAtMs)
+      *stop = true;
+  }
+};
+
+// The game's image and globals as functions of time since injection: the
+// code can still be unpacking, and the singletons are constructed later
+struct FakeGame {
+  uint64_t applicationCodeMs = 0;
+  uint64_t contentMgrCodeMs = 0;
+  uint64_t applicationReadyMs = 0;
+  uint64_t contentMgrReadyMs = 0;
+  const SimClock &clock;
+
+  std::vector<uint8_t> image = std::vector<uint8_t>(0x8000, 0xCC);
+
+  explicit FakeGame(const SimClock &clock) : clock(clock) {}
+
+  // The image at the current time. Both instructions sit at fixed offsets
+  // once written; before that it's padding.
+  const std::vector<uint8_t> &mapped() {
+    if (clock.now >= applicationCodeMs)
+      write(0x1230, {0xA1, 0, 0, 0, 0, 0x85, 0xC0, 0x74, 0x05, 0x8B, 0x40},
+            APPLICATION_GLOBAL);
+    if (clock.now >= contentMgrCodeMs)
+      write(0x5670, {0xA1, 0, 0, 0, 0, 0x8B, 0x4D, 0x08, 0x85, 0xC0},
+            CONTENTMGR_GLOBAL);
+    return image;
+  }
+
+  // The value of the global at `address` now: null until constructed
+  uint32_t global(uint32_t address) const {
+    if (address == APPLICATION_GLOBAL)
+      return clock.now >= applicationReadyMs ? 0x02000000 : 0;
+    if (address == CONTENTMGR_GLOBAL)
+      return clock.now >= contentMgrReadyMs ? 0x03000000 : 0;
+    return 0;
+  }
+
+  void write(size_t offset, std::vector<uint8_t> code, uint32_t operand) {
+    memcpy(&code[1], &operand, sizeof(operand));
+    memcpy(&image[offset], code.data(), code.size());
+  }
+};
+
+// GameBridge's side of stage 3, over the fake game
+struct Bridge {
+  FakeGame &game;
+  GlobalSignature applicationSig{PATTERN_APPLICATION};
+  GlobalSignature contentMgrSig{PATTERN_CONTENTMGR};
+  int readyChecks = 0;
+  uint64_t readyAtMs = NEVER; // When singletonsReady first passed
+
+  bool resolveSignatures() {
+    const std::vector<uint8_t> &image = game.mapped();
+    bool application = applicationSig.resolve(image.data(), image.size());
+    bool contentMgr = contentMgrSig.resolve(image.data(), image.size());
+    return application && contentMgr;
+  }
+
+  bool singletonsReady() {
+    readyChecks++;
+    bool ready = game.global(applicationSig.address) != 0 &&
+                 game.global(contentMgrSig.address) != 0;
+    if (ready && readyAtMs == NEVER)
+      readyAtMs = game.clock.now;
+    return ready;
+  }
+};
+
+// Tracker::initialize stage 3: signatures, then the singletons
+struct Startup {
+  SimClock clock;
+  FakeGame game{clock};
+  Bridge bridge{game};
+  std::atomic<bool> stop{false};
+  bool found = false;
+  bool ready = false;
+
+  void run() {
+    clock.stop = &stop;
+    uint64_t deadline = TIMEOUT_MS;
+    found = PollWithBackoff(
+        clock, [&] { return bridge.resolveSignatures(); }, deadline, stop);
+    ready = found && PollWithBackoff(
+                         clock, [&] { return bridge.singletonsReady(); },
+                         deadline, stop);
+  }
+};
+
+// Everything already there: no waiting, one scan each
+void TestReadyAtInjection() {
+  Startup s;
+  s.run();
+  CHECK(s.found && s.ready);
+  CHECK(s.clock.waits.empty());
+  CHECK_EQ(s.bridge.applicationSig.scans, 1u);
+  CHECK_EQ(s.bridge.contentMgrSig.scans, 1u);
+  CHECK_EQ(s.bridge.applicationSig.address, APPLICATION_GLOBAL);
+  CHECK_EQ(s.bridge.contentMgrSig.address, CONTENTMGR_GLOBAL);
+}
+
+// Code mapped from the start, singletons constructed seconds later: found
+// with no rescans, ready within one backoff step of the second one
+void TestLateSingletons() {
+  Startup s;
+  s.game.applicationReadyMs = 1200;
+  s.game.contentMgrReadyMs = 3700;
+  s.run();
+  CHECK(s.found && s.ready);
+  CHECK_EQ(s.bridge.applicationSig.scans, 1u);
+  CHECK_EQ(s.bridge.contentMgrSig.scans, 1u);
+  CHECK(s.bridge.readyAtMs >= 3700);
+  CHECK(s.bridge.readyAtMs <= 3700 + POLL_MAX_WAIT_MS);
+
+  // 5, 10, 20 ... doubling up to the 250 ms cap, then steady
+  const uint32_t expected[] = {5, 10, 20, 40, 80, 160, 250, 250};
+  bool backoff = s.clock.waits.size() > 8;
+  for (size_t i = 0; backoff && i < s.clock.waits.size(); i++)
+    backoff = s.clock.waits[i] == (i < 8 ? expected[i] : POLL_MAX_WAIT_MS);
+  CHECK(backoff);
+  // About 4 s at 250 ms a check, not thousands of spins
+  CHECK(s.bridge.readyChecks < 30);
+}
+
+// ContentMgr's code is still unpacking: only its pattern is rescanned each
+// poll; the application pattern matched once and is kept
+void TestLatePattern() {
+  Startup s;
+  s.game.contentMgrCodeMs = 2000;
+  s.game.applicationReadyMs = 2500;
+  s.game.contentMgrReadyMs = 2600;
+  s.run();
+  CHECK(s.found && s.ready);
+  CHECK_EQ(s.bridge.applicationSig.scans, 1u);
+  uint32_t polls = (uint32_t)s.clock.waits.size();
+  CHECK(s.bridge.contentMgrSig.scans > 5);
+  CHECK(s.bridge.contentMgrSig.scans <= polls + 1);
+
+  // Once both have matched, further calls don't scan at all
+  uint32_t scans = s.bridge.contentMgrSig.scans;
+  CHECK(s.bridge.resolveSignatures());
+  CHECK_EQ(s.bridge.contentMgrSig.scans, scans);
+  CHECK_EQ(s.bridge.applicationSig.scans, 1u);
+}
+
+// ContentMgr is never constructed: give up at the deadline, not long past
+// it, having checked only a few dozen times
+void TestTimeout() {
+  Startup s;
+  s.game.contentMgrReadyMs = NEVER;
+  s.run();
+  CHECK(s.found);
+  CHECK(!s.ready);
+  CHECK(s.clock.now >= TIMEOUT_MS);
+  CHECK(s.clock.now < TIMEOUT_MS + POLL_MAX_WAIT_MS);
+  CHECK(s.bridge.readyChecks <= (int)(TIMEOUT_MS / POLL_MAX_WAIT_MS) + 8);
+}
+
+// A pattern that never appears times out in the signature stage, which
+// skips the singleton stage
+void TestPatternNeverFound() {
+  Startup s;
+  s.game.applicationCodeMs = NEVER;
+  s.run();
+  CHECK(!s.found && !s.ready);
+  CHECK_EQ(s.bridge.readyChecks, 0);
+  CHECK_EQ(s.bridge.contentMgrSig.scans, 1u);
+  CHECK(s.bridge.applicationSig.scans > 10);
+  CHECK(s.clock.now < TIMEOUT_MS + POLL_MAX_WAIT_MS);
+}
+
+// An unload mid-startup: the poll notices at its next check
+void TestStop() {
+  Startup s;
+  s.game.applicationReadyMs = 5000;
+  s.clock.stopAtMs = 900;
+  s.run();
+  CHECK(s.found && !s.ready);
+  CHECK(s.stop);
+  CHECK(s.clock.now >= 900);
+  CHECK(s.clock.now < 900 + POLL_MAX_WAIT_MS);
+}
+
+} // namespace
+
+int main() {
+  TestReadyAtInjection();
+  TestLateSingletons();
+  TestLatePattern();
+  TestTimeout();
+  TestPatternNeverFound();
+  TestStop();
+  return TestResult("StartupPollTest");
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+
+// Minimal checks for the portable-header tests: each test is one executable
+// that prints its failures and exits non-zero if there were any.
+
+static int g_testFailures = 0;
+
+#define CHECK(cond)                                                            \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+      g_testFailures++;                                                        \
+    }                                                                          \
+  } while (0)
+
+#define CHECK_EQ(a, b)                                                         \
+  do {                                                                         \
+    auto checkA_ = (a);                                                        \
+    auto checkB_ = (b);                                                        \
+    if (!(checkA_ == checkB_)) {                                               \
+      fprintf(stderr, "%s:%d: CHECK_EQ failed: %s == %s (%lld vs %lld)\n",     \
+              __FILE__, __LINE__, #a, #b, (long long)checkA_,                  \
+              (long long)checkB_);                                             \
+      g_testFailures++;                                                        \
+    }                                                                          \
+  } while (0)
+
+// Call at the end of main
+static int TestResult(const char *name) {
+  if (g_testFailures)
+    fprintf(stderr, "%s: %d check(s) failed\n", name, g_testFailures);
+  else
+    printf("%s: ok\n", name);
+  return g_testFailures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
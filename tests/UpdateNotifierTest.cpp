@@ -0,0 +1,150 @@
+// UpdateNotifier's futex path: coalescing, timeouts, a waiter in another
+// process, and the publish-to-wakeup latency across processes that the
+// GUI's 100 ms poll used to cost.
+//
+//   g++ -std=c++17 -O2 -Iinclude tests/UpdateNotifierTest.cpp
+
+#include "SharedTrackerData.h"
+#include "TestCheck.h"
+#include "UpdateNotifier.h"
+
+#include <new>
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+namespace {
+
+uint64_t NowNs() {
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + (uint64_t)ts.tv_nsec;
+}
+
+// Memory a forked child shares with us, as the DLL and GUI share the mapping
+template <typename T> T *MapShared() {
+  void *p = mmap(nullptr, sizeof(T), PROT_READ | PROT_WRITE,
+                 MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  return p == MAP_FAILED ? nullptr : new (p) T();
+}
+template <typename T> void Unmap(T *p) { munmap((void *)p, sizeof(T)); }
+
+// Several publishes before the reader looks give it one wakeup
+void TestCoalesce() {
+  std::atomic<uint32_t> word{0};
+  UpdateNotifier dll, gui;
+  CHECK(dll.attach(&word) && gui.attach(&word));
+  CHECK_EQ(gui.wait(0), NOTIFY_TIMEOUT);
+  dll.signal();
+  dll.signal();
+  dll.signal();
+  CHECK_EQ(gui.wait(0), NOTIFY_SIGNALED);
+  CHECK_EQ(gui.wait(0), NOTIFY_TIMEOUT);
+
+  // A reader that attaches later doesn't see publishes it missed
+  UpdateNotifier late;
+  late.attach(&word);
+  CHECK_EQ(late.wait(0), NOTIFY_TIMEOUT);
+  dll.signal();
+  CHECK_EQ(late.wait(0), NOTIFY_SIGNALED);
+  CHECK_EQ(gui.wait(0), NOTIFY_SIGNALED);
+}
+
+void TestTimeoutAndFailure() {
+  std::atomic<uint32_t> word{0};
+  UpdateNotifier gui;
+  gui.attach(&word);
+  uint64_t start = NowNs();
+  CHECK_EQ(gui.wait(30), NOTIFY_TIMEOUT);
+  CHECK(NowNs() - start >= 30000000);
+
+  UpdateNotifier closed;
+  CHECK(!closed.valid());
+  CHECK_EQ(closed.wait(30), NOTIFY_FAILED); // At once, the caller handles it
+  closed.signal();                          // Harmless
+  gui.close();
+  CHECK_EQ(gui.wait(0), NOTIFY_FAILED);
+}
+
+// A waiter in a child process, asleep before the signal arrives
+void TestCrossProcess() {
+  auto *word = MapShared<std::atomic<uint32_t>>();
+  CHECK(word != nullptr);
+  UpdateNotifier gui;
+  gui.attach(word);
+  pid_t child = fork();
+  if (child == 0)
+    _exit(gui.wait(5000) == NOTIFY_SIGNALED ? 0 : 1);
+
+  timespec pause = {0, 20000000};
+  nanosleep(&pause, nullptr);
+  UpdateNotifier dll;
+  dll.attach(word);
+  dll.signal();
+  int status = 0;
+  CHECK(waitpid(child, &status, 0) == child);
+  CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+  Unmap(word);
+}
+
+// Publish-to-wakeup latency with the reader in another process: the
+// publisher stamps the time and signals; the reader records how long ago
+// that was when it wakes, then acks before the next publish
+struct LatencyShared {
+  std::atomic<uint32_t> update{0};
+  std::atomic<uint32_t> ack{0};
+  std::atomic<uint64_t> stampNs{0};
+  LogHistogram wakeUs;
+};
+
+void BenchmarkWakeLatency() {
+  constexpr int ROUNDS = 2000;
+  auto *shared = MapShared<LatencyShared>();
+  CHECK(shared != nullptr);
+  shared->wakeUs.clear();
+
+  UpdateNotifier update, ack;
+  update.attach(&shared->update);
+  ack.attach(&shared->ack);
+  pid_t child = fork();
+  if (child == 0) {
+    int woken = 0;
+    for (int i = 0; i < ROUNDS; i++) {
+      if (update.wait(5000) != NOTIFY_SIGNALED)
+        break;
+      uint64_t ns = NowNs() - shared->stampNs.load();
+      shared->wakeUs.record((uint32_t)(ns / 1000));
+      woken++;
+      ack.signal();
+    }
+    _exit(woken == ROUNDS ? 0 : 1);
+  }
+
+  bool acked = true;
+  for (int i = 0; i < ROUNDS && acked; i++) {
+    shared->stampNs.store(NowNs());
+    update.signal();
+    acked = ack.wait(5000) == NOTIFY_SIGNALED;
+  }
+  int status = 0;
+  CHECK(waitpid(child, &status, 0) == child);
+  CHECK(acked && WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+  const LogHistogram &h = shared->wakeUs;
+  printf("UpdateNotifier: wake p50 %u us, p99 %u us, max %u us "
+         "(100 ms poll: 50000 us mean)\n",
+         h.percentile(0.50), h.percentile(0.99), h.max);
+  CHECK_EQ(h.total, (uint64_t)ROUNDS);
+  // Generous for a loaded machine; a wakeup is microseconds when idle
+  CHECK(h.percentile(0.50) < 5000);
+  Unmap(shared);
+}
+
+} // namespace
+
+int main() {
+  TestCoalesce();
+  TestTimeoutAndFailure();
+  TestCrossProcess();
+  BenchmarkWakeLatency();
+  return TestResult("UpdateNotifierTest");
+}
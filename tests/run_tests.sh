@@ -0,0 +1,19 @@
+#!/bin/sh
+# Builds and runs every tests/*Test.cpp against the portable headers.
+# Usage: tests/run_tests.sh [extra g++ flags], from the repository root.
+set -u
+CXX=${CXX:-g++}
+OUT=${TMPDIR:-/tmp}/dreadmyst-tests
+mkdir -p "$OUT"
+failed=0
+for src in tests/*Test.cpp; do
+  name=$(basename "$src" .cpp)
+  if ! "$CXX" -std=c++17 -O2 -Wall -pthread -Iinclude "$@" "$src" \
+      -o "$OUT/$name"; then
+    echo "$name: build failed"
+    failed=1
+    continue
+  fi
+  "$OUT/$name" || failed=1
+done
+exit $failed